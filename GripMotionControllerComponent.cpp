@@ -3,18 +3,20 @@
 #include "GripMotionControllerComponent.h"
 #include "IHeadMountedDisplay.h"
 #include "Components/DestructibleComponent.h"
-#include "Misc/ScopeLock.h"
 #include "Net/UnrealNetwork.h"
 #include "KismetMathLibrary.h"
 #include "PrimitiveSceneInfo.h"
 #include "Engine/World.h"
 #include "GameFramework/WorldSettings.h"
 #include "DrawDebugHelpers.h"
+#include "Async/ParallelFor.h"
 
 #include "PhysicsPublic.h"
 
 #if WITH_PHYSX
 #include "PhysXSupport.h"
+#include "GripPhysicsBatch.h"
+#include "GripPhysicsHandlePool.h"
 #endif // WITH_PHYSX
 
 //#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 11
@@ -25,6 +27,29 @@
 DEFINE_LOG_CATEGORY(LogVRMotionController);
 //For UE4 Profiler ~ Stat
 DECLARE_CYCLE_STAT(TEXT("TickGrip ~ TickingGrip"), STAT_TickGrip, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGrip ~ PhysicsGripLookupFallbacks"), STAT_PhysicsGripLookupFallbacks, STATGROUP_TickGrip);
+DECLARE_CYCLE_STAT(TEXT("TickGrip ~ GatherLateUpdatePrimitives"), STAT_GatherLateUpdatePrimitives, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGrip ~ LateUpdatePrimitiveRebuilds"), STAT_LateUpdatePrimitiveRebuilds, STATGROUP_TickGrip);
+DECLARE_CYCLE_STAT(TEXT("TickGrip ~ LateUpdateRenderThread"), STAT_LateUpdateRenderThread, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGrip ~ LateUpdateNoNewSnapshot"), STAT_LateUpdateNoNewSnapshot, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGrip ~ SyncGripSweeps"), STAT_SyncGripSweeps, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGrip ~ AsyncGripSweepsQueued"), STAT_AsyncGripSweepsQueued, STATGROUP_TickGrip);
+DECLARE_CYCLE_STAT(TEXT("TickGrip ~ ComputeGripTransforms"), STAT_ComputeGripTransforms, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGrip ~ ParallelGripTransforms"), STAT_ParallelGripTransforms, STATGROUP_TickGrip);
+
+static TAutoConsoleVariable<int32> CVarGripAsyncSweeps(
+	TEXT("vr.GripAsyncSweeps"),
+	0,
+	TEXT("0: SweepWithPhysics grips sweep synchronously every frame.\n")
+	TEXT("1: SweepWithPhysics grips queue an async sweep and use its result the next frame, unless flagged precision critical.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarGripParallelComputeMinGrips(
+	TEXT("vr.GripParallelComputeMinGrips"),
+	0,
+	TEXT("Minimum number of grips in a controllers grip array before their world transforms are computed in parallel ahead of being applied.\n")
+	TEXT("0 disables the parallel compute and every grip is computed inline.\n"),
+	ECVF_Default);
 
 // MAGIC NUMBERS
 // Constraint multipliers for angular, to avoid having to have two sets of stiffness/damping variables
@@ -35,9 +60,78 @@ const float ANGULAR_DAMPING_MULTIPLIER = 1.4f;
 const float HYBRID_PHYSICS_GRIP_MULTIPLIER = 10.0f;
 
 namespace {
-	/** This is to prevent destruction of motion controller components while they are
-	in the middle of being accessed by the render thread */
-	FCriticalSection CritSect;
+	/** Late update snapshot handoff, the ready index carries this flag while it holds a snapshot the render thread hasn't taken */
+	const int32 LATE_UPDATE_SNAPSHOT_FRESH = 4;
+	const int32 LATE_UPDATE_SNAPSHOT_INDEX_MASK = 3;
+
+	/** Gets the root component and owning actor a grip is moving, returns false if either is missing */
+	bool GetGripTargets(const FBPActorGripInformation & Grip, UPrimitiveComponent *& root, AActor *& actor)
+	{
+		root = NULL;
+		actor = NULL;
+
+		switch (Grip.GripTargetType)
+		{
+		case EGripTargetType::ActorGrip:
+		{
+			actor = Grip.GetGrippedActor();
+			if (actor)
+				root = Cast<UPrimitiveComponent>(actor->GetRootComponent());
+		}break;
+
+		case EGripTargetType::ComponentGrip:
+		{
+			root = Grip.GetGrippedComponent();
+			if (root)
+				actor = root->GetOwner();
+		}break;
+
+		default:break;
+		}
+
+		return root && actor;
+	}
+
+	/** Polls the motion controller devices, doesn't touch the component so it is safe on the render thread */
+	bool PollMotionControllers(int32 PlayerIndex, EControllerHand Hand, FVector& Position, FRotator& Orientation, float WorldToMetersScale, ETrackingStatus & OutTrackingStatus)
+	{
+		// New iteration and retrieval for 4.12
+		TArray<IMotionController*> MotionControllers = IModularFeatures::Get().GetModularFeatureImplementations<IMotionController>(IMotionController::GetModularFeatureName());
+		for (auto MotionController : MotionControllers)
+		{
+			if ((MotionController != nullptr) && MotionController->GetControllerOrientationAndPosition(PlayerIndex, Hand, Orientation, Position, WorldToMetersScale))
+			{
+				OutTrackingStatus = (ETrackingStatus)MotionController->GetControllerTrackingStatus(PlayerIndex, Hand);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Interface events that the grip tick can call natively when not overridden in blueprint
+	static const FName NAME_TickGrip(TEXT("TickGrip"));
+	static const FName NAME_IsInteractible(TEXT("IsInteractible"));
+	static const FName NAME_GetInteractionSettings(TEXT("GetInteractionSettings"));
+	static const FName NAME_GripBreakDistance(TEXT("GripBreakDistance"));
+	static const FName NAME_SecondaryGripType(TEXT("SecondaryGripType"));
+
+	/** Returns the native grip interface of an object if it has one and the given event isn't overridden in blueprint */
+	IVRGripInterfaceNative * GetNativeGripInterfaceForEvent(UObject * Object, FName EventName)
+	{
+		IVRGripInterface * GripInterface = Cast<IVRGripInterface>(Object);
+		IVRGripInterfaceNative * NativeInterface = GripInterface ? GripInterface->GetNativeGripInterface() : nullptr;
+
+		if (!NativeInterface)
+			return nullptr;
+
+		// Blueprint overrides of a native event replace the function on the generated class with a non native one
+		UFunction * EventFunction = Object->FindFunction(EventName);
+		return (EventFunction && EventFunction->HasAnyFunctionFlags(FUNC_Native)) ? NativeInterface : nullptr;
+	}
+
+	/** Held object to the controllers holding it, kept up to date by RebuildGripIndex. Game thread only. */
+	TMap<const UObject *, TArray<TWeakObjectPtr<UGripMotionControllerComponent>, TInlineAllocator<2>>> GripHolders;
 
 } // anonymous namespace
 
@@ -65,10 +159,14 @@ UGripMotionControllerComponent::UGripMotionControllerComponent(const FObjectInit
 	//bReplicateControllerTransform = true;
 	ControllerNetUpdateRate = 100.0f; // 100 htz is default
 	ControllerNetUpdateCount = 0.0f;
+	bTransformSentByOwner = false;
 	bReplicateWithoutTracking = false;
 	bLerpingPosition = false;
 	bSmoothReplicatedMotion = false;
 	bOffsetByHMD = false;
+	PhysicsGripGeneration = 0;
+	GripIndexNumReplicated = 0;
+	GripIndexNumLocal = 0;
 }
 
 //=============================================================================
@@ -76,12 +174,8 @@ UGripMotionControllerComponent::~UGripMotionControllerComponent()
 {
 	if (ViewExtension.IsValid())
 	{
-		{
-			// This component could be getting accessed from the render thread so it needs to wait
-			// before clearing MotionControllerComponent and allowing the destructor to continue
-			FScopeLock ScopeLock(&CritSect);
-			ViewExtension->MotionControllerComponent = NULL;
-		}
+		// The render thread only ever reads the snapshots, so this can go without waiting on it
+		ViewExtension->MotionControllerComponent = NULL;
 
 		if (GEngine)
 		{
@@ -91,6 +185,14 @@ UGripMotionControllerComponent::~UGripMotionControllerComponent()
 	ViewExtension.Reset();
 }
 
+void UGripMotionControllerComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// After property init, otherwise the archetypes pointer gets copied over it
+	GrippedActors.OwningController = this;
+}
+
 void UGripMotionControllerComponent::OnUnregister()
 {
 	for (int i = 0; i < GrippedActors.Num(); i++)
@@ -110,15 +212,177 @@ void UGripMotionControllerComponent::OnUnregister()
 	}
 	LocallyGrippedActors.Empty();
 
-	for (int i = 0; i < PhysicsGrips.Num(); i++)
+	for (FBPActorPhysicsHandleInformation & PhysicsGrip : PhysicsGrips)
 	{
-		DestroyPhysicsHandle(PhysicsGrips[i].SceneIndex, &PhysicsGrips[i].HandleData, &PhysicsGrips[i].KinActorData);
+		DestroyPhysicsHandle(PhysicsGrip.SceneIndex, &PhysicsGrip.HandleData, &PhysicsGrip.KinActorData);
 	}
 	PhysicsGrips.Empty();
+	PhysicsGripSlots.Empty();
+	GripValueCaches.Empty();
+	CachedInteractionSettings.Empty();
+	PendingGripSweeps.Empty();
+	PendingRepGrips.Empty();
+	PendingRepDrops.Empty();
+	ReplicatedPoseBuffer.Reset();
+	RebuildGripIndex();
 
 	Super::OnUnregister();
 }
 
+void UGripMotionControllerComponent::PruneGripValueCaches()
+{
+	for (auto It = GripValueCaches.CreateIterator(); It; ++It)
+	{
+		if (!GrippedActors.Contains(It.Key()) && !LocallyGrippedActors.Contains(It.Key()))
+			It.RemoveCurrent();
+	}
+}
+
+void FBPActorGripInformation::PreReplicatedRemove(const FBPGripList & InArraySerializer)
+{
+	if (InArraySerializer.OwningController && GrippedObject)
+		InArraySerializer.OwningController->PendingRepDrops.Add(*this);
+}
+
+void FBPActorGripInformation::PostReplicatedAdd(const FBPGripList & InArraySerializer)
+{
+	if (InArraySerializer.OwningController && GrippedObject)
+		InArraySerializer.OwningController->PendingRepGrips.AddUnique(GrippedObject);
+}
+
+void FBPActorGripInformation::PostReplicatedChange(const FBPGripList & InArraySerializer)
+{
+	if (InArraySerializer.OwningController && GrippedObject)
+		InArraySerializer.OwningController->PendingRepGrips.AddUnique(GrippedObject);
+}
+
+void UGripMotionControllerComponent::HandlePendingGripReplication()
+{
+	// Drops first so that a slot that was dropped and re-gripped in the same update ends up gripped
+	for (const FBPActorGripInformation & RemovedGrip : PendingRepDrops)
+	{
+		// Normally the NotifyDrop multicast got here first and there is nothing left to do
+		if (!RemovedGrip.GrippedObject || FindGripByObject(RemovedGrip.GrippedObject) || !GripValueCaches.Contains(RemovedGrip.GrippedObject))
+			continue;
+
+		// Don't know the servers simulate setting yet, keep what it has until the NotifyDrop applies it
+		UPrimitiveComponent * root = RemovedGrip.GetGrippedComponent();
+		if (!root && RemovedGrip.GetGrippedActor())
+			root = Cast<UPrimitiveComponent>(RemovedGrip.GetGrippedActor()->GetRootComponent());
+
+		Drop_Implementation(RemovedGrip, root && root->IsSimulatingPhysics());
+	}
+
+	PendingRepDrops.Reset();
+
+	// Copied off, the grip callbacks can end up back in here through a drop
+	TArray<UObject *> GripsToHandle = MoveTemp(PendingRepGrips);
+	PendingRepGrips.Reset();
+
+	for (UObject * GrippedObject : GripsToHandle)
+	{
+		int32 FoundIndex = 0;
+		bool bIsLocalGrip = false;
+
+		// Looked up each time, handling a grip can drop others and shift the array
+		FBPActorGripInformation * Grip = FindGripByObject(GrippedObject, &FoundIndex, &bIsLocalGrip);
+		if (Grip && !bIsLocalGrip)
+			HandleGripReplication(*Grip);
+	}
+}
+
+void UGripMotionControllerComponent::RebuildGripIndex()
+{
+	check(IsInGameThread());
+
+	for (const TPair<const UObject *, FGripIndexEntry> & IndexPair : GripIndex)
+	{
+		if (auto * Holders = GripHolders.Find(IndexPair.Key))
+		{
+			Holders->Remove(this);
+			if (!Holders->Num())
+				GripHolders.Remove(IndexPair.Key);
+		}
+	}
+
+	GripIndex.Reset();
+
+	// Replicated grips take priority, same as the order the arrays were searched in before
+	for (int i = 0; i < GrippedActors.Num(); ++i)
+	{
+		if (GrippedActors[i].GrippedObject && !GripIndex.Contains(GrippedActors[i].GrippedObject))
+			GripIndex.Add(GrippedActors[i].GrippedObject, FGripIndexEntry(i, false));
+	}
+
+	for (int i = 0; i < LocallyGrippedActors.Num(); ++i)
+	{
+		if (LocallyGrippedActors[i].GrippedObject && !GripIndex.Contains(LocallyGrippedActors[i].GrippedObject))
+			GripIndex.Add(LocallyGrippedActors[i].GrippedObject, FGripIndexEntry(i, true));
+	}
+
+	GripIndexNumReplicated = GrippedActors.Num();
+	GripIndexNumLocal = LocallyGrippedActors.Num();
+
+	for (const TPair<const UObject *, FGripIndexEntry> & IndexPair : GripIndex)
+	{
+		GripHolders.FindOrAdd(IndexPair.Key).AddUnique(this);
+	}
+}
+
+FBPActorGripInformation * UGripMotionControllerComponent::FindGripByObject(const UObject * ObjectToLookForGrip, int32 * OutIndex, bool * bOutIsLocalGrip)
+{
+	if (!ObjectToLookForGrip)
+		return nullptr;
+
+	// Catches any add or remove that didn't go through RebuildGripIndex
+	if (GripIndexNumReplicated != GrippedActors.Num() || GripIndexNumLocal != LocallyGrippedActors.Num())
+		RebuildGripIndex();
+
+	const FGripIndexEntry * Entry = GripIndex.Find(ObjectToLookForGrip);
+
+	if (!Entry)
+		return nullptr;
+
+	TArray<FBPActorGripInformation> * GripArray = Entry->bIsLocalGrip ? &LocallyGrippedActors : &GrippedActors.Items;
+
+	if (!GripArray->IsValidIndex(Entry->Index) || (*GripArray)[Entry->Index].GrippedObject != ObjectToLookForGrip)
+	{
+		// The arrays were re-ordered under us
+		RebuildGripIndex();
+		Entry = GripIndex.Find(ObjectToLookForGrip);
+
+		if (!Entry)
+			return nullptr;
+
+		GripArray = Entry->bIsLocalGrip ? &LocallyGrippedActors : &GrippedActors.Items;
+	}
+
+	if (OutIndex)
+		*OutIndex = Entry->Index;
+
+	if (bOutIsLocalGrip)
+		*bOutIsLocalGrip = Entry->bIsLocalGrip;
+
+	return &(*GripArray)[Entry->Index];
+}
+
+void UGripMotionControllerComponent::GetControllersHoldingObject(UObject * HeldObject, TArray<UGripMotionControllerComponent *> &HoldingControllers)
+{
+	HoldingControllers.Reset();
+
+	if (!HeldObject)
+		return;
+
+	if (const auto * Holders = GripHolders.Find(HeldObject))
+	{
+		for (const TWeakObjectPtr<UGripMotionControllerComponent> & Holder : *Holders)
+		{
+			if (Holder.IsValid())
+				HoldingControllers.Add(Holder.Get());
+		}
+	}
+}
+
 void UGripMotionControllerComponent::SendRenderTransform_Concurrent()
 {
 	RenderThreadRelativeTransform = GetRelativeTransform();
@@ -129,44 +393,69 @@ void UGripMotionControllerComponent::SendRenderTransform_Concurrent()
 
 FBPActorPhysicsHandleInformation * UGripMotionControllerComponent::GetPhysicsGrip(const FBPActorGripInformation & GripInfo)
 {
-	for (int i = 0; i < PhysicsGrips.Num(); i++)
-	{
-		if (PhysicsGrips[i] == GripInfo)
-			return &PhysicsGrips[i];
-	}
+	int index;
+	if (GetPhysicsGripIndex(GripInfo, index))
+		return &PhysicsGrips[index];
+
 	return nullptr;
 }
 
 
 bool UGripMotionControllerComponent::GetPhysicsGripIndex(const FBPActorGripInformation & GripInfo, int & index)
 {
-	for (int i = 0; i < PhysicsGrips.Num(); i++)
+	// Fast path, the grip still points at a live slot for its own object
+	const FGripPhysicsHandleRef & HandleRef = GripInfo.PhysicsHandle;
+	if (PhysicsGrips.IsValidIndex(HandleRef.Slot))
 	{
-		if (PhysicsGrips[i] == GripInfo)
+		const FBPActorPhysicsHandleInformation & HandleInfo = PhysicsGrips[HandleRef.Slot];
+		if (HandleInfo.Generation == HandleRef.Generation && HandleInfo == GripInfo)
 		{
-			index = i;
+			index = HandleRef.Slot;
 			return true;
 		}
 	}
 
-	return false;
+	// Replication and array removals move grips around without their handle, find it by object and repair it.
+	// Grips without a physics handle (most grip types) end up here as well and just miss.
+	const int32 * Slot = GripInfo.GrippedObject ? PhysicsGripSlots.Find(GripInfo.GrippedObject) : nullptr;
+	if (!Slot)
+	{
+		GripInfo.PhysicsHandle.Reset();
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_PhysicsGripLookupFallbacks);
+
+	index = *Slot;
+	GripInfo.PhysicsHandle.Slot = index;
+	GripInfo.PhysicsHandle.Generation = PhysicsGrips[index].Generation;
+	return true;
+}
+
+void UGripMotionControllerComponent::RemovePhysicsGrip(int32 Index)
+{
+	PhysicsGripSlots.Remove(PhysicsGrips[Index].HandledObject);
+	PhysicsGrips.RemoveAt(Index);
 }
 
 FBPActorPhysicsHandleInformation * UGripMotionControllerComponent::CreatePhysicsGrip(const FBPActorGripInformation & GripInfo)
 {
-	for (int i = 0; i < PhysicsGrips.Num(); i++)
+	int index;
+	if (GetPhysicsGripIndex(GripInfo, index))
 	{
-		if (PhysicsGrips[i] == GripInfo)
-		{
-			DestroyPhysicsHandle(PhysicsGrips[i].SceneIndex, &PhysicsGrips[i].HandleData, &PhysicsGrips[i].KinActorData);
-			return &PhysicsGrips[i];
-		}
+		DestroyPhysicsHandle(PhysicsGrips[index].SceneIndex, &PhysicsGrips[index].HandleData, &PhysicsGrips[index].KinActorData);
+		return &PhysicsGrips[index];
 	}
 
 	FBPActorPhysicsHandleInformation NewInfo;
 	NewInfo.HandledObject = GripInfo.GrippedObject;
+	NewInfo.Generation = ++PhysicsGripGeneration;
+
+	index = PhysicsGrips.Add(NewInfo);
+	PhysicsGripSlots.Add(NewInfo.HandledObject, index);
 
-	int index = PhysicsGrips.Add(NewInfo);
+	GripInfo.PhysicsHandle.Slot = index;
+	GripInfo.PhysicsHandle.Generation = NewInfo.Generation;
 
 	return &PhysicsGrips[index];
 }
@@ -192,23 +481,43 @@ void UGripMotionControllerComponent::GetLifetimeReplicatedProps(TArray< class FL
 
 void UGripMotionControllerComponent::Server_SendControllerTransform_Implementation(FBPVRComponentPosRep NewTransform)
 {
+	ReceiveControllerTransform(NewTransform);
+}
+
+void UGripMotionControllerComponent::ReceiveControllerTransform(const FBPVRComponentPosRep & NewTransform)
+{
+	FBPVRComponentPosRep ResolvedTransform = NewTransform;
+	int32 AckIndex = INDEX_NONE;
+
+	// Relative to a keyframe that never arrived, nothing to do with it
+	if (!PoseBaselineReceiver.Resolve(ResolvedTransform, AckIndex))
+		return;
+
+	if (AckIndex != INDEX_NONE)
+		Client_AckPoseBaseline((uint8)AckIndex);
+
 	// Store new transform and trigger OnRep_Function
-	ReplicatedControllerTransform = NewTransform;
+	ReplicatedControllerTransform = ResolvedTransform;
 
 	// Server should no longer call this RPC itself, but if is using non tracked then it will so keeping auth check
 	if(!bHasAuthority)
 		OnRep_ReplicatedControllerTransform();
 }
 
+void UGripMotionControllerComponent::Client_AckPoseBaseline_Implementation(uint8 BaselineIndex)
+{
+	PoseBaselineSender.OnBaselineAcked(BaselineIndex);
+}
+
 bool UGripMotionControllerComponent::Server_SendControllerTransform_Validate(FBPVRComponentPosRep NewTransform)
 {
 	return true;
 	// Optionally check to make sure that player is inside of their bounds and deny it if they aren't?
 }
 
-void UGripMotionControllerComponent::FViewExtension::ProcessGripArrayLateUpdatePrimitives(TArray<FBPActorGripInformation> & GripArray)
+void UGripMotionControllerComponent::FViewExtension::ProcessGripArrayLateUpdatePrimitives(const TArray<FBPActorGripInformation> & GripArray)
 {
-	for (FBPActorGripInformation actor : GripArray)
+	for (const FBPActorGripInformation & actor : GripArray)
 	{
 		// Skip actors that are colliding if turning off late updates during collision.
 		// Also skip turning off late updates for SweepWithPhysics, as it should always be locked to the hand
@@ -259,7 +568,7 @@ void UGripMotionControllerComponent::FViewExtension::ProcessGripArrayLateUpdateP
 			{
 				if (USceneComponent * rootComponent = pActor->GetRootComponent())
 				{
-					GatherLateUpdatePrimitives(rootComponent, LateUpdatePrimitives);
+					LateUpdateRoots.Add(rootComponent);
 				}
 			}
 
@@ -271,20 +580,36 @@ void UGripMotionControllerComponent::FViewExtension::ProcessGripArrayLateUpdateP
 			UPrimitiveComponent * cPrimComp = actor.GetGrippedComponent();
 			if (cPrimComp)
 			{
-				GatherLateUpdatePrimitives(cPrimComp, LateUpdatePrimitives);
+				LateUpdateRoots.Add(cPrimComp);
 			}
 		}break;
 		}
 	}
 }
 
+bool UGripMotionControllerComponent::FViewExtension::IsLateUpdateCacheValid() const
+{
+	// The roots come from the grips, which also covers the late update settings and colliding or double grip state
+	if (bLateUpdatePrimitivesDirty || bFoundStaleLateUpdatePrimitive || LateUpdateRoots != CachedLateUpdateRoots ||
+		CachedLateUpdateHierarchySerial != UGripMotionControllerComponent::LateUpdateHierarchySerial.GetValue())
+		return false;
+
+	for (const TWeakObjectPtr<UPrimitiveComponent> & Primitive : CachedProxylessPrimitives)
+	{
+		const UPrimitiveComponent * PrimitiveComponent = Primitive.Get();
+		if (PrimitiveComponent && PrimitiveComponent->SceneProxy)
+			return false;
+	}
+
+	return true;
+}
+
 void UGripMotionControllerComponent::FViewExtension::BeginRenderViewFamily(FSceneViewFamily& InViewFamily)
 {
 	if (!MotionControllerComponent)
 	{
 		return;
 	}
-	FScopeLock ScopeLock(&CritSect);
 
 	static const auto CVarEnableMotionControllerLateUpdate = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("vr.EnableMotionControllerLateUpdate"));
 	if (MotionControllerComponent->bDisableLowLatencyUpdate || !CVarEnableMotionControllerLateUpdate->GetValueOnGameThread())
@@ -292,8 +617,10 @@ void UGripMotionControllerComponent::FViewExtension::BeginRenderViewFamily(FScen
 		return;
 	}	
 
-	LateUpdatePrimitives.Reset();
-	GatherLateUpdatePrimitives(MotionControllerComponent, LateUpdatePrimitives);
+	SCOPE_CYCLE_COUNTER(STAT_GatherLateUpdatePrimitives);
+
+	LateUpdateRoots.Reset();
+	LateUpdateRoots.Add(MotionControllerComponent);
 
 	/*
 	Add additional late updates registered to this controller that aren't children and aren't gripped
@@ -302,13 +629,77 @@ void UGripMotionControllerComponent::FViewExtension::BeginRenderViewFamily(FScen
 	for (UPrimitiveComponent* primComp : MotionControllerComponent->AdditionalLateUpdateComponents)
 	{
 		if (primComp)
-			GatherLateUpdatePrimitives(primComp, LateUpdatePrimitives);
+			LateUpdateRoots.Add(primComp);
 	}	
 
-
 	// Was going to use a lambda here but the overhead cost is higher than just using another function, even more so than using an inline one
 	ProcessGripArrayLateUpdatePrimitives(MotionControllerComponent->LocallyGrippedActors);
-	ProcessGripArrayLateUpdatePrimitives(MotionControllerComponent->GrippedActors);
+	ProcessGripArrayLateUpdatePrimitives(MotionControllerComponent->GrippedActors.Items);
+
+	// Only walk the hierarchies again if something changed since the last frame
+	if (!IsLateUpdateCacheValid())
+	{
+		INC_DWORD_STAT(STAT_LateUpdatePrimitiveRebuilds);
+
+		CachedLateUpdatePrimitives.Reset();
+		CachedProxylessPrimitives.Reset();
+		CachedLateUpdateHierarchySerial = UGripMotionControllerComponent::LateUpdateHierarchySerial.GetValue();
+		FPlatformAtomics::InterlockedExchange(&bFoundStaleLateUpdatePrimitive, 0);
+
+		for (USceneComponent * RootComponent : LateUpdateRoots)
+		{
+			GatherLateUpdatePrimitives(RootComponent, CachedLateUpdatePrimitives);
+		}
+
+		CachedLateUpdateRoots = LateUpdateRoots;
+		bLateUpdatePrimitivesDirty = false;
+	}
+
+	LateUpdateSnapshot & Snapshot = Snapshots[WriteSnapshotIndex];
+	Snapshot.Primitives = CachedLateUpdatePrimitives;
+	Snapshot.OldComponentToWorld = MotionControllerComponent->CalcNewComponentToWorld(MotionControllerComponent->RenderThreadRelativeTransform);
+
+	const USceneComponent * AttachParent = MotionControllerComponent->GetAttachParent();
+	Snapshot.bHasAttachParent = AttachParent != nullptr;
+	Snapshot.ParentToWorld = AttachParent ? AttachParent->GetSocketTransform(MotionControllerComponent->GetAttachSocketName()) : FTransform::Identity;
+	Snapshot.bAbsoluteLocation = MotionControllerComponent->bAbsoluteLocation;
+	Snapshot.bAbsoluteRotation = MotionControllerComponent->bAbsoluteRotation;
+	Snapshot.bAbsoluteScale = MotionControllerComponent->bAbsoluteScale;
+	Snapshot.ComponentScale = MotionControllerComponent->RenderThreadComponentScale;
+	Snapshot.HMDOffset = MotionControllerComponent->LastLocationForLateUpdate;
+	Snapshot.PlayerIndex = MotionControllerComponent->PlayerIndex;
+	Snapshot.Hand = MotionControllerComponent->Hand;
+	Snapshot.bCanPoll = (MotionControllerComponent->PlayerIndex != INDEX_NONE) && MotionControllerComponent->bHasAuthority;
+	Snapshot.bOffsetByHMD = MotionControllerComponent->bOffsetByHMD;
+
+	// Publish it and take back whichever snapshot the render thread isn't holding
+	WriteSnapshotIndex = FPlatformAtomics::InterlockedExchange(&ReadySnapshotIndex, WriteSnapshotIndex | LATE_UPDATE_SNAPSHOT_FRESH) & LATE_UPDATE_SNAPSHOT_INDEX_MASK;
+}
+
+FThreadSafeCounter UGripMotionControllerComponent::LateUpdateHierarchySerial;
+
+void UGripMotionControllerComponent::OnChildAttached(USceneComponent* ChildComponent)
+{
+	Super::OnChildAttached(ChildComponent);
+	NotifyLateUpdateHierarchyChanged();
+}
+
+void UGripMotionControllerComponent::OnChildDetached(USceneComponent* ChildComponent)
+{
+	Super::OnChildDetached(ChildComponent);
+	NotifyLateUpdateHierarchyChanged();
+}
+
+void UGripMotionControllerComponent::OnVisibilityChanged()
+{
+	Super::OnVisibilityChanged();
+	NotifyLateUpdateHierarchyChanged();
+}
+
+void UGripMotionControllerComponent::MarkLateUpdatePrimitivesDirty()
+{
+	if (ViewExtension.IsValid())
+		ViewExtension->bLateUpdatePrimitivesDirty = true;
 }
 
 void UGripMotionControllerComponent::GetPhysicsVelocities(const FBPActorGripInformation &Grip, FVector &AngularVelocity, FVector &LinearVelocity)
@@ -332,208 +723,105 @@ void UGripMotionControllerComponent::GetPhysicsVelocities(const FBPActorGripInfo
 
 void UGripMotionControllerComponent::GetGripByActor(FBPActorGripInformation &Grip, AActor * ActorToLookForGrip, EBPVRResultSwitch &Result)
 {
-	if (!ActorToLookForGrip)
+	if (FBPActorGripInformation * FoundGrip = FindGripByObject(ActorToLookForGrip))
 	{
-		Result = EBPVRResultSwitch::OnFailed;
+		Grip = *FoundGrip;
+		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
 
-	for (int i = 0; i < GrippedActors.Num(); ++i)
-	{
-		if (GrippedActors[i] == ActorToLookForGrip)
-		{
-			Grip = GrippedActors[i];
-			Result = EBPVRResultSwitch::OnSucceeded;
-			return;
-		}
-	}
-
-	for (int i = 0; i < LocallyGrippedActors.Num(); ++i)
-	{
-		if (LocallyGrippedActors[i] == ActorToLookForGrip)
-		{
-			Grip = LocallyGrippedActors[i];
-			Result = EBPVRResultSwitch::OnSucceeded;
-			return;
-		}
-	}
-
 	Result = EBPVRResultSwitch::OnFailed;
 }
 
 void UGripMotionControllerComponent::GetGripByComponent(FBPActorGripInformation &Grip, UPrimitiveComponent * ComponentToLookForGrip, EBPVRResultSwitch &Result)
 {
-	if (!ComponentToLookForGrip)
+	if (FBPActorGripInformation * FoundGrip = FindGripByObject(ComponentToLookForGrip))
 	{
-		Result = EBPVRResultSwitch::OnFailed;
+		Grip = *FoundGrip;
+		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
 
-	for (int i = 0; i < GrippedActors.Num(); ++i)
-	{
-		if (GrippedActors[i] == ComponentToLookForGrip)
-		{
-			Grip = GrippedActors[i];
-			Result = EBPVRResultSwitch::OnSucceeded;
-			return;
-		}
-	}
-
-	for (int i = 0; i < LocallyGrippedActors.Num(); ++i)
-	{
-		if (LocallyGrippedActors[i] == ComponentToLookForGrip)
-		{
-			Grip = LocallyGrippedActors[i];
-			Result = EBPVRResultSwitch::OnSucceeded;
-			return;
-		}
-	}
-
 	Result = EBPVRResultSwitch::OnFailed;
 }
 
 void UGripMotionControllerComponent::GetGripByObject(FBPActorGripInformation &Grip, UObject * ObjectToLookForGrip, EBPVRResultSwitch &Result)
 {
-	if (!ObjectToLookForGrip)
+	if (FBPActorGripInformation * FoundGrip = FindGripByObject(ObjectToLookForGrip))
 	{
-		Result = EBPVRResultSwitch::OnFailed;
+		Grip = *FoundGrip;
+		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
 
-	for (int i = 0; i < GrippedActors.Num(); ++i)
-	{
-		if (GrippedActors[i] == ObjectToLookForGrip)
-		{
-			Grip = GrippedActors[i];
-			Result = EBPVRResultSwitch::OnSucceeded;
-			return;
-		}
-	}
-
-	for (int i = 0; i < LocallyGrippedActors.Num(); ++i)
-	{
-		if (LocallyGrippedActors[i] == ObjectToLookForGrip)
-		{
-			Grip = LocallyGrippedActors[i];
-			Result = EBPVRResultSwitch::OnSucceeded;
-			return;
-		}
-	}
-
 	Result = EBPVRResultSwitch::OnFailed;
 }
 
 void UGripMotionControllerComponent::SetGripCollisionType(const FBPActorGripInformation &Grip, EBPVRResultSwitch &Result, EGripCollisionType NewGripCollisionType)
 {
-	int fIndex = GrippedActors.Find(Grip);
-
-	if (fIndex != INDEX_NONE)
+	if (FBPActorGripInformation * FoundGrip = FindGripByObject(Grip.GrippedObject))
 	{
-		GrippedActors[fIndex].GripCollisionType = NewGripCollisionType;
-		ReCreateGrip(GrippedActors[fIndex]);
+		FoundGrip->GripCollisionType = NewGripCollisionType;
+		GrippedActors.MarkGripDirty(*FoundGrip);
+		ReCreateGrip(*FoundGrip);
 		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
-	else
-	{
-		fIndex = LocallyGrippedActors.Find(Grip);
-
-		if (fIndex != INDEX_NONE)
-		{
-			LocallyGrippedActors[fIndex].GripCollisionType = NewGripCollisionType;
-			ReCreateGrip(LocallyGrippedActors[fIndex]);
-			Result = EBPVRResultSwitch::OnSucceeded;
-			return;
-		}
-	}
 
 	Result = EBPVRResultSwitch::OnFailed;
 }
 
+
 void UGripMotionControllerComponent::SetGripLateUpdateSetting(const FBPActorGripInformation &Grip, EBPVRResultSwitch &Result, EGripLateUpdateSettings NewGripLateUpdateSetting)
 {
-	int fIndex = GrippedActors.Find(Grip);
-
-	if (fIndex != INDEX_NONE)
+	if (FBPActorGripInformation * FoundGrip = FindGripByObject(Grip.GrippedObject))
 	{
-		GrippedActors[fIndex].GripLateUpdateSetting = NewGripLateUpdateSetting;
+		FoundGrip->GripLateUpdateSetting = NewGripLateUpdateSetting;
+		GrippedActors.MarkGripDirty(*FoundGrip);
 		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
-	else
-	{
-		fIndex = LocallyGrippedActors.Find(Grip);
-
-		if (fIndex != INDEX_NONE)
-		{
-			LocallyGrippedActors[fIndex].GripLateUpdateSetting = NewGripLateUpdateSetting;
-			Result = EBPVRResultSwitch::OnSucceeded;
-			return;
-		}
-	}
 
 	Result = EBPVRResultSwitch::OnFailed;
 }
 
+
 void UGripMotionControllerComponent::SetGripRelativeTransform(
 	const FBPActorGripInformation &Grip,
 	EBPVRResultSwitch &Result,
 	const FTransform & NewRelativeTransform
 	)
 {
-	int fIndex = GrippedActors.Find(Grip);
-
-	if (fIndex != INDEX_NONE)
+	if (FBPActorGripInformation * FoundGrip = FindGripByObject(Grip.GrippedObject))
 	{
-		GrippedActors[fIndex].RelativeTransform = NewRelativeTransform;
+		FoundGrip->RelativeTransform = NewRelativeTransform;
+		GrippedActors.MarkGripDirty(*FoundGrip);
 		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
-	else
-	{
-		fIndex = LocallyGrippedActors.Find(Grip);
-
-		if (fIndex != INDEX_NONE)
-		{
-			LocallyGrippedActors[fIndex].RelativeTransform = NewRelativeTransform;
-			Result = EBPVRResultSwitch::OnSucceeded;
-			return;
-		}
-	}
 
 	Result = EBPVRResultSwitch::OnFailed;
 }
 
+
 void UGripMotionControllerComponent::SetGripAdditionTransform(
 	const FBPActorGripInformation &Grip,
 	EBPVRResultSwitch &Result,
 	const FTransform & NewAdditionTransform, bool bMakeGripRelative
 	)
 {
-	int fIndex = GrippedActors.Find(Grip);
-
-	if (fIndex != INDEX_NONE)
+	if (FBPActorGripInformation * FoundGrip = FindGripByObject(Grip.GrippedObject))
 	{
-		GrippedActors[fIndex].AdditionTransform = CreateGripRelativeAdditionTransform(Grip, NewAdditionTransform, bMakeGripRelative);
+		FoundGrip->AdditionTransform = CreateGripRelativeAdditionTransform(Grip, NewAdditionTransform, bMakeGripRelative);
 
 		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
-	else
-	{
-		fIndex = LocallyGrippedActors.Find(Grip);
-
-		if (fIndex != INDEX_NONE)
-		{
-			LocallyGrippedActors[fIndex].AdditionTransform = CreateGripRelativeAdditionTransform(Grip, NewAdditionTransform, bMakeGripRelative);
 
-			Result = EBPVRResultSwitch::OnSucceeded;
-			return;
-		}
-	}
 	Result = EBPVRResultSwitch::OnFailed;
 }
 
+
 void UGripMotionControllerComponent::SetGripStiffnessAndDamping(
 	const FBPActorGripInformation &Grip,
 	EBPVRResultSwitch &Result,
@@ -541,45 +829,27 @@ void UGripMotionControllerComponent::SetGripStiffnessAndDamping(
 	)
 {
 	Result = EBPVRResultSwitch::OnFailed;
-	int fIndex = GrippedActors.Find(Grip);
 
-	if (fIndex != INDEX_NONE)
+	if (FBPActorGripInformation * FoundGrip = FindGripByObject(Grip.GrippedObject))
 	{
-		GrippedActors[fIndex].Stiffness = NewStiffness;
-		GrippedActors[fIndex].Damping = NewDamping;
+		FoundGrip->Stiffness = NewStiffness;
+		FoundGrip->Damping = NewDamping;
 
 		if (bAlsoSetAngularValues)
 		{
-			GrippedActors[fIndex].AdvancedPhysicsSettings.AngularStiffness = OptionalAngularStiffness;
-			GrippedActors[fIndex].AdvancedPhysicsSettings.AngularDamping = OptionalAngularDamping;
+			FoundGrip->AdvancedPhysicsSettings.AngularStiffness = OptionalAngularStiffness;
+			FoundGrip->AdvancedPhysicsSettings.AngularDamping = OptionalAngularDamping;
 		}
 
-		Result = EBPVRResultSwitch::OnSucceeded;
-		//return;
-	}
-	else
-	{
-		fIndex = LocallyGrippedActors.Find(Grip);
-
-		if (fIndex != INDEX_NONE)
-		{
-			LocallyGrippedActors[fIndex].Stiffness = NewStiffness;
-			LocallyGrippedActors[fIndex].Damping = NewDamping;
+		GrippedActors.MarkGripDirty(*FoundGrip);
 
-			if (bAlsoSetAngularValues)
-			{
-				LocallyGrippedActors[fIndex].AdvancedPhysicsSettings.AngularStiffness = OptionalAngularStiffness;
-				LocallyGrippedActors[fIndex].AdvancedPhysicsSettings.AngularDamping = OptionalAngularDamping;
-			}
-
-			Result = EBPVRResultSwitch::OnSucceeded;
-		//	return;
-		}
+		Result = EBPVRResultSwitch::OnSucceeded;
 	}
 
 	SetGripConstraintStiffnessAndDamping(&Grip, false);
 }
 
+
 FTransform UGripMotionControllerComponent::CreateGripRelativeAdditionTransform_BP(
 	const FBPActorGripInformation &GripToSample,
 	const FTransform & AdditionTransform,
@@ -942,8 +1212,12 @@ bool UGripMotionControllerComponent::GripActor(
 	if (!bIsLocalGrip)
 		GrippedActors.Add(newActorGrip);
 	else
-	{
 		LocallyGrippedActors.Add(newActorGrip);
+
+	RebuildGripIndex();
+
+	if (bIsLocalGrip)
+	{
 		if(GetNetMode() == ENetMode::NM_Client && newActorGrip.GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive)
 			Server_NotifyLocalGripAddedOrChanged(newActorGrip);
 	}
@@ -961,12 +1235,12 @@ bool UGripMotionControllerComponent::DropActor(AActor* ActorToDrop, bool bSimula
 		return false;
 	}
 
-	for (int i = LocallyGrippedActors.Num() - 1; i >= 0; --i)
+	bool bIsLocalGrip = false;
+	FBPActorGripInformation * FoundGrip = FindGripByObject(ActorToDrop, nullptr, &bIsLocalGrip);
+
+	if (FoundGrip && bIsLocalGrip)
 	{
-		if (LocallyGrippedActors[i] == ActorToDrop)
-		{
-			return DropGrip(LocallyGrippedActors[i], bSimulate, OptionalAngularVelocity, OptionalLinearVelocity);
-		}
+		return DropGrip(*FoundGrip, bSimulate, OptionalAngularVelocity, OptionalLinearVelocity);
 	}
 
 	if (!IsServer())
@@ -975,13 +1249,9 @@ bool UGripMotionControllerComponent::DropActor(AActor* ActorToDrop, bool bSimula
 		return false;
 	}
 
-	for (int i = GrippedActors.Num() - 1; i >= 0; --i)
+	if (FoundGrip)
 	{
-		if (GrippedActors[i] == ActorToDrop)
-		{
-
-			return DropGrip(GrippedActors[i], bSimulate, OptionalAngularVelocity, OptionalLinearVelocity);
-		}
+		return DropGrip(*FoundGrip, bSimulate, OptionalAngularVelocity, OptionalLinearVelocity);
 	}
 
 	return false;
@@ -1121,9 +1391,12 @@ bool UGripMotionControllerComponent::GripComponent(
 	if (!bIsLocalGrip)
 		GrippedActors.Add(newActorGrip);
 	else
-	{
 		LocallyGrippedActors.Add(newActorGrip);
 
+	RebuildGripIndex();
+
+	if (bIsLocalGrip)
+	{
 		if (GetNetMode() == ENetMode::NM_Client && newActorGrip.GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive)
 			Server_NotifyLocalGripAddedOrChanged(newActorGrip);
 	}
@@ -1141,12 +1414,12 @@ bool UGripMotionControllerComponent::DropComponent(UPrimitiveComponent * Compone
 		return false;
 	}
 
-	for (int i = LocallyGrippedActors.Num() - 1; i >= 0; --i)
+	bool bIsLocalGrip = false;
+	FBPActorGripInformation * FoundGrip = FindGripByObject(ComponentToDrop, nullptr, &bIsLocalGrip);
+
+	if (FoundGrip && bIsLocalGrip)
 	{
-		if (LocallyGrippedActors[i] == ComponentToDrop)
-		{
-			return DropGrip(LocallyGrippedActors[i], bSimulate, OptionalAngularVelocity, OptionalLinearVelocity);
-		}
+		return DropGrip(*FoundGrip, bSimulate, OptionalAngularVelocity, OptionalLinearVelocity);
 	}
 
 	if (!IsServer())
@@ -1155,13 +1428,11 @@ bool UGripMotionControllerComponent::DropComponent(UPrimitiveComponent * Compone
 		return false;
 	}
 
-	for (int i = GrippedActors.Num() - 1; i >= 0; --i)
+	if (FoundGrip)
 	{
-		if (GrippedActors[i] == ComponentToDrop)
-		{
-			return DropGrip(GrippedActors[i], bSimulate,OptionalAngularVelocity, OptionalLinearVelocity);
-		}
+		return DropGrip(*FoundGrip, bSimulate, OptionalAngularVelocity, OptionalLinearVelocity);
 	}
+
 	return false;
 }
 
@@ -1170,24 +1441,17 @@ bool UGripMotionControllerComponent::DropGrip(const FBPActorGripInformation &Gri
 
 	int FoundIndex = 0;
 	bool bWasLocalGrip = false;
-	if (!LocallyGrippedActors.Find(Grip, FoundIndex)) // This auto checks if Actor and Component are valid in the == operator
+	if (!FindGripByObject(Grip.GrippedObject, &FoundIndex, &bWasLocalGrip))
 	{
-		if (!IsServer())
-		{
-			UE_LOG(LogVRMotionController, Warning, TEXT("VRGripMotionController drop function was called on the client side for a replicated grip"));
-			return false;
-		}
-
-		if (!GrippedActors.Find(Grip, FoundIndex)) // This auto checks if Actor and Component are valid in the == operator
-		{
-			UE_LOG(LogVRMotionController, Warning, TEXT("VRGripMotionController drop function was passed an invalid drop"));
-			return false;
-		}
+		UE_LOG(LogVRMotionController, Warning, TEXT("VRGripMotionController drop function was passed an invalid drop"));
+		return false;
+	}
 
-		bWasLocalGrip = false;
+	if (!bWasLocalGrip && !IsServer())
+	{
+		UE_LOG(LogVRMotionController, Warning, TEXT("VRGripMotionController drop function was called on the client side for a replicated grip"));
+		return false;
 	}
-	else
-		bWasLocalGrip = true;
 
 
 	UPrimitiveComponent * PrimComp = nullptr;
@@ -1246,6 +1510,8 @@ bool UGripMotionControllerComponent::DropGrip(const FBPActorGripInformation &Gri
 // No longer an RPC, now is called from RepNotify so that joining clients also correctly set up grips
 void UGripMotionControllerComponent::NotifyGrip(const FBPActorGripInformation &NewGrip, bool bIsReInit)
 {
+	MarkLateUpdatePrimitivesDirty();
+
 	UPrimitiveComponent *root = NULL;
 	AActor *pActor = NULL;
 
@@ -1390,12 +1656,31 @@ void UGripMotionControllerComponent::NotifyGrip(const FBPActorGripInformation &N
 
 void UGripMotionControllerComponent::NotifyDrop_Implementation(const FBPActorGripInformation &NewDrop, bool bSimulate)
 {
+	MarkLateUpdatePrimitivesDirty();
+
 	// Don't do this if we are the owning player on a local grip, there is no filter for multicast to not send to owner
 	if (NewDrop.GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive && IsLocallyControlled() && GetNetMode() == ENetMode::NM_Client)
 	{
 		return;
 	}
 
+	// The grip list replicated the removal ahead of this and it was already dropped, only the simulate setting is left to apply
+	if (!IsServer() && NewDrop.GrippedObject && !FindGripByObject(NewDrop.GrippedObject))
+	{
+		UPrimitiveComponent * root = NewDrop.GetGrippedComponent();
+		if (!root && NewDrop.GetGrippedActor())
+			root = Cast<UPrimitiveComponent>(NewDrop.GetGrippedActor()->GetRootComponent());
+
+		if (root)
+		{
+			root->SetSimulatePhysics(bSimulate);
+			if (bSimulate)
+				root->WakeAllRigidBodies();
+		}
+
+		return;
+	}
+
 	Drop_Implementation(NewDrop, bSimulate);
 }
 
@@ -1505,18 +1790,20 @@ void UGripMotionControllerComponent::Drop_Implementation(const FBPActorGripInfor
 	}
 
 	// Remove the drop from the array, can't wait around for replication as the tick function will start in on it.
+	GripValueCaches.Remove(NewDrop.GrippedObject);
+	CachedInteractionSettings.Remove(NewDrop.GrippedObject);
+	PendingGripSweeps.Remove(NewDrop.GrippedObject);
+
 	int fIndex = 0;
-	if (LocallyGrippedActors.Find(NewDrop, fIndex))
-	{
-		LocallyGrippedActors.RemoveAt(fIndex);
-	}
-	else
+	bool bWasLocalGrip = false;
+	if (FindGripByObject(NewDrop.GrippedObject, &fIndex, &bWasLocalGrip))
 	{
-		fIndex = 0;
-		if (GrippedActors.Find(NewDrop, fIndex))
-		{
+		if (bWasLocalGrip)
+			LocallyGrippedActors.RemoveAt(fIndex);
+		else
 			GrippedActors.RemoveAt(fIndex);
-		}
+
+		RebuildGripIndex();
 	}
 }
 
@@ -1660,6 +1947,7 @@ bool UGripMotionControllerComponent::AddSecondaryAttachmentPoint(UObject * Gripp
 				GripToUse->SecondaryAttachment, GripToUse->SecondarySmoothingScaler, GripToUse->SecondaryRelativeLocation, GripToUse->LerpToRate);
 		}
 
+		GrippedActors.MarkGripDirty(*GripToUse);
 		GripToUse = nullptr;
 
 		return true;
@@ -1784,6 +2072,7 @@ bool UGripMotionControllerComponent::RemoveSecondaryAttachmentPoint(UObject * Gr
 				GripToUse->SecondaryRelativeLocation, GripToUse->LerpToRate);
 		}
 
+		GrippedActors.MarkGripDirty(*GripToUse);
 		GripToUse = nullptr;
 		return true;
 	}
@@ -1798,20 +2087,9 @@ bool UGripMotionControllerComponent::TeleportMoveGrippedActor(AActor * GrippedAc
 
 	FTransform WorldTransform;
 	FTransform InverseTransform = this->GetComponentTransform().Inverse();
-	for (int i = LocallyGrippedActors.Num() - 1; i >= 0; --i)
-	{
-		if (LocallyGrippedActors[i].GrippedObject == GrippedActorToMove)
-		{
-			return TeleportMoveGrip(LocallyGrippedActors[i]);
-		}
-	}
-
-	for (int i = GrippedActors.Num() - 1; i >= 0; --i)
+	if (FBPActorGripInformation * FoundGrip = FindGripByObject(GrippedActorToMove))
 	{
-		if (GrippedActors[i].GrippedObject == GrippedActorToMove)
-		{
-			return TeleportMoveGrip(GrippedActors[i]);
-		}
+		return TeleportMoveGrip(*FoundGrip);
 	}
 
 	return false;
@@ -1824,20 +2102,9 @@ bool UGripMotionControllerComponent::TeleportMoveGrippedComponent(UPrimitiveComp
 
 	FTransform WorldTransform;
 	FTransform InverseTransform = this->GetComponentTransform().Inverse();
-	for (int i = LocallyGrippedActors.Num() - 1; i >= 0; --i)
+	if (FBPActorGripInformation * FoundGrip = FindGripByObject(ComponentToMove))
 	{
-		if (LocallyGrippedActors[i].GrippedObject == ComponentToMove)
-		{
-			return TeleportMoveGrip(LocallyGrippedActors[i]);
-		}
-	}
-
-	for (int i = GrippedActors.Num() - 1; i >= 0; --i)
-	{
-		if (GrippedActors[i].GrippedObject == ComponentToMove)
-		{
-			return TeleportMoveGrip(GrippedActors[i]);
-		}
+		return TeleportMoveGrip(*FoundGrip);
 	}
 
 	return false;
@@ -1879,19 +2146,12 @@ bool UGripMotionControllerComponent::TeleportMoveGrip(const FBPActorGripInformat
 	if (!PrimComp || !actor)
 		return false;
 
-	// Check if either implements the interface
-	bool bRootHasInterface = false;
-	bool bActorHasInterface = false;
+	FBPActorGripInformation copyGrip = Grip;
 
-	if (PrimComp->GetClass()->ImplementsInterface(UVRGripInterface::StaticClass()))
-	{
-		bRootHasInterface = true;
-	}
-	if (actor->GetClass()->ImplementsInterface(UVRGripInterface::StaticClass()))
-	{
-		// Actor grip interface is checked after component
-		bActorHasInterface = true;
-	}
+	// Check if either implements the interface
+	ResolveGripInterfaceCache(copyGrip, PrimComp, actor);
+	bool bRootHasInterface = copyGrip.InterfaceCache.bRootHasInterface;
+	bool bActorHasInterface = copyGrip.InterfaceCache.bActorHasInterface;
 
 
 	// Only use with actual teleporting
@@ -1939,10 +2199,8 @@ bool UGripMotionControllerComponent::TeleportMoveGrip(const FBPActorGripInformat
 	FTransform WorldTransform;
 	FTransform ParentTransform = this->GetComponentTransform();
 
-	FBPActorGripInformation copyGrip = Grip;
-
 	bool bRescalePhysicsGrips = false;
-	GetGripWorldTransform(0.0f, WorldTransform, ParentTransform, copyGrip, actor, PrimComp, bRootHasInterface, bActorHasInterface, bRescalePhysicsGrips);
+	GetGripWorldTransform(0.0f, WorldTransform, ParentTransform, copyGrip, actor, PrimComp, bRescalePhysicsGrips);
 
 	//WorldTransform = Grip.RelativeTransform * ParentTransform;
 
@@ -1969,6 +2227,9 @@ bool UGripMotionControllerComponent::TeleportMoveGrip(const FBPActorGripInformat
 
 	#if WITH_PHYSX
 		{
+			// Teleporting sets the pose directly, a target queued earlier this frame would pull it back
+			FGripPhysicsBatch::Get().RemovePending(Handle->SceneIndex, Handle->KinActorData, nullptr);
+
 			PxScene* PScene = GetPhysXSceneFromIndex(Handle->SceneIndex);
 			if (PScene)
 			{
@@ -2065,28 +2326,53 @@ void UGripMotionControllerComponent::TickComponent(float DeltaTime, enum ELevelT
 		// Don't bother with any of this if not replicating transform
 		if (bReplicates && (bTracked || bReplicateWithoutTracking))
 		{
-			// Don't rep if no changes
-			if (this->RelativeLocation != ReplicatedControllerTransform.Position || this->RelativeRotation != ReplicatedControllerTransform.Rotation)
+			const bool bPoseChanged = this->RelativeLocation != ReplicatedControllerTransform.Position || this->RelativeRotation != ReplicatedControllerTransform.Rotation;
+
+			if (bPoseChanged)
 			{
 				// Tracked doesn't matter, already set the relative location above in that case
 				ReplicatedControllerTransform.Position = this->RelativeLocation;
 				ReplicatedControllerTransform.Rotation = this->RelativeRotation;
+			}
 
-				if (GetNetMode() == NM_Client)//bReplicateControllerTransform)
+			if (GetNetMode() == NM_Client && !bTransformSentByOwner)//bReplicateControllerTransform)
+			{
+				bool bSendPose = false;
+
+				if (AdaptiveSendSettings.bUseAdaptiveSendRate)
+				{
+					// Runs every frame, it has to see the device standing still to drop the rate
+					bSendPose = PoseSendScheduler.ShouldSend(ReplicatedControllerTransform.Position, ReplicatedControllerTransform.Rotation, DeltaTime, ControllerNetUpdateRate, AdaptiveSendSettings);
+				}
+				else if (bPoseChanged) // Don't rep if no changes
 				{
 					ControllerNetUpdateCount += DeltaTime;
-					if (ControllerNetUpdateCount >= (1.0f / ControllerNetUpdateRate))
-					{
-						ControllerNetUpdateCount = 0.0f;
-						Server_SendControllerTransform(ReplicatedControllerTransform);
-					}
+					bSendPose = ControllerNetUpdateCount >= (1.0f / ControllerNetUpdateRate);
+				}
+
+				if (bSendPose)
+				{
+					ControllerNetUpdateCount = 0.0f;
+					PoseSendScheduler.OnPoseSent(ReplicatedControllerTransform.Position, ReplicatedControllerTransform.Rotation);
+
+					FBPVRComponentPosRep SendTransform = ReplicatedControllerTransform;
+					PoseBaselineSender.PrepareForSend(SendTransform);
+					Server_SendControllerTransform(SendTransform);
 				}
 			}
 		}
 	}
 	else
 	{
-		if (bLerpingPosition)
+		if (bSmoothReplicatedMotion && ReplicatedMotionSmoothing.bUseSnapshotInterpolation)
+		{
+			FVector SampledPosition;
+			FRotator SampledRotation;
+
+			if (ReplicatedPoseBuffer.Sample(GetWorld()->GetRealTimeSeconds(), ReplicatedMotionSmoothing, SampledPosition, SampledRotation))
+				SetRelativeLocationAndRotation(SampledPosition, SampledRotation);
+		}
+		else if (bLerpingPosition)
 		{
 			ControllerNetUpdateCount += DeltaTime;
 			float LerpVal = FMath::Clamp(ControllerNetUpdateCount / (1.0f / ControllerNetUpdateRate), 0.0f, 1.0f);
@@ -2119,17 +2405,23 @@ void UGripMotionControllerComponent::TickComponent(float DeltaTime, enum ELevelT
 
 }
 
-void UGripMotionControllerComponent::GetGripWorldTransform(float DeltaTime, FTransform & WorldTransform, const FTransform &ParentTransform, FBPActorGripInformation &Grip, AActor * actor, UPrimitiveComponent * root, bool bRootHasInterface, bool bActorHasInterface, bool & bRescalePhysicsGrips)
+void UGripMotionControllerComponent::ReadGripInterfaceAnswers(const FBPActorGripInformation & Grip, FGripInterfaceAnswers & Answers) const
+{
+	Answers.bIsInteractible = GetGripIsInteractible(Grip);
+
+	if (Answers.bIsInteractible)
+		Answers.InteractionSettings = GetGripInteractionSettings(Grip);
+
+	// Only used for the scaling setting of a multi grip
+	Answers.SecondaryGripType = (Grip.bHasSecondaryAttachment && Grip.SecondaryAttachment) ? GetGripSecondaryGripType(Grip) : ESecondaryGripType::SG_None;
+}
+
+void UGripMotionControllerComponent::ComputeGripWorldTransform(float DeltaTime, FTransform & WorldTransform, const FTransform &ParentTransform, FBPActorGripInformation &Grip, UPrimitiveComponent * root, const FGripInterfaceAnswers & Answers, bool & bRescalePhysicsGrips)
 {
 	// Check for interaction interface and modify transform by it
-	if (bRootHasInterface && IVRGripInterface::Execute_IsInteractible(root))
+	if (Answers.bIsInteractible)
 	{
-		WorldTransform = HandleInteractionSettings(DeltaTime, ParentTransform, root, IVRGripInterface::Execute_GetInteractionSettings(root), Grip);
-	}
-	else if (bActorHasInterface && IVRGripInterface::Execute_IsInteractible(actor))
-	{
-		// Actor grip interface is checked after component
-		WorldTransform = HandleInteractionSettings(DeltaTime, ParentTransform, root, IVRGripInterface::Execute_GetInteractionSettings(actor), Grip);
+		WorldTransform = HandleInteractionSettings(DeltaTime, ParentTransform, root, Answers.InteractionSettings, Grip);
 	}
 	else
 	{
@@ -2222,12 +2514,7 @@ void UGripMotionControllerComponent::GetGripWorldTransform(float DeltaTime, FTra
 		if (Grip.GripLerpState != EGripLerpState::EndLerp)
 		{
 			// Checking secondary grip type for the scaling setting
-			ESecondaryGripType SecondaryType = ESecondaryGripType::SG_None;
-
-			if (bRootHasInterface)
-				SecondaryType = IVRGripInterface::Execute_SecondaryGripType(root);
-			else if (bActorHasInterface)
-				SecondaryType = IVRGripInterface::Execute_SecondaryGripType(actor);
+			ESecondaryGripType SecondaryType = Answers.SecondaryGripType;
 
 			//float Scaler = 1.0f;
 			if (SecondaryType == ESecondaryGripType::SG_FreeWithScaling_Retain || SecondaryType == ESecondaryGripType::SG_SlotOnlyWithScaling_Retain)
@@ -2258,13 +2545,114 @@ void UGripMotionControllerComponent::TickGrip(float DeltaTime)
 
 	FVector MotionControllerLocDelta = this->GetComponentLocation() - LastControllerLocation;
 
-	// Set the last controller world location for next frame
-	LastControllerLocation = this->GetComponentLocation();
+	// Set the last controller world location for next frame
+	LastControllerLocation = this->GetComponentLocation();
+
+	// Split into separate functions so that I didn't have to combine arrays since I have some removal going on
+	HandleGripArray(GrippedActors.Items, ParentTransform, MotionControllerLocDelta, DeltaTime, true);
+	HandleGripArray(LocallyGrippedActors, ParentTransform, MotionControllerLocDelta, DeltaTime);
+
+}
+
+bool UGripMotionControllerComponent::ComputeGripTransforms(TArray<FBPActorGripInformation> &GrippedObjects, const FTransform & ParentTransform, float DeltaTime)
+{
+	const int32 MinGrips = CVarGripParallelComputeMinGrips.GetValueOnGameThread();
+
+	if (MinGrips <= 0 || GrippedObjects.Num() < MinGrips)
+		return false;
+
+	SCOPE_CYCLE_COUNTER(STAT_ComputeGripTransforms);
+
+	PrecomputedGripTransforms.Reset();
+	PrecomputedGripTransforms.SetNum(GrippedObjects.Num());
+
+	// The component each grip moves in the apply loop, null if it doesn't move one
+	TArray<USceneComponent *, TInlineAllocator<16>> MovedComponents;
+	MovedComponents.AddZeroed(GrippedObjects.Num());
+
+	for (int32 i = 0; i < GrippedObjects.Num(); ++i)
+	{
+		FBPActorGripInformation & Grip = GrippedObjects[i];
+
+		if (!HasGripMovementAuthority(Grip) || !Grip.GrippedObject || Grip.GrippedObject->IsPendingKill())
+			continue;
+
+		FPrecomputedGripTransform & Entry = PrecomputedGripTransforms[i];
+
+		if (!GetGripTargets(Grip, Entry.Root, Entry.Actor))
+			continue;
+
+		ResolveGripInterfaceCache(Grip, Entry.Root, Entry.Actor);
+
+		// A blueprint TickGrip can move anything between two grips being applied, nothing computed ahead of it could be trusted
+		const FGripInterfaceCache & Cache = Grip.InterfaceCache;
+		if ((Cache.bRootHasInterface && !Cache.RootTickNative) || (Cache.bActorHasInterface && !Cache.ActorTickNative))
+			return false;
+
+		if (Grip.GripCollisionType != EGripCollisionType::CustomGrip)
+			MovedComponents[i] = Entry.Root;
+	}
+
+	TArray<int32, TInlineAllocator<16>> GripsToCompute;
+
+	// Anything that can reach blueprint or the controller devices stays on the game thread, grips that need it are left to the apply loop
+	for (int32 i = 0; i < GrippedObjects.Num(); ++i)
+	{
+		if (!MovedComponents[i])
+			continue;
+
+		FBPActorGripInformation & Grip = GrippedObjects[i];
+		FPrecomputedGripTransform & Entry = PrecomputedGripTransforms[i];
+
+		// Polling a secondary controller reads the HMD, which is only allowed on the game thread
+		if (bHasAuthority && Grip.bHasSecondaryAttachment && Grip.SecondaryAttachment &&
+			Grip.SecondaryAttachment->GetOwner() == this->GetOwner() && Grip.SecondaryAttachment->IsA<UGripMotionControllerComponent>())
+			continue;
+
+		// The transform reads the controller, the secondary attachment and the roots parent. The apply loop runs from the back,
+		// so if a grip after this one moves any of those this would read them before they moved instead of after.
+		const USceneComponent * Dependencies[] = { this, (Grip.bHasSecondaryAttachment ? Grip.SecondaryAttachment : nullptr), Entry.Root->GetAttachParent() };
+		bool bReadsMovedComponent = false;
+
+		for (int32 j = i + 1; j < GrippedObjects.Num() && !bReadsMovedComponent; ++j)
+		{
+			if (!MovedComponents[j])
+				continue;
+
+			for (const USceneComponent * Dependency : Dependencies)
+			{
+				if (Dependency && (Dependency == MovedComponents[j] || Dependency->IsAttachedTo(MovedComponents[j])))
+				{
+					bReadsMovedComponent = true;
+					break;
+				}
+			}
+		}
+
+		if (bReadsMovedComponent)
+			continue;
+
+		// Native interface implementations can still be overridden in code, so they are read here and not on the workers
+		ReadGripInterfaceAnswers(Grip, Entry.Answers);
+		GripsToCompute.Add(i);
+	}
+
+	if (!GripsToCompute.Num())
+		return false;
+
+	// Each grip only writes its own lerp state and entry, everything else is read only until the apply loop runs
+	ParallelFor(GripsToCompute.Num(), [&](int32 ComputeIndex)
+	{
+		const int32 GripIndex = GripsToCompute[ComputeIndex];
+		FBPActorGripInformation & Grip = GrippedObjects[GripIndex];
+		FPrecomputedGripTransform & Entry = PrecomputedGripTransforms[GripIndex];
 
-	// Split into separate functions so that I didn't have to combine arrays since I have some removal going on
-	HandleGripArray(GrippedActors, ParentTransform, MotionControllerLocDelta, DeltaTime, true);
-	HandleGripArray(LocallyGrippedActors, ParentTransform, MotionControllerLocDelta, DeltaTime);
+		ComputeGripWorldTransform(DeltaTime, Entry.WorldTransform, ParentTransform, Grip, Entry.Root, Entry.Answers, Entry.bRescalePhysicsGrips);
+		Entry.GrippedObject = Grip.GrippedObject;
+	});
 
+	INC_DWORD_STAT_BY(STAT_ParallelGripTransforms, GripsToCompute.Num());
+	return true;
 }
 
 void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformation> &GrippedObjects, const FTransform & ParentTransform, const FVector &MotionControllerLocDelta, float DeltaTime, bool bReplicatedArray)
@@ -2273,6 +2661,9 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 	{
 		FTransform WorldTransform;
 
+		// Pure transform math first, the loop below is the apply phase that moves, sweeps and updates handles on the game thread
+		const bool bHasPrecomputedTransforms = ComputeGripTransforms(GrippedObjects, ParentTransform, DeltaTime);
+
 		for (int i = GrippedObjects.Num() - 1; i >= 0; --i)
 		{
 			if (!HasGripMovementAuthority(GrippedObjects[i]))
@@ -2288,30 +2679,8 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 				UPrimitiveComponent *root = NULL;
 				AActor *actor = NULL;
 
-				// Getting the correct variables depending on the grip target type
-				switch (Grip->GripTargetType)
-				{
-					case EGripTargetType::ActorGrip:
-					//case EGripTargetType::InteractibleActorGrip:
-					{
-						actor = Grip->GetGrippedActor();
-						if(actor)
-							root = Cast<UPrimitiveComponent>(actor->GetRootComponent());
-					}break;
-
-					case EGripTargetType::ComponentGrip:
-					//case EGripTargetType::InteractibleComponentGrip :
-					{
-						root = Grip->GetGrippedComponent();
-						if(root)
-							actor = root->GetOwner();
-					}break;
-
-				default:break;
-				}
-
-				// Last check to make sure the variables are valid
-				if (!root || !actor)
+				// Getting the correct variables depending on the grip target type, and making sure they are valid
+				if (!GetGripTargets(*Grip, root, actor))
 					continue;
 
 				// #TODO: Should this even be here? Or should I enforce destructible components being sub components and users doing proper cleanup?
@@ -2328,40 +2697,38 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 				}
 #endif // #if WITH_APEX
 
-				// Check if either implements the interface
-				bool bRootHasInterface = false;
-				bool bActorHasInterface = false;
-				
-				if (root->GetClass()->ImplementsInterface(UVRGripInterface::StaticClass()))
-				{
-					bRootHasInterface = true;
-				}
-				if (actor->GetClass()->ImplementsInterface(UVRGripInterface::StaticClass()))
-				{
-					// Actor grip interface is checked after component
-					bActorHasInterface = true;
-				}
+				// Check if either implements the interface, only actually checks the classes the first time through
+				ResolveGripInterfaceCache(*Grip, root, actor);
+				bool bRootHasInterface = Grip->InterfaceCache.bRootHasInterface;
+				bool bActorHasInterface = Grip->InterfaceCache.bActorHasInterface;
 
 				if (Grip->GripCollisionType == EGripCollisionType::CustomGrip)
 				{
 					// Don't perform logic on the movement for this object, just pass in the GripTick() event with the controller difference instead
-					if (bRootHasInterface)
-					{
-						IVRGripInterface::Execute_TickGrip(root, this, *Grip, MotionControllerLocDelta, DeltaTime);
-					}
-					
-					if (bActorHasInterface)
-					{
-						IVRGripInterface::Execute_TickGrip(actor, this, *Grip, MotionControllerLocDelta, DeltaTime);
-					}
-
+					SendTickGrip(*Grip, root, actor, MotionControllerLocDelta, DeltaTime);
 					continue;
 				}
 
 				bool bRescalePhysicsGrips = false;
-				
-				// Get the world transform for this grip after handling secondary grips and interaction differences
-				GetGripWorldTransform(DeltaTime, WorldTransform, ParentTransform, *Grip, actor, root, bRootHasInterface, bActorHasInterface, bRescalePhysicsGrips);
+
+				// Drops fired from earlier in this loop can shift grips around, only trust an entry that is still for this object
+				const FPrecomputedGripTransform * Precomputed = nullptr;
+				if (bHasPrecomputedTransforms)
+				{
+					Precomputed = PrecomputedGripTransforms.IsValidIndex(i) && PrecomputedGripTransforms[i].GrippedObject == Grip->GrippedObject ? &PrecomputedGripTransforms[i] :
+						PrecomputedGripTransforms.FindByPredicate([Grip](const FPrecomputedGripTransform & Entry) { return Entry.GrippedObject == Grip->GrippedObject; });
+				}
+
+				if (Precomputed)
+				{
+					WorldTransform = Precomputed->WorldTransform;
+					bRescalePhysicsGrips = Precomputed->bRescalePhysicsGrips;
+				}
+				else
+				{
+					// Get the world transform for this grip after handling secondary grips and interaction differences
+					GetGripWorldTransform(DeltaTime, WorldTransform, ParentTransform, *Grip, actor, root, bRescalePhysicsGrips);
+				}
 
 				// Auto drop based on distance from expected point
 				// Not perfect, should be done post physics or in next frame prior to changing controller location
@@ -2377,16 +2744,7 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 						)
 					)
 				{
-					float BreakDistance = 0.0f;
-					if (bRootHasInterface)
-					{
-						BreakDistance = IVRGripInterface::Execute_GripBreakDistance(root);
-					}
-					else if (bActorHasInterface)
-					{
-						// Actor grip interface is checked after component
-						BreakDistance = IVRGripInterface::Execute_GripBreakDistance(actor);
-					}
+					float BreakDistance = GetGripBreakDistance(*Grip);
 
 					if (BreakDistance > 0.0f)
 					{
@@ -2670,7 +3028,11 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 
 							if (bUseWithoutTracking || move.SizeSquared() > MinMovementDistSq || NewOrientation != OriginalOrientation)
 							{
-								if (CheckComponentWithSweep(root, move, OriginalOrientation, false))
+								// Async sweeps trade a frame of collision latency for not blocking the game thread on the query
+								const bool bAsyncSweep = CVarGripAsyncSweeps.GetValueOnGameThread() > 0 &&
+									!(Grip->AdvancedPhysicsSettings.bUseAdvancedPhysicsSettings && Grip->AdvancedPhysicsSettings.bPrecisionCriticalSweep);
+
+								if (bAsyncSweep ? CheckComponentWithAsyncSweep(*Grip, root, move) : CheckComponentWithSweep(root, move, OriginalOrientation, false))
 								{
 									Grip->bColliding = true;
 								}
@@ -2708,15 +3070,7 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 				if (bAlwaysSendTickGrip)
 				{
 					// All non custom grips tick after translation, this is still pre physics so interactive grips location will be wrong, but others will be correct
-					if (bRootHasInterface)
-					{
-						IVRGripInterface::Execute_TickGrip(root, this, *Grip, MotionControllerLocDelta, DeltaTime);
-					}
-
-					if (bActorHasInterface)
-					{
-						IVRGripInterface::Execute_TickGrip(actor, this, *Grip, MotionControllerLocDelta, DeltaTime);
-					}
+					SendTickGrip(*Grip, root, actor, MotionControllerLocDelta, DeltaTime);
 				}
 			}
 			else
@@ -2734,13 +3088,14 @@ void UGripMotionControllerComponent::CleanUpBadGrip(TArray<FBPActorGripInformati
 	// Object has been destroyed without notification to plugin
 
 	// Clean up tailing physics handles with null objects
-	for (int g = PhysicsGrips.Num() - 1; g >= 0; --g)
+	for (auto It = PhysicsGrips.CreateIterator(); It; ++It)
 	{
-		if (!PhysicsGrips[g].HandledObject || PhysicsGrips[g].HandledObject == GrippedObjects[GripIndex].GrippedObject || PhysicsGrips[g].HandledObject->IsPendingKill())
+		if (!It->HandledObject || It->HandledObject == GrippedObjects[GripIndex].GrippedObject || It->HandledObject->IsPendingKill())
 		{
 			// Need to delete it from the physics thread
-			DestroyPhysicsHandle(PhysicsGrips[g].SceneIndex, &PhysicsGrips[g].HandleData, &PhysicsGrips[g].KinActorData);
-			PhysicsGrips.RemoveAt(g);
+			DestroyPhysicsHandle(It->SceneIndex, &It->HandleData, &It->KinActorData);
+			PhysicsGripSlots.Remove(It->HandledObject);
+			It.RemoveCurrent();
 		}
 	}
 
@@ -2749,13 +3104,116 @@ void UGripMotionControllerComponent::CleanUpBadGrip(TArray<FBPActorGripInformati
 
 	if (!bReplicatedArray || IsServer())
 	{
+		GripValueCaches.Remove(GrippedObjects[GripIndex].GrippedObject);
+		CachedInteractionSettings.Remove(GrippedObjects[GripIndex].GrippedObject);
+		PendingGripSweeps.Remove(GrippedObjects[GripIndex].GrippedObject);
+
 		UE_LOG(LogVRMotionController, Warning, TEXT("Gripped object was null or destroying, auto dropping it"));
 		GrippedObjects.RemoveAt(GripIndex); // If it got garbage collected then just remove the pointer, won't happen with new uproperty use, but keeping it here anyway
+
+		if (bReplicatedArray)
+			GrippedActors.MarkArrayDirty();
+
+		RebuildGripIndex();
+		MarkLateUpdatePrimitivesDirty();
+	}
+}
+
+
+void UGripMotionControllerComponent::ResolveGripInterfaceCache(FBPActorGripInformation & Grip, UPrimitiveComponent * root, AActor * actor)
+{
+	FGripInterfaceCache & Cache = Grip.InterfaceCache;
+
+	if (Cache.bIsValid && Cache.CachedRoot == root && Cache.CachedActor == actor)
+		return;
+
+	Cache.Reset();
+	Cache.bIsValid = true;
+	Cache.CachedRoot = root;
+	Cache.CachedActor = actor;
+
+	if (root && root->GetClass()->ImplementsInterface(UVRGripInterface::StaticClass()))
+	{
+		Cache.bRootHasInterface = true;
+		Cache.InterfaceObject = root;
+		Cache.RootTickNative = GetNativeGripInterfaceForEvent(root, NAME_TickGrip);
+	}
+
+	if (actor && actor->GetClass()->ImplementsInterface(UVRGripInterface::StaticClass()))
+	{
+		// Actor grip interface is checked after component
+		Cache.bActorHasInterface = true;
+		Cache.ActorTickNative = GetNativeGripInterfaceForEvent(actor, NAME_TickGrip);
+
+		if (!Cache.InterfaceObject)
+			Cache.InterfaceObject = actor;
+	}
+
+	CachedInteractionSettings.Remove(Grip.GrippedObject);
+
+	if (!Cache.InterfaceObject)
+		return;
+
+	IVRGripInterfaceNative * NativeInterface = GetNativeGripInterfaceForEvent(Cache.InterfaceObject, NAME_IsInteractible);
+	if (NativeInterface &&
+		GetNativeGripInterfaceForEvent(Cache.InterfaceObject, NAME_GetInteractionSettings) &&
+		GetNativeGripInterfaceForEvent(Cache.InterfaceObject, NAME_GripBreakDistance) &&
+		GetNativeGripInterfaceForEvent(Cache.InterfaceObject, NAME_SecondaryGripType))
+	{
+		// Native answers are cheap and always current, read them directly each tick
+		Cache.NativeInterface = NativeInterface;
+		return;
+	}
+
+	// Blueprint implemented, read them once now and hold onto them until marked dirty
+	Cache.bIsInteractible = IVRGripInterface::Execute_IsInteractible(Cache.InterfaceObject);
+	Cache.BreakDistance = IVRGripInterface::Execute_GripBreakDistance(Cache.InterfaceObject);
+	Cache.SecondaryGripType = IVRGripInterface::Execute_SecondaryGripType(Cache.InterfaceObject);
+
+	if (Cache.bIsInteractible)
+		CachedInteractionSettings.Add(Grip.GrippedObject, IVRGripInterface::Execute_GetInteractionSettings(Cache.InterfaceObject));
+}
+
+void UGripMotionControllerComponent::MarkGripInterfaceDirty(UObject * GrippedObject)
+{
+	if (!GrippedObject)
+		return;
+
+	for (FBPActorGripInformation & Grip : GrippedActors)
+	{
+		if (Grip == GrippedObject || Grip.InterfaceCache.InterfaceObject == GrippedObject)
+			Grip.InterfaceCache.bIsValid = false;
+	}
+
+	for (FBPActorGripInformation & Grip : LocallyGrippedActors)
+	{
+		if (Grip == GrippedObject || Grip.InterfaceCache.InterfaceObject == GrippedObject)
+			Grip.InterfaceCache.bIsValid = false;
 	}
 }
 
+void UGripMotionControllerComponent::SendTickGrip(const FBPActorGripInformation & Grip, UPrimitiveComponent * root, AActor * actor, const FVector & MotionControllerLocDelta, float DeltaTime)
+{
+	const FGripInterfaceCache & Cache = Grip.InterfaceCache;
+
+	if (Cache.bRootHasInterface)
+	{
+		if (Cache.RootTickNative)
+			Cache.RootTickNative->TickGrip_Native(this, Grip, MotionControllerLocDelta, DeltaTime);
+		else
+			IVRGripInterface::Execute_TickGrip(root, this, Grip, MotionControllerLocDelta, DeltaTime);
+	}
+
+	if (Cache.bActorHasInterface)
+	{
+		if (Cache.ActorTickNative)
+			Cache.ActorTickNative->TickGrip_Native(this, Grip, MotionControllerLocDelta, DeltaTime);
+		else
+			IVRGripInterface::Execute_TickGrip(actor, this, Grip, MotionControllerLocDelta, DeltaTime);
+	}
+}
 
-FTransform UGripMotionControllerComponent::HandleInteractionSettings(float DeltaTime, const FTransform & ParentTransform, UPrimitiveComponent * root, FBPInteractionSettings InteractionSettings, FBPActorGripInformation & GripInfo)
+FTransform UGripMotionControllerComponent::HandleInteractionSettings(float DeltaTime, const FTransform & ParentTransform, UPrimitiveComponent * root, const FBPInteractionSettings & InteractionSettings, FBPActorGripInformation & GripInfo)
 {
 	FTransform LocalTransform = GripInfo.RelativeTransform * GripInfo.AdditionTransform;
 	FTransform WorldTransform;
@@ -2824,15 +3282,16 @@ bool UGripMotionControllerComponent::DestroyPhysicsHandle(int32 SceneIndex, phys
 			check(*KinActorData);
 
 			// use correct scene
+			// Nothing queued can be applied to these once they are released
+			FGripPhysicsBatch::Get().RemovePending(SceneIndex, *KinActorData, *HandleData);
+
 			PxScene* PScene = GetPhysXSceneFromIndex(SceneIndex);
 			if (PScene)
 			{
 				SCOPED_SCENE_WRITE_LOCK(PScene);
-				// Destroy joint.
-				(*HandleData)->release();
 
-				// Destroy temporary actor.
-				(*KinActorData)->release();
+				// Joint and temporary actor go back to the pool to be reused by the next grip
+				FGripPhysicsHandlePool::Get().Release(SceneIndex, *KinActorData, *HandleData);
 
 			}
 			*KinActorData = NULL;
@@ -2849,18 +3308,17 @@ bool UGripMotionControllerComponent::DestroyPhysicsHandle(int32 SceneIndex, phys
 
 bool UGripMotionControllerComponent::DestroyPhysicsHandle(const FBPActorGripInformation &Grip)
 {
-	FBPActorPhysicsHandleInformation * HandleInfo = GetPhysicsGrip(Grip);
-
-	if (!HandleInfo)
+	int index;
+	if (!GetPhysicsGripIndex(Grip, index))
 	{
 		return true;
 	}
 
-	DestroyPhysicsHandle(HandleInfo->SceneIndex, &HandleInfo->HandleData, &HandleInfo->KinActorData);
+	FBPActorPhysicsHandleInformation & HandleInfo = PhysicsGrips[index];
+	DestroyPhysicsHandle(HandleInfo.SceneIndex, &HandleInfo.HandleData, &HandleInfo.KinActorData);
 
-	int index;
-	if (GetPhysicsGripIndex(Grip, index))
-		PhysicsGrips.RemoveAt(index);
+	RemovePhysicsGrip(index);
+	Grip.PhysicsHandle.Reset();
 
 	return true;
 }
@@ -2924,64 +3382,48 @@ bool UGripMotionControllerComponent::SetUpPhysicsHandle(const FBPActorGripInform
 		// If we don't already have a handle - make one now.
 		if (!HandleInfo->HandleData)
 		{
-			// Create kinematic actor we are going to create joint with. This will be moved around with calls to SetLocation/SetRotation.
-			PxRigidDynamic* KinActor = Scene->getPhysics().createRigidDynamic(KinPose);
-			KinActor->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, true);
-
-			KinActor->setMass(0.0f); // 1.0f;
-			KinActor->setMassSpaceInertiaTensor(PxVec3(0.0f, 0.0f, 0.0f));// PxVec3(1.0f, 1.0f, 1.0f));
-			KinActor->setMaxDepenetrationVelocity(PX_MAX_F32);
-
-			// No bodyinstance
-			KinActor->userData = NULL;
-
-			// Add to Scene
-			Scene->addActor(*KinActor);
-
-			// Save reference to the kinematic actor.
-			HandleInfo->KinActorData = KinActor;
-			PxD6Joint* NewJoint = NULL;
+			PxTransform TargetLocalPose;
 
 			if (NewGrip.GripCollisionType == EGripCollisionType::ManipulationGrip || NewGrip.GripCollisionType == EGripCollisionType::ManipulationGripWithWristTwist)
 			{
-				// Create the joint
-				NewJoint = PxD6JointCreate(Scene->getPhysics(), KinActor, PxTransform(PxIdentity), Actor, Actor->getGlobalPose().transformInv(KinPose));
+				TargetLocalPose = Actor->getGlobalPose().transformInv(KinPose);
 			}
 			else
 			{
 				HandleInfo->COMPosition = PxTransform( U2PVector(rBodyInstance->GetUnrealWorldTransform().InverseTransformPosition(rBodyInstance->GetCOMPosition())));
-				NewJoint = PxD6JointCreate(Scene->getPhysics(), KinActor, PxTransform(PxIdentity), Actor, /*PxTransform(PxIdentity)*/HandleInfo->COMPosition);
+				TargetLocalPose = HandleInfo->COMPosition;
 			}
 
+			// Remember the scene index that the handle joint/actor are in.
+			FPhysScene* RBScene = FPhysxUserData::Get<FPhysScene>(Scene->userData);
+			const uint32 SceneType = root->BodyInstance.UseAsyncScene(RBScene) ? PST_Async : PST_Sync;
+			HandleInfo->SceneIndex = RBScene->PhysXSceneIndex[SceneType];
+
+			// Kinematic actor we are going to create joint with. This will be moved around with calls to SetLocation/SetRotation.
+			// Both come out of the scenes handle pool so that grabbing doesn't insert new objects into the scene.
+			PxRigidDynamic* KinActor = NULL;
+			PxD6Joint* NewJoint = NULL;
+			FGripPhysicsHandlePool::Get().Acquire(Scene, HandleInfo->SceneIndex, Actor, KinPose, TargetLocalPose, KinActor, NewJoint);
+
+			// Save reference to the kinematic actor.
+			HandleInfo->KinActorData = KinActor;
+
 			if (!NewJoint)
 			{
 				HandleInfo->HandleData = 0;
 			}
 			else
 			{
-				// No constraint instance
-				NewJoint->userData = NULL;
 				HandleInfo->HandleData = NewJoint;
 
-				// Remember the scene index that the handle joint/actor are in.
-				FPhysScene* RBScene = FPhysxUserData::Get<FPhysScene>(Scene->userData);
-				const uint32 SceneType = root->BodyInstance.UseAsyncScene(RBScene) ? PST_Async : PST_Sync;
-				HandleInfo->SceneIndex = RBScene->PhysXSceneIndex[SceneType];
+				// Targets and drive changes for this handle are applied in batch before the scene ticks
+				FGripPhysicsBatch::Get().RegisterPhysScene(RBScene);
 
-				// Pretty Much Unbreakable
-				NewJoint->setBreakForce(PX_MAX_REAL, PX_MAX_REAL);
+				// Pooled joints come in unbreakable with every axis free and all drives zeroed
 
 				// Different settings for manip grip
 				if (NewGrip.GripCollisionType == EGripCollisionType::ManipulationGrip || NewGrip.GripCollisionType == EGripCollisionType::ManipulationGripWithWristTwist)
 				{
-					NewJoint->setMotion(PxD6Axis::eX, PxD6Motion::eFREE);
-					NewJoint->setMotion(PxD6Axis::eY, PxD6Motion::eFREE);
-					NewJoint->setMotion(PxD6Axis::eZ, PxD6Motion::eFREE);
-
-					NewJoint->setMotion(PxD6Axis::eTWIST, PxD6Motion::eFREE);
-					NewJoint->setMotion(PxD6Axis::eSWING1, PxD6Motion::eFREE);
-					NewJoint->setMotion(PxD6Axis::eSWING2, PxD6Motion::eFREE);
-
 					PxD6JointDrive drive;
 
 					if (NewGrip.AdvancedPhysicsSettings.bUseAdvancedPhysicsSettings && NewGrip.AdvancedPhysicsSettings.PhysicsConstraintType == EPhysicsGripConstraintType::ForceConstraint)
@@ -3041,14 +3483,6 @@ bool UGripMotionControllerComponent::SetUpPhysicsHandle(const FBPActorGripInform
 					}
 
 					// Setting up the joint
-					NewJoint->setMotion(PxD6Axis::eX, PxD6Motion::eFREE);
-					NewJoint->setMotion(PxD6Axis::eY, PxD6Motion::eFREE);
-					NewJoint->setMotion(PxD6Axis::eZ, PxD6Motion::eFREE);
-						
-					NewJoint->setMotion(PxD6Axis::eTWIST, PxD6Motion::eFREE);
-					NewJoint->setMotion(PxD6Axis::eSWING1, PxD6Motion::eFREE);
-					NewJoint->setMotion(PxD6Axis::eSWING2, PxD6Motion::eFREE);
-		
 					NewJoint->setDrivePosition(PxTransform(PxVec3(0, 0, 0)));
 
 					NewJoint->setDrive(PxD6Drive::eX, drive);
@@ -3078,6 +3512,9 @@ bool UGripMotionControllerComponent::SetGripConstraintStiffnessAndDamping(const
 #if WITH_PHYSX
 		if (Handle->HandleData != nullptr)
 		{
+			// Queued so that they are applied under the same scene lock as the kinematic targets
+			FGripPhysicsBatch & PhysicsBatch = FGripPhysicsBatch::Get();
+
 			// Different settings for manip grip
 			if (Grip->GripCollisionType == EGripCollisionType::ManipulationGrip || Grip->GripCollisionType == EGripCollisionType::ManipulationGripWithWristTwist)
 			{
@@ -3092,12 +3529,12 @@ bool UGripMotionControllerComponent::SetGripConstraintStiffnessAndDamping(const
 					drive = PxD6JointDrive(Grip->Stiffness, Grip->Damping, PX_MAX_F32, PxD6JointDriveFlag::eACCELERATION);
 				}
 
-				Handle->HandleData->setDrive(PxD6Drive::eX, drive);
-				Handle->HandleData->setDrive(PxD6Drive::eY, drive);
-				Handle->HandleData->setDrive(PxD6Drive::eZ, drive);
+				PhysicsBatch.QueueJointDrive(Handle->SceneIndex, Handle->HandleData, PxD6Drive::eX, drive);
+				PhysicsBatch.QueueJointDrive(Handle->SceneIndex, Handle->HandleData, PxD6Drive::eY, drive);
+				PhysicsBatch.QueueJointDrive(Handle->SceneIndex, Handle->HandleData, PxD6Drive::eZ, drive);
 
 				if (Grip->GripCollisionType == EGripCollisionType::ManipulationGripWithWristTwist)
-					Handle->HandleData->setDrive(PxD6Drive::eTWIST, drive);
+					PhysicsBatch.QueueJointDrive(Handle->SceneIndex, Handle->HandleData, PxD6Drive::eTWIST, drive);
 			}
 			else
 			{
@@ -3140,10 +3577,10 @@ bool UGripMotionControllerComponent::SetGripConstraintStiffnessAndDamping(const
 					Angledrive = PxD6JointDrive(AngularStiffness, AngularDamping, PX_MAX_F32, PxD6JointDriveFlag::eACCELERATION);
 				}
 
-				Handle->HandleData->setDrive(PxD6Drive::eX, drive);
-				Handle->HandleData->setDrive(PxD6Drive::eY, drive);
-				Handle->HandleData->setDrive(PxD6Drive::eZ, drive);
-				Handle->HandleData->setDrive(PxD6Drive::eSLERP, Angledrive);
+				PhysicsBatch.QueueJointDrive(Handle->SceneIndex, Handle->HandleData, PxD6Drive::eX, drive);
+				PhysicsBatch.QueueJointDrive(Handle->SceneIndex, Handle->HandleData, PxD6Drive::eY, drive);
+				PhysicsBatch.QueueJointDrive(Handle->SceneIndex, Handle->HandleData, PxD6Drive::eZ, drive);
+				PhysicsBatch.QueueJointDrive(Handle->SceneIndex, Handle->HandleData, PxD6Drive::eSLERP, Angledrive);
 			}
 		}
 #endif // WITH_PHYSX
@@ -3198,171 +3635,168 @@ void UGripMotionControllerComponent::UpdatePhysicsHandleTransform(const FBPActor
 		return;
 
 #if WITH_PHYSX
-	bool bChangedPosition = true;
-	bool bChangedRotation = true;
-
-	PxRigidDynamic* KinActor = HandleInfo->KinActorData;
-	PxScene* PScene = GetPhysXSceneFromIndex(HandleInfo->SceneIndex);
-	SCOPED_SCENE_WRITE_LOCK(PScene);
-	
-	// Check if the new location is worthy of change
-	PxVec3 PNewLocation = U2PVector(NewTransform.GetTranslation());
-	PxVec3 PCurrentLocation = KinActor->getGlobalPose().p;
-	if ((PNewLocation - PCurrentLocation).magnitudeSquared() <= 0.01f*0.01f)
-	{
-		PNewLocation = PCurrentLocation;
-		bChangedPosition = false;
-	}
+	FTransform terns = NewTransform;
+	PxTransform KinTarget;
 
-	// Check if the new rotation is worthy of change
-	PxQuat PNewOrientation = U2PQuat(NewTransform.GetRotation());
-	PxQuat PCurrentOrientation = KinActor->getGlobalPose().q;
-	if ((FMath::Abs(PNewOrientation.dot(PCurrentOrientation)) > (1.f - SMALL_NUMBER)))
+	if (GrippedActor.GripCollisionType == EGripCollisionType::ManipulationGrip || GrippedActor.GripCollisionType == EGripCollisionType::ManipulationGripWithWristTwist)
 	{
-		PNewOrientation = PCurrentOrientation;
-		bChangedRotation = false;
+		terns.SetLocation(this->GetComponentLocation());
+		KinTarget = U2PTransform(terns);
 	}
-	
-	// Don't call moveKinematic if it hasn't changed - that will stop bodies from going to sleep.
-	if (bChangedPosition || bChangedRotation)
+	else
 	{
-		FTransform terns = NewTransform;
+		USkeletalMeshComponent * skele = NULL;
 
-		if (GrippedActor.GripCollisionType == EGripCollisionType::ManipulationGrip || GrippedActor.GripCollisionType == EGripCollisionType::ManipulationGripWithWristTwist)
+		switch (GrippedActor.GripTargetType)
 		{
-			terns.SetLocation(this->GetComponentLocation());
-
-			KinActor->setKinematicTarget(PxTransform(U2PTransform(terns))/*PNewLocation, PNewOrientation*/);
-
-/*#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-
-				 DrawDebugSphere(GetWorld(), terns.GetLocation(), 4, 32, FColor::Cyan, false);
-				//DrawDebugSphere(GetWorld(), terns.GetLocation(), 4, 32, FColor::Cyan, false);
-#endif*/
-		}
-		else
+		case EGripTargetType::ComponentGrip:
 		{
-			USkeletalMeshComponent * skele = NULL;
-
-			switch (GrippedActor.GripTargetType)
-			{
-			case EGripTargetType::ComponentGrip:
-			{
-				skele = Cast<USkeletalMeshComponent>(GrippedActor.GetGrippedComponent());
-			}break;
-			case EGripTargetType::ActorGrip:
-			{
-				skele = Cast<USkeletalMeshComponent>(GrippedActor.GetGrippedActor()->GetRootComponent());
-			} break;
-			}
-
-			if (skele)
-			{
-				terns.ConcatenateRotation(skele->GetBoneTransform(0, FTransform::Identity).GetRotation());
-			}
-/*#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+			skele = Cast<USkeletalMeshComponent>(GrippedActor.GetGrippedComponent());
+		}break;
+		case EGripTargetType::ActorGrip:
+		{
+			skele = Cast<USkeletalMeshComponent>(GrippedActor.GetGrippedActor()->GetRootComponent());
+		} break;
+		}
 
-			DrawDebugSphere(GetWorld(), terns.GetLocation(), 4, 32, FColor::Cyan, false);
-			//DrawDebugSphere(GetWorld(), terns.GetLocation(), 4, 32, FColor::Cyan, false);
-#endif*/
-			KinActor->setKinematicTarget(PxTransform(U2PTransform(terns)) * HandleInfo->COMPosition/*PNewLocation, PNewOrientation*/);
+		if (skele)
+		{
+			terns.ConcatenateRotation(skele->GetBoneTransform(0, FTransform::Identity).GetRotation());
 		}
-		
 
+		KinTarget = U2PTransform(terns) * HandleInfo->COMPosition;
 	}
+
+	// Applied with every other physics grip in the scene right before it simulates, the batch also
+	// skips targets that haven't changed so that bodies can still go to sleep.
+	FGripPhysicsBatch::Get().QueueKinematicTarget(HandleInfo->SceneIndex, HandleInfo->KinActorData, KinTarget);
 #endif // WITH_PHYSX
 }
 
 bool UGripMotionControllerComponent::CheckComponentWithSweep(UPrimitiveComponent * ComponentToCheck, FVector Move, FRotator newOrientation, bool bSkipSimulatingComponents/*,  bool &bHadBlockingHitOut*/)
 {
-	TArray<FHitResult> Hits;
-	// WARNING: HitResult is only partially initialized in some paths. All data is valid only if bFilledHitResult is true.
-	FHitResult BlockingHit(NoInit);
-	BlockingHit.bBlockingHit = false;
-	BlockingHit.Time = 1.f;
-	bool bFilledHitResult = false;
-	bool bMoved = false;
-	bool bIncludesOverlapsAtEnd = false;
-	bool bRotationOnly = false;
-
 	UPrimitiveComponent *root = ComponentToCheck;
 
 	if (!root || !root->IsQueryCollisionEnabled())
 		return false;
 
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	if (!root->IsRegistered())
+	{
+		UE_LOG(LogVRMotionController, Warning, TEXT("MovedComponent %s not initialized in grip motion controller"), *root->GetFullName());
+	}
+#endif
+
+	INC_DWORD_STAT(STAT_SyncGripSweeps);
+
+	TArray<FHitResult> Hits;
 	FVector start(root->GetComponentLocation());
 
-	const bool bCollisionEnabled = root->IsQueryCollisionEnabled();
+	UWorld* const MyWorld = GetWorld();
+	FComponentQueryParams Params(TEXT("sweep_params"), root->GetOwner());
+
+	FCollisionResponseParams ResponseParam;
+	root->InitSweepCollisionParams(Params, ResponseParam);
+
+	bool const bHadBlockingHit = MyWorld->ComponentSweepMulti(Hits, root, start, start + Move, newOrientation.Quaternion(), Params);
+
+	if (!bHadBlockingHit)
+		return false;
+
+	return ProcessSweepHits(root, Hits, Move, bSkipSimulatingComponents);
+}
+
+bool UGripMotionControllerComponent::CheckComponentWithAsyncSweep(const FBPActorGripInformation & Grip, UPrimitiveComponent * root, const FVector & Move)
+{
+	UWorld* const MyWorld = GetWorld();
+
+	if (!root || !MyWorld)
+		return false;
+
+	bool bHadBlockingHit = false;
+	FGripAsyncSweep & PendingSweep = PendingGripSweeps.FindOrAdd(Grip.GrippedObject);
 
-	if (bCollisionEnabled)
+	// Consume the sweep queued last frame, if it is still in flight or got dropped we treat it as not colliding
+	FTraceDatum SweepData;
+	if (PendingSweep.Handle.IsValid() && MyWorld->QueryTraceData(PendingSweep.Handle, SweepData))
 	{
-#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-		if (!root->IsRegistered())
-		{
-			UE_LOG(LogVRMotionController, Warning, TEXT("MovedComponent %s not initialized in grip motion controller"), *root->GetFullName());
-		}
-#endif
+		bHadBlockingHit = SweepData.OutHits.Num() > 0 && ProcessSweepHits(root, SweepData.OutHits, PendingSweep.Move, false);
+	}
+
+	PendingSweep.Handle = FTraceHandle();
+
+	if (!root->IsQueryCollisionEnabled())
+		return bHadBlockingHit;
+
+	FComponentQueryParams Params(TEXT("sweep_params"), root->GetOwner());
+
+	FCollisionResponseParams ResponseParam;
+	root->InitSweepCollisionParams(Params, ResponseParam);
 
-		UWorld* const MyWorld = GetWorld();
-		FComponentQueryParams Params(TEXT("sweep_params"), root->GetOwner());
+	// Unlike ComponentSweepMulti this sweeps the roots bounding collision shape, unrotated, rather than every body it has
+	const FVector Start(root->GetComponentLocation());
+	PendingSweep.Handle = MyWorld->AsyncSweepByChannel(EAsyncTraceType::Multi, Start, Start + Move, root->GetCollisionObjectType(), root->GetCollisionShape(), Params, ResponseParam);
+	PendingSweep.Move = Move;
 
-		FCollisionResponseParams ResponseParam;
-		root->InitSweepCollisionParams(Params, ResponseParam);
+	INC_DWORD_STAT(STAT_AsyncGripSweepsQueued);
+	return bHadBlockingHit;
+}
+
+bool UGripMotionControllerComponent::ProcessSweepHits(UPrimitiveComponent * root, TArray<FHitResult> & Hits, const FVector & Move, bool bSkipSimulatingComponents)
+{
+	// WARNING: HitResult is only partially initialized in some paths. All data is valid only if bFilledHitResult is true.
+	FHitResult BlockingHit(NoInit);
+	BlockingHit.bBlockingHit = false;
+	BlockingHit.Time = 1.f;
+	bool bFilledHitResult = false;
 
-		bool const bHadBlockingHit = MyWorld->ComponentSweepMulti(Hits, root, start, start + Move, newOrientation.Quaternion(), Params);
+	int32 BlockingHitIndex = INDEX_NONE;
+	float BlockingHitNormalDotDelta = BIG_NUMBER;
+	for (int32 HitIdx = 0; HitIdx < Hits.Num(); HitIdx++)
+	{
+		const FHitResult& TestHit = Hits[HitIdx];
 
-		if (bHadBlockingHit)
+		// Ignore the owning actor to the motion controller
+		if (TestHit.Actor == this->GetOwner() || (bSkipSimulatingComponents && TestHit.Component.IsValid() && TestHit.Component->IsSimulatingPhysics()))
 		{
-			int32 BlockingHitIndex = INDEX_NONE;
-			float BlockingHitNormalDotDelta = BIG_NUMBER;
-			for (int32 HitIdx = 0; HitIdx < Hits.Num(); HitIdx++)
+			if (Hits.Num() == 1)
 			{
-				const FHitResult& TestHit = Hits[HitIdx];
-
-				// Ignore the owning actor to the motion controller
-				if (TestHit.Actor == this->GetOwner() || (bSkipSimulatingComponents && TestHit.Component->IsSimulatingPhysics()))
-				{
-					if (Hits.Num() == 1)
-					{
-						//bHadBlockingHitOut = false;
-						return false;
-					}
-					else
-						continue;
-				}
+				//bHadBlockingHitOut = false;
+				return false;
+			}
+			else
+				continue;
+		}
 
-				if (TestHit.bBlockingHit && TestHit.IsValidBlockingHit())
+		if (TestHit.bBlockingHit && TestHit.IsValidBlockingHit())
+		{
+			if (TestHit.Time == 0.f)
+			{
+				// We may have multiple initial hits, and want to choose the one with the normal most opposed to our movement.
+				const float NormalDotDelta = (TestHit.ImpactNormal | Move);
+				if (NormalDotDelta < BlockingHitNormalDotDelta)
 				{
-					if (TestHit.Time == 0.f)
-					{
-						// We may have multiple initial hits, and want to choose the one with the normal most opposed to our movement.
-						const float NormalDotDelta = (TestHit.ImpactNormal | Move);
-						if (NormalDotDelta < BlockingHitNormalDotDelta)
-						{
-							BlockingHitNormalDotDelta = NormalDotDelta;
-							BlockingHitIndex = HitIdx;
-						}
-					}
-					else if (BlockingHitIndex == INDEX_NONE)
-					{
-						// First non-overlapping blocking hit should be used, if an overlapping hit was not.
-						// This should be the only non-overlapping blocking hit, and last in the results.
-						BlockingHitIndex = HitIdx;
-						break;
-					}
-					//}
+					BlockingHitNormalDotDelta = NormalDotDelta;
+					BlockingHitIndex = HitIdx;
 				}
 			}
-
-			// Update blocking hit, if there was a valid one.
-			if (BlockingHitIndex >= 0)
+			else if (BlockingHitIndex == INDEX_NONE)
 			{
-				BlockingHit = Hits[BlockingHitIndex];
-				bFilledHitResult = true;
+				// First non-overlapping blocking hit should be used, if an overlapping hit was not.
+				// This should be the only non-overlapping blocking hit, and last in the results.
+				BlockingHitIndex = HitIdx;
+				break;
 			}
 		}
 	}
 
+	// Update blocking hit, if there was a valid one.
+	if (BlockingHitIndex >= 0)
+	{
+		BlockingHit = Hits[BlockingHitIndex];
+		bFilledHitResult = true;
+	}
+
 	// Handle blocking hit notifications. Avoid if pending kill (which could happen after overlaps).
 	if (BlockingHit.bBlockingHit && !root->IsPendingKill())
 	{
@@ -3390,36 +3824,29 @@ bool UGripMotionControllerComponent::PollControllerState(FVector& Position, FRot
 {
 	if ((PlayerIndex != INDEX_NONE) && bHasAuthority)
 	{
-		// New iteration and retrieval for 4.12
-		TArray<IMotionController*> MotionControllers = IModularFeatures::Get().GetModularFeatureImplementations<IMotionController>(IMotionController::GetModularFeatureName());
-		for (auto MotionController : MotionControllers)
+		if (PollMotionControllers(PlayerIndex, Hand, Position, Orientation, WorldToMetersScale, CurrentTrackingStatus))
 		{
-			if ((MotionController != nullptr) && MotionController->GetControllerOrientationAndPosition(PlayerIndex, Hand, Orientation, Position, WorldToMetersScale))
+			if (bOffsetByHMD)
 			{
-				CurrentTrackingStatus = (ETrackingStatus)MotionController->GetControllerTrackingStatus(PlayerIndex, Hand);
-				
-				if (bOffsetByHMD)
+				if (IsInGameThread())
 				{
-					if (IsInGameThread())
+					if (GEngine->HMDDevice.IsValid() && GEngine->HMDDevice->IsHeadTrackingAllowed() && GEngine->HMDDevice->HasValidTrackingPosition())
 					{
-						if (GEngine->HMDDevice.IsValid() && GEngine->HMDDevice->IsHeadTrackingAllowed() && GEngine->HMDDevice->HasValidTrackingPosition())
-						{
-							FQuat curRot;
-							FVector curLoc;
-							GEngine->HMDDevice->GetCurrentOrientationAndPosition(curRot, curLoc);
-							curLoc.Z = 0;
+						FQuat curRot;
+						FVector curLoc;
+						GEngine->HMDDevice->GetCurrentOrientationAndPosition(curRot, curLoc);
+						curLoc.Z = 0;
 
-							LastLocationForLateUpdate = curLoc;
-						}
-						else
-							LastLocationForLateUpdate = FVector::ZeroVector;
+						LastLocationForLateUpdate = curLoc;
 					}
-
-					Position -= LastLocationForLateUpdate;
+					else
+						LastLocationForLateUpdate = FVector::ZeroVector;
 				}
-							
-				return true;
+
+				Position -= LastLocationForLateUpdate;
 			}
+
+			return true;
 		}
 	}
 	return false;
@@ -3428,15 +3855,20 @@ bool UGripMotionControllerComponent::PollControllerState(FVector& Position, FRot
 //=============================================================================
 void UGripMotionControllerComponent::FViewExtension::PreRenderViewFamily_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneViewFamily& InViewFamily)
 {
-	if (!MotionControllerComponent)
+	// Nothing new was gathered for this frame (late updates disabled or the component is gone)
+	if (!(ReadySnapshotIndex & LATE_UPDATE_SNAPSHOT_FRESH))
 	{
+		INC_DWORD_STAT(STAT_LateUpdateNoNewSnapshot);
 		return;
 	}
 
-	FScopeLock ScopeLock(&CritSect);
+	ReadSnapshotIndex = FPlatformAtomics::InterlockedExchange(&ReadySnapshotIndex, ReadSnapshotIndex) & LATE_UPDATE_SNAPSHOT_INDEX_MASK;
+	LateUpdateSnapshot & Snapshot = Snapshots[ReadSnapshotIndex];
+
+	SCOPE_CYCLE_COUNTER(STAT_LateUpdateRenderThread);
 
 	static const auto CVarEnableMotionControllerLateUpdate = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("vr.EnableMotionControllerLateUpdate"));
-	if (MotionControllerComponent->bDisableLowLatencyUpdate || !CVarEnableMotionControllerLateUpdate->GetValueOnRenderThread())
+	if (!Snapshot.bCanPoll || !Snapshot.Primitives.Num() || !CVarEnableMotionControllerLateUpdate->GetValueOnRenderThread())
 	{
 		return;
 	}
@@ -3445,7 +3877,7 @@ void UGripMotionControllerComponent::FViewExtension::PreRenderViewFamily_RenderT
 	float WorldToMetersScale = -1.0f;
 	for (const FSceneView* SceneView : InViewFamily.Views)
 	{
-		if (SceneView && SceneView->PlayerIndex == MotionControllerComponent->PlayerIndex)
+		if (SceneView && SceneView->PlayerIndex == Snapshot.PlayerIndex)
 		{
 			WorldToMetersScale = SceneView->WorldToMetersScale;
 			break;
@@ -3461,37 +3893,42 @@ void UGripMotionControllerComponent::FViewExtension::PreRenderViewFamily_RenderT
 	// Poll state for the most recent controller transform
 	FVector Position;
 	FRotator Orientation;
+	ETrackingStatus TrackingStatus;
 
-	if (!MotionControllerComponent->PollControllerState(Position, Orientation, WorldToMetersScale))
+	if (!PollMotionControllers(Snapshot.PlayerIndex, Snapshot.Hand, Position, Orientation, WorldToMetersScale, TrackingStatus))
 	{
 		return;
 	}
 
-	if (LateUpdatePrimitives.Num())
+	if (Snapshot.bOffsetByHMD)
 	{
-		// Calculate the late update transform that will rebase all children proxies within the frame of reference
+		Position -= Snapshot.HMDOffset;
+	}
 
-		FTransform OldLocalToWorldTransform =  MotionControllerComponent->CalcNewComponentToWorld(MotionControllerComponent->RenderThreadRelativeTransform/*MotionControllerComponent->GetRelativeTransform()*/);
-		FTransform NewLocalToWorldTransform =  MotionControllerComponent->CalcNewComponentToWorld(FTransform(Orientation, Position, MotionControllerComponent->RenderThreadComponentScale));
-		FMatrix LateUpdateTransform = (OldLocalToWorldTransform.Inverse() * NewLocalToWorldTransform).ToMatrixWithScale();
+	// Calculate the late update transform that will rebase all children proxies within the frame of reference
+	FTransform OldLocalToWorldTransform = Snapshot.OldComponentToWorld;
+	FTransform NewLocalToWorldTransform = Snapshot.CalcNewComponentToWorld(FTransform(Orientation, Position, Snapshot.ComponentScale));
+	FMatrix LateUpdateTransform = (OldLocalToWorldTransform.Inverse() * NewLocalToWorldTransform).ToMatrixWithScale();
 
-		FPrimitiveSceneInfo* RetrievedSceneInfo;
-		FPrimitiveSceneInfo* CachedSceneInfo;
+	FPrimitiveSceneInfo* RetrievedSceneInfo;
+	FPrimitiveSceneInfo* CachedSceneInfo;
 		
-		// Apply delta to the affected scene proxies
-		for (auto PrimitiveInfo : LateUpdatePrimitives)
-		{
-			RetrievedSceneInfo = InViewFamily.Scene->GetPrimitiveSceneInfo(*PrimitiveInfo.IndexAddress);
-			CachedSceneInfo = PrimitiveInfo.SceneInfo;
+	// Apply delta to the affected scene proxies
+	for (const LateUpdatePrimitiveInfo & PrimitiveInfo : Snapshot.Primitives)
+	{
+		RetrievedSceneInfo = InViewFamily.Scene->GetPrimitiveSceneInfo(*PrimitiveInfo.IndexAddress);
+		CachedSceneInfo = PrimitiveInfo.SceneInfo;
 
-			// If the retrieved scene info is different than our cached scene info then the primitive was removed from the scene
-			if (CachedSceneInfo == RetrievedSceneInfo && CachedSceneInfo->Proxy)
-			{
-				CachedSceneInfo->Proxy->ApplyLateUpdateTransform(LateUpdateTransform);
-			}
+		// If the retrieved scene info is different than our cached scene info then the primitive was removed from the scene
+		if (CachedSceneInfo == RetrievedSceneInfo && CachedSceneInfo->Proxy)
+		{
+			CachedSceneInfo->Proxy->ApplyLateUpdateTransform(LateUpdateTransform);
+		}
+		else
+		{
+			// Has the game thread gather again, a recreated proxy would otherwise never be late updated
+			FPlatformAtomics::InterlockedExchange(&bFoundStaleLateUpdatePrimitive, 1);
 		}
-
-		LateUpdatePrimitives.Reset();
 	}
 }
 
@@ -3501,17 +3938,18 @@ void UGripMotionControllerComponent::FViewExtension::GatherLateUpdatePrimitives(
 		return;
 
 	// If a scene proxy is present, cache it
-	UPrimitiveComponent* PrimitiveComponent = dynamic_cast<UPrimitiveComponent*>(Component);
-	if (PrimitiveComponent && PrimitiveComponent->SceneProxy)
+	UPrimitiveComponent* PrimitiveComponent = Cast<UPrimitiveComponent>(Component);
+	FPrimitiveSceneInfo* PrimitiveSceneInfo = (PrimitiveComponent && PrimitiveComponent->SceneProxy) ? PrimitiveComponent->SceneProxy->GetPrimitiveSceneInfo() : nullptr;
+	if (PrimitiveSceneInfo)
 	{
-		FPrimitiveSceneInfo* PrimitiveSceneInfo = PrimitiveComponent->SceneProxy->GetPrimitiveSceneInfo();
-		if (PrimitiveSceneInfo)
-		{
-			LateUpdatePrimitiveInfo PrimitiveInfo;
-			PrimitiveInfo.IndexAddress = PrimitiveSceneInfo->GetIndexAddress();
-			PrimitiveInfo.SceneInfo = PrimitiveSceneInfo;
-			Primitives.Add(PrimitiveInfo);
-		}
+		LateUpdatePrimitiveInfo PrimitiveInfo;
+		PrimitiveInfo.IndexAddress = PrimitiveSceneInfo->GetIndexAddress();
+		PrimitiveInfo.SceneInfo = PrimitiveSceneInfo;
+		Primitives.Add(PrimitiveInfo);
+	}
+	else if (PrimitiveComponent)
+	{
+		CachedProxylessPrimitives.Add(PrimitiveComponent);
 	}
 
 	// Gather children proxies
@@ -3608,23 +4046,28 @@ void UGripMotionControllerComponent::Server_NotifyLocalGripAddedOrChanged_Implem
 		return;
 	}
 
-	if (!LocallyGrippedActors.Contains(newGrip))
+	int32 FoundIndex = 0;
+	bool bIsLocalGrip = false;
+	FBPActorGripInformation * FoundGrip = FindGripByObject(newGrip.GrippedObject, &FoundIndex, &bIsLocalGrip);
+
+	if (!FoundGrip)
 	{
 		LocallyGrippedActors.Add(newGrip);
+		RebuildGripIndex();
 
 		// Initialize the differences, clients will do this themselves on the rep back, this sets up the cache
 		HandleGripReplication(LocallyGrippedActors[LocallyGrippedActors.Num() - 1]);
 	}
+	else if (bIsLocalGrip)
+	{
+		// Used to be applied to a copy of the grip and lost
+		*FoundGrip = newGrip;
+	}
 	else
 	{
-		FBPActorGripInformation FoundGrip;
-		EBPVRResultSwitch Result;
-		GetGripByObject(FoundGrip, newGrip.GrippedObject, Result);
-
-		if (Result == EBPVRResultSwitch::OnFailed)
-			return;
-
-		FoundGrip = newGrip;
+		// Held by a server authoritative grip, the client doesn't get to overwrite it
+		Client_NotifyInvalidLocalGrip(newGrip.GrippedObject);
+		return;
 	}
 
 	// Server has to call this themselves
@@ -3677,10 +4120,13 @@ void UGripMotionControllerComponent::Server_NotifySecondaryAttachmentChanged_Imp
 	if (!GrippedObject)
 		return;
 
-	for (FBPActorGripInformation & Grip : LocallyGrippedActors)
+	int32 FoundIndex = 0;
+	bool bIsLocalGrip = false;
+	if (FBPActorGripInformation * FoundGrip = FindGripByObject(GrippedObject, &FoundIndex, &bIsLocalGrip))
 	{
-		if (Grip == GrippedObject)
+		if (bIsLocalGrip)
 		{
+			FBPActorGripInformation & Grip = *FoundGrip;
 			Grip.bHasSecondaryAttachment = bHasSecondaryAttachment;
 			Grip.SecondaryAttachment = SecondaryAttachment;
 			Grip.SecondarySmoothingScaler = SecondarySmoothingScaler;
@@ -3689,7 +4135,6 @@ void UGripMotionControllerComponent::Server_NotifySecondaryAttachmentChanged_Imp
 
 			// Initialize the differences, clients will do this themselves on the rep back
 			HandleGripReplication(Grip);
-			break;
 		}
 	}
 
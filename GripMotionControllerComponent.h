@@ -8,6 +8,7 @@
 #include "SceneViewExtension.h"
 #include "VRBPDatatypes.h"
 #include "VRGripInterface.h"
+#include "VRPoseSnapshotBuffer.h"
 
 #include "GripMotionControllerComponent.generated.h"
 
@@ -19,6 +20,59 @@ DECLARE_LOG_CATEGORY_EXTERN(LogVRMotionController, Log, All);
 //For UE4 Profiler ~ Stat Group
 DECLARE_STATS_GROUP(TEXT("TICKGrip"), STATGROUP_TickGrip, STATCAT_Advanced);
 
+// Slot of a gripped object in one of the controllers grip arrays
+struct FGripIndexEntry
+{
+	int32 Index;
+	bool bIsLocalGrip;
+
+	FGripIndexEntry(int32 InIndex, bool bInIsLocalGrip) :
+		Index(InIndex),
+		bIsLocalGrip(bInIsLocalGrip)
+	{}
+};
+
+// An in flight asynchronous sweep of a SweepWithPhysics grip, results are read back the frame after it was queued
+struct FGripAsyncSweep
+{
+	FTraceHandle Handle;
+	FVector Move;
+
+	FGripAsyncSweep() :
+		Move(FVector::ZeroVector)
+	{}
+};
+
+// The interface answers a grip world transform depends on, read on the game thread so the math itself can run anywhere
+struct FGripInterfaceAnswers
+{
+	bool bIsInteractible;
+	FBPInteractionSettings InteractionSettings;
+	ESecondaryGripType SecondaryGripType;
+
+	FGripInterfaceAnswers() :
+		bIsInteractible(false),
+		SecondaryGripType(ESecondaryGripType::SG_None)
+	{}
+};
+
+// A grip world transform computed ahead of the apply loop, GrippedObject is null if the grip wasn't precomputed
+struct FPrecomputedGripTransform
+{
+	const UObject * GrippedObject;
+	UPrimitiveComponent * Root;
+	AActor * Actor;
+	FGripInterfaceAnswers Answers;
+	FTransform WorldTransform;
+	bool bRescalePhysicsGrips;
+
+	FPrecomputedGripTransform() :
+		GrippedObject(nullptr),
+		Root(nullptr),
+		Actor(nullptr),
+		bRescalePhysicsGrips(false)
+	{}
+};
 
 
 UCLASS(Blueprintable, meta = (BlueprintSpawnableComponent), ClassGroup = MotionController)
@@ -66,19 +120,33 @@ private:
 	// Custom version of the component sweep function to remove that aggravating warning epic is throwing about skeletal mesh components.
 	void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
 	virtual void OnUnregister() override;
+	virtual void PostInitProperties() override;
 
 protected:
 	//~ Begin UActorComponent Interface.
 	virtual void SendRenderTransform_Concurrent() override;
 	//~ End UActorComponent Interface.
 
+	// Invalidate the late update caches, children are late updated with the controller
+	virtual void OnChildAttached(USceneComponent* ChildComponent) override;
+	virtual void OnChildDetached(USceneComponent* ChildComponent) override;
+	virtual void OnVisibilityChanged() override;
+
 	FTransform RenderThreadRelativeTransform;
 	FVector RenderThreadComponentScale;
 
 public:
 
+	// Delta replicated, grips edited in place on the server have to be flagged with GrippedActors.MarkGripDirty
 	UPROPERTY(BlueprintReadOnly, Replicated, Category = "VRGrip", ReplicatedUsing = OnRep_GrippedActors)
-	TArray<FBPActorGripInformation> GrippedActors;
+	FBPGripList GrippedActors;
+
+	// The replicated grips as a plain array, blueprints that read GrippedActors back when it was a TArray should use this
+	UFUNCTION(BlueprintPure, Category = "VRGrip")
+	const TArray<FBPActorGripInformation> & GetGrippedActorsArray() const
+	{
+		return GrippedActors.Items;
+	}
 
 	UPROPERTY(BlueprintReadOnly, Replicated, Category = "VRGrip", ReplicatedUsing = OnRep_LocallyGrippedActors)
 	TArray<FBPActorGripInformation> LocallyGrippedActors;
@@ -124,7 +192,7 @@ public:
 		if (GetPhysicsGripIndex(GripInfo, HandleIndex))
 		{
 			DestroyPhysicsHandle(PhysicsGrips[HandleIndex].SceneIndex, &PhysicsGrips[HandleIndex].HandleData, &PhysicsGrips[HandleIndex].KinActorData);
-			PhysicsGrips.RemoveAt(HandleIndex);
+			RemovePhysicsGrip(HandleIndex);
 		}
 
 		// Grip Type or replication was changed
@@ -132,38 +200,66 @@ public:
 	}
 
 	UFUNCTION()
-	virtual void OnRep_GrippedActors(/*TArray<FBPActorGripInformation> OriginalArrayState*/) // Original array state is useless without full serialize, it just hold last delta
+	virtual void OnRep_GrippedActors()
 	{
-		// Need to think about how best to handle the simulating flag here, don't handle for now
-		// Check for removed gripped actors
-		// This might actually be better left as an RPC multicast
-
-		for (FBPActorGripInformation & Grip : GrippedActors)
-		{
-			HandleGripReplication(Grip);
-		}
+		// Only the grips that the fast array callbacks flagged get handled, not the whole array
+		RebuildGripIndex();
+		HandlePendingGripReplication();
 	}
 
+	// Filled in by the GrippedActors item callbacks, the array can't be touched while it is being received so the
+	// grips are handled in OnRep_GrippedActors instead. Changed grips are kept by object as their index can move.
+	TArray<UObject *> PendingRepGrips;
+	TArray<FBPActorGripInformation> PendingRepDrops;
+
+	void HandlePendingGripReplication();
+
 	UFUNCTION()
 	virtual void OnRep_LocallyGrippedActors()
 	{
+		RebuildGripIndex();
+		PruneGripValueCaches();
+
 		for (FBPActorGripInformation & Grip : LocallyGrippedActors)
 		{
 			HandleGripReplication(Grip);
 		}
 	}
 
+	// Gripped object to its slot in GrippedActors / LocallyGrippedActors, rebuilt whenever either array changes.
+	TMap<const UObject *, FGripIndexEntry> GripIndex;
+	int32 GripIndexNumReplicated;
+	int32 GripIndexNumLocal;
+
+	// Rebuilds GripIndex and this controllers entries in the global held object map
+	void RebuildGripIndex();
+
+	// Finds the grip for an object without searching the arrays, OutIndex and bOutIsLocalGrip give its slot
+	FBPActorGripInformation * FindGripByObject(const UObject * ObjectToLookForGrip, int32 * OutIndex = nullptr, bool * bOutIsLocalGrip = nullptr);
+
+	// Replication diff caches, keyed by the gripped object. Kept off of the grip struct so that the tick doesn't drag them through cache.
+	TMap<const UObject *, FGripValueCache> GripValueCaches;
+
+	// Removes caches for objects that are no longer in either grip array
+	void PruneGripValueCaches();
+
 	FORCEINLINE_DEBUGGABLE void HandleGripReplication(FBPActorGripInformation & Grip)
 	{
-		if (!Grip.ValueCache.bWasInitiallyRepped) // Hasn't already been initialized
+		if (!Grip.GrippedObject)
+			return;
+
+		// Copied out, the grip callbacks below can add or remove caches and invalidate a reference into the map
+		FGripValueCache ValueCache = GripValueCaches.FindOrAdd(Grip.GrippedObject);
+
+		if (!ValueCache.bWasInitiallyRepped) // Hasn't already been initialized
 		{
+			GripValueCaches[Grip.GrippedObject].bWasInitiallyRepped = true; // Set has been initialized
 			NotifyGrip(Grip); // Grip it
-			Grip.ValueCache.bWasInitiallyRepped = true; // Set has been initialized
 		}
 		else // Check for changes from cached information
 		{
 			// Manage lerp states
-			if (Grip.ValueCache.bCachedHasSecondaryAttachment != Grip.bHasSecondaryAttachment || Grip.ValueCache.CachedSecondaryRelativeLocation != Grip.SecondaryRelativeLocation)
+			if (ValueCache.bCachedHasSecondaryAttachment != Grip.bHasSecondaryAttachment || ValueCache.CachedSecondaryRelativeLocation != Grip.SecondaryRelativeLocation)
 			{
 				if (FMath::IsNearlyZero(Grip.LerpToRate)) // Zero, could use IsNearlyZero instead
 					Grip.GripLerpState = EGripLerpState::NotLerping;
@@ -199,34 +295,52 @@ public:
 				}
 			}
 
-			if (Grip.ValueCache.CachedGripCollisionType != Grip.GripCollisionType ||
-				Grip.ValueCache.CachedGripMovementReplicationSetting != Grip.GripMovementReplicationSetting)
+			if (ValueCache.CachedGripCollisionType != Grip.GripCollisionType ||
+				ValueCache.CachedGripMovementReplicationSetting != Grip.GripMovementReplicationSetting)
 			{
 				ReCreateGrip(Grip);
 			}
 			else // If re-creating the grip anyway we don't need to do the below
 			{
 				// If the stiffness and damping got changed server side
-				if ( !FMath::IsNearlyEqual(Grip.ValueCache.CachedStiffness, Grip.Stiffness) || !FMath::IsNearlyEqual(Grip.ValueCache.CachedDamping, Grip.Damping) || Grip.ValueCache.CachedAdvancedPhysicsSettings != Grip.AdvancedPhysicsSettings)
+				if ( !FMath::IsNearlyEqual(ValueCache.CachedStiffness, Grip.Stiffness) || !FMath::IsNearlyEqual(ValueCache.CachedDamping, Grip.Damping) || ValueCache.CachedAdvancedPhysicsSettings != Grip.AdvancedPhysicsSettings)
 				{
 					SetGripConstraintStiffnessAndDamping(&Grip);
 				}
 			}
 		}
 
-		// Set caches now for next rep
-		Grip.ValueCache.bCachedHasSecondaryAttachment = Grip.bHasSecondaryAttachment;
-		Grip.ValueCache.CachedSecondaryRelativeLocation = Grip.SecondaryRelativeLocation;
-		Grip.ValueCache.CachedGripCollisionType = Grip.GripCollisionType;
-		Grip.ValueCache.CachedGripMovementReplicationSetting = Grip.GripMovementReplicationSetting;
-		Grip.ValueCache.CachedStiffness = Grip.Stiffness;
-		Grip.ValueCache.CachedDamping = Grip.Damping;
-		Grip.ValueCache.CachedAdvancedPhysicsSettings = Grip.AdvancedPhysicsSettings;
+		// Set caches now for next rep, if the grip was dropped during the callbacks then there is nothing left to cache
+		FGripValueCache * NewCache = GripValueCaches.Find(Grip.GrippedObject);
+		if (!NewCache)
+			return;
+
+		NewCache->bCachedHasSecondaryAttachment = Grip.bHasSecondaryAttachment;
+		NewCache->CachedSecondaryRelativeLocation = Grip.SecondaryRelativeLocation;
+		NewCache->CachedGripCollisionType = Grip.GripCollisionType;
+		NewCache->CachedGripMovementReplicationSetting = Grip.GripMovementReplicationSetting;
+		NewCache->CachedStiffness = Grip.Stiffness;
+		NewCache->CachedDamping = Grip.Damping;
+		NewCache->CachedAdvancedPhysicsSettings = Grip.AdvancedPhysicsSettings;
 	}
 
 	UPROPERTY(BlueprintReadWrite, Category = "VRGrip")
 	TArray<UPrimitiveComponent *> AdditionalLateUpdateComponents;
 
+	// The late update primitives are cached between frames and rebuilt when grips are added or removed, when the controller
+	// or a grippable component has children attached, detached or shown, and when a cached scene proxy goes away.
+	// Call this after attaching, detaching or showing components under other components that are late updated.
+	UFUNCTION(BlueprintCallable, Category = "VRGrip")
+	void MarkLateUpdatePrimitivesDirty();
+
+	// Invalidates the late update caches of every controller, called by the VR components on hierarchy changes. Any thread.
+	static void NotifyLateUpdateHierarchyChanged()
+	{
+		LateUpdateHierarchySerial.Increment();
+	}
+
+	static FThreadSafeCounter LateUpdateHierarchySerial;
+
 	//  Movement Replication
 	// Actor needs to be replicated for this to work
 
@@ -244,7 +358,11 @@ public:
 	{
 		//ReplicatedControllerTransform.Unpack();
 
-		if (bSmoothReplicatedMotion)
+		if (bSmoothReplicatedMotion && ReplicatedMotionSmoothing.bUseSnapshotInterpolation)
+		{
+			ReplicatedPoseBuffer.AddSnapshot(ReplicatedControllerTransform.Position, ReplicatedControllerTransform.Rotation, GetWorld()->GetRealTimeSeconds(), ReplicatedMotionSmoothing);
+		}
+		else if (bSmoothReplicatedMotion)
 		{
 			bLerpingPosition = true;
 			ControllerNetUpdateCount = 0.0f;
@@ -266,6 +384,13 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "GripMotionController|Networking")
 		bool bSmoothReplicatedMotion;
 
+	// How the replicated motion is smoothed when bSmoothReplicatedMotion is on
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GripMotionController|Networking")
+		FBPVRPoseSmoothingSettings ReplicatedMotionSmoothing;
+
+	// Received poses of a remote controller, sampled in the tick when using snapshot interpolation
+	FVRPoseSnapshotBuffer ReplicatedPoseBuffer;
+
 	// Whether to replicate even if no tracking (FPS or test characters)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "GripMotionController|Networking")
 		bool bReplicateWithoutTracking;
@@ -274,6 +399,26 @@ public:
 	UFUNCTION(Unreliable, Server, WithValidation)
 	void Server_SendControllerTransform(FBPVRComponentPosRep NewTransform);
 
+	// Set by an owning AVRBaseCharacter that sends this controllers transform in its tracked pose packet instead
+	bool bTransformSentByOwner;
+
+	// Applies a transform received on the server, either from our own RPC or from the owners tracked pose packet
+	void ReceiveControllerTransform(const FBPVRComponentPosRep & NewTransform);
+
+	// When the owning client sends this controllers transform, ControllerNetUpdateRate is the rate used while moving fast
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GripMotionController|Networking")
+		FBPVRAdaptiveSendSettings AdaptiveSendSettings;
+
+	FVRPoseSendScheduler PoseSendScheduler;
+
+	// Baseline state for ReplicatedControllerTransform.bDeltaEncodePosition, the sender lives on the owning client and the receiver on the server
+	FVRPoseBaselineSender PoseBaselineSender;
+	FVRPoseBaselineReceiver PoseBaselineReceiver;
+
+	// Server acking a position keyframe so the client can start sending deltas against it
+	UFUNCTION(Unreliable, Client)
+	void Client_AckPoseBaseline(uint8 BaselineIndex);
+
 	// Need this as I can't think of another way for an actor component to make sure it isn't on the server
 	FORCEINLINE bool IsLocallyControlled() const
 	{
@@ -423,6 +568,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "VRGrip", meta = (ExpandEnumAsExecs = "Result"))
 	void GetGripByObject(FBPActorGripInformation &Grip, UObject * ObjectToLookForGrip, EBPVRResultSwitch &Result);
 
+	// Get every grip controller that is currently holding an object, doesn't have to check each controller
+	UFUNCTION(BlueprintCallable, Category = "VRGrip")
+		static void GetControllersHoldingObject(UObject * HeldObject, TArray<UGripMotionControllerComponent *> &HoldingControllers);
+
 	// Get the physics velocities of a grip
 	UFUNCTION(BlueprintPure, Category = "VRGrip")
 		void GetPhysicsVelocities(const FBPActorGripInformation &Grip, FVector &AngularVelocity, FVector &LinearVelocity);
@@ -492,11 +641,75 @@ public:
 	// Splitting logic into seperate function
 	void HandleGripArray(TArray<FBPActorGripInformation> &GrippedObjects, const FTransform & ParentTransform, const FVector &MotionControllerLocDelta, float DeltaTime, bool bReplicatedArray = false);
 
+	// Computes the world transforms of the arrays grips across worker threads ahead of HandleGripArray moving them,
+	// returns false if the array is under vr.GripParallelComputeMinGrips or can't be split up and nothing was precomputed.
+	// Grips that read a component an earlier applied grip moves are left to the apply loop.
+	bool ComputeGripTransforms(TArray<FBPActorGripInformation> &GrippedObjects, const FTransform & ParentTransform, float DeltaTime);
+
+	// Scratch for ComputeGripTransforms, indexed the same as the grip array being handled
+	TArray<FPrecomputedGripTransform> PrecomputedGripTransforms;
+
 	// Gets the world transform of a grip, modified by secondary grips and interaction settings
-	FORCEINLINE_DEBUGGABLE void GetGripWorldTransform(float DeltaTime,FTransform & WorldTransform, const FTransform &ParentTransform, FBPActorGripInformation &Grip, AActor * actor, UPrimitiveComponent * root, bool bRootHasInterface, bool bActorHasInterface, bool & bRescalePhysicsGrips);
+	// The grips interface cache needs to be resolved prior to calling this
+	FORCEINLINE_DEBUGGABLE void GetGripWorldTransform(float DeltaTime,FTransform & WorldTransform, const FTransform &ParentTransform, FBPActorGripInformation &Grip, AActor * actor, UPrimitiveComponent * root, bool & bRescalePhysicsGrips)
+	{
+		FGripInterfaceAnswers Answers;
+		ReadGripInterfaceAnswers(Grip, Answers);
+		ComputeGripWorldTransform(DeltaTime, WorldTransform, ParentTransform, Grip, root, Answers, bRescalePhysicsGrips);
+	}
+
+	// Reads the interface answers of a grip, may run native or blueprint interface code so it is game thread only
+	void ReadGripInterfaceAnswers(const FBPActorGripInformation & Grip, FGripInterfaceAnswers & Answers) const;
+
+	// The math half of GetGripWorldTransform, doesn't call into the grip interface
+	void ComputeGripWorldTransform(float DeltaTime, FTransform & WorldTransform, const FTransform &ParentTransform, FBPActorGripInformation &Grip, UPrimitiveComponent * root, const FGripInterfaceAnswers & Answers, bool & bRescalePhysicsGrips);
 
 	// Handle modifying the transform per the grip interaction settings, returns final world transform
-	FORCEINLINE FTransform HandleInteractionSettings(float DeltaTime, const FTransform & ParentTransform, UPrimitiveComponent * root, FBPInteractionSettings InteractionSettings, FBPActorGripInformation & GripInfo);
+	FORCEINLINE FTransform HandleInteractionSettings(float DeltaTime, const FTransform & ParentTransform, UPrimitiveComponent * root, const FBPInteractionSettings & InteractionSettings, FBPActorGripInformation & GripInfo);
+
+	// Resolves the cached interface state of a grip if it hasn't been yet, was marked dirty, or the gripped root / actor changed
+	void ResolveGripInterfaceCache(FBPActorGripInformation & Grip, UPrimitiveComponent * root, AActor * actor);
+
+	// Forces the interface state of a grip to be re-read on the next tick. Call this after changing the interface answers of a
+	// blueprint implemented grippable while it is held, native grippables are read directly and don't need it.
+	UFUNCTION(BlueprintCallable, Category = "VRGrip")
+	void MarkGripInterfaceDirty(UObject * GrippedObject);
+
+	// Sends the TickGrip event to the root and actor of a grip, natively if they aren't overridden in blueprint
+	void SendTickGrip(const FBPActorGripInformation & Grip, UPrimitiveComponent * root, AActor * actor, const FVector & MotionControllerLocDelta, float DeltaTime);
+
+	// Interaction settings read from blueprint implemented interfaces, keyed by gripped object
+	TMap<const UObject *, FBPInteractionSettings> CachedInteractionSettings;
+
+	FORCEINLINE bool GetGripIsInteractible(const FBPActorGripInformation & Grip) const
+	{
+		const FGripInterfaceCache & Cache = Grip.InterfaceCache;
+		return Cache.NativeInterface ? Cache.NativeInterface->IsInteractible_Native() : Cache.bIsInteractible;
+	}
+
+	FORCEINLINE FBPInteractionSettings GetGripInteractionSettings(const FBPActorGripInformation & Grip) const
+	{
+		const FGripInterfaceCache & Cache = Grip.InterfaceCache;
+
+		if (Cache.NativeInterface)
+			return Cache.NativeInterface->GetInteractionSettings_Native();
+
+		static const FBPInteractionSettings DefaultInteractionSettings;
+		const FBPInteractionSettings * Settings = CachedInteractionSettings.Find(Grip.GrippedObject);
+		return Settings ? *Settings : DefaultInteractionSettings;
+	}
+
+	FORCEINLINE float GetGripBreakDistance(const FBPActorGripInformation & Grip) const
+	{
+		const FGripInterfaceCache & Cache = Grip.InterfaceCache;
+		return Cache.NativeInterface ? Cache.NativeInterface->GripBreakDistance_Native() : Cache.BreakDistance;
+	}
+
+	FORCEINLINE ESecondaryGripType GetGripSecondaryGripType(const FBPActorGripInformation & Grip) const
+	{
+		const FGripInterfaceCache & Cache = Grip.InterfaceCache;
+		return Cache.NativeInterface ? Cache.NativeInterface->SecondaryGripType_Native() : Cache.SecondaryGripType;
+	}
 
 	// Converts a worldspace transform into being relative to this motion controller, optionally can check interface settings for a given object as well to modify the given transform
 	UFUNCTION(BlueprintPure, Category = "VRGrip")
@@ -681,6 +894,15 @@ public:
 	bool bUseWithoutTracking;
 
 	bool CheckComponentWithSweep(UPrimitiveComponent * ComponentToCheck, FVector Move, FRotator newOrientation, bool bSkipSimulatingComponents/*, bool & bHadBlockingHitOut*/);
+
+	// Picks the blocking hit out of a sweeps results and dispatches it, returns true if there was one
+	bool ProcessSweepHits(UPrimitiveComponent * root, TArray<FHitResult> & Hits, const FVector & Move, bool bSkipSimulatingComponents);
+
+	// SweepWithPhysics grip sweep when vr.GripAsyncSweeps is on, returns the collision state from last frames sweep
+	bool CheckComponentWithAsyncSweep(const FBPActorGripInformation & Grip, UPrimitiveComponent * root, const FVector & Move);
+
+	// Async sweeps in flight, keyed by gripped object
+	TMap<const UObject *, FGripAsyncSweep> PendingGripSweeps;
 	
 	// For physics handle operations
 	bool SetUpPhysicsHandle(const FBPActorGripInformation &NewGrip);
@@ -689,10 +911,17 @@ public:
 	bool GetPhysicsJointLength(const FBPActorGripInformation &GrippedActor, UPrimitiveComponent * rootComp, FVector & LocOut);
 	bool SetGripConstraintStiffnessAndDamping(const FBPActorGripInformation *Grip, bool bUseHybridMultiplier = false);
 
-	TArray<FBPActorPhysicsHandleInformation> PhysicsGrips;
+	// Sparse so that slots stay stable for the grips FGripPhysicsHandleRef
+	TSparseArray<FBPActorPhysicsHandleInformation> PhysicsGrips;
+	uint32 PhysicsGripGeneration;
+
+	// Slots of PhysicsGrips keyed by handled object, for grips that arrive without their FGripPhysicsHandleRef set
+	TMap<const UObject *, int32> PhysicsGripSlots;
+
 	FBPActorPhysicsHandleInformation * GetPhysicsGrip(const FBPActorGripInformation & GripInfo);
 	bool GetPhysicsGripIndex(const FBPActorGripInformation & GripInfo, int & index);
 	FBPActorPhysicsHandleInformation * CreatePhysicsGrip(const FBPActorGripInformation & GripInfo);
+	void RemovePhysicsGrip(int32 Index);
 	bool DestroyPhysicsHandle(int32 SceneIndex, physx::PxD6Joint** HandleData, physx::PxRigidDynamic** KinActorData);
 
 	/** If true, the Position and Orientation args will contain the most recent controller state */
@@ -712,7 +941,16 @@ private:
 	class FViewExtension : public ISceneViewExtension, public TSharedFromThis<FViewExtension, ESPMode::ThreadSafe>
 	{
 	public:
-		FViewExtension(UGripMotionControllerComponent* InMotionControllerComponent) { MotionControllerComponent = InMotionControllerComponent; }
+		FViewExtension(UGripMotionControllerComponent* InMotionControllerComponent) 
+		{ 
+			MotionControllerComponent = InMotionControllerComponent; 
+			bLateUpdatePrimitivesDirty = true; 
+			CachedLateUpdateHierarchySerial = 0;
+			bFoundStaleLateUpdatePrimitive = 0;
+			WriteSnapshotIndex = 0;
+			ReadySnapshotIndex = 1;
+			ReadSnapshotIndex = 2;
+		}
 		virtual ~FViewExtension() {}
 
 		/** ISceneViewExtension interface */
@@ -746,10 +984,77 @@ private:
 
 		/** Walks the component hierarchy gathering scene proxies */
 		void GatherLateUpdatePrimitives(USceneComponent* Component, TArray<LateUpdatePrimitiveInfo>& Primitives);
-		FORCEINLINE void ProcessGripArrayLateUpdatePrimitives(TArray<FBPActorGripInformation> & GripArray);
+		FORCEINLINE void ProcessGripArrayLateUpdatePrimitives(const TArray<FBPActorGripInformation> & GripArray);
+
+		/** False once anything invalidated the cached primitives */
+		bool IsLateUpdateCacheValid() const;
+
+		/** Everything the render thread needs for a late update, captured on the game thread so that it never touches the component */
+		struct LateUpdateSnapshot
+		{
+			/** Primitives that need late update before rendering */
+			TArray<LateUpdatePrimitiveInfo> Primitives;
+
+			/** CalcNewComponentToWorld of the render thread relative transform */
+			FTransform OldComponentToWorld;
+
+			/** Attach parent socket transform and absolute flags, to do the same for the polled transform */
+			FTransform ParentToWorld;
+			bool bHasAttachParent;
+			bool bAbsoluteLocation;
+			bool bAbsoluteRotation;
+			bool bAbsoluteScale;
+
+			FVector ComponentScale;
+			FVector HMDOffset;
+			int32 PlayerIndex;
+			EControllerHand Hand;
+			bool bCanPoll;
+			bool bOffsetByHMD;
+
+			/** Mirrors USceneComponent::CalcNewComponentToWorld with the captured parent */
+			FTransform CalcNewComponentToWorld(const FTransform & NewRelativeTransform) const
+			{
+				if (!bHasAttachParent)
+					return NewRelativeTransform;
+
+				FTransform NewComponentToWorld = NewRelativeTransform * ParentToWorld;
+
+				if (bAbsoluteLocation)
+					NewComponentToWorld.CopyTranslation(NewRelativeTransform);
+
+				if (bAbsoluteRotation)
+					NewComponentToWorld.CopyRotation(NewRelativeTransform);
+
+				if (bAbsoluteScale)
+					NewComponentToWorld.CopyScale3D(NewRelativeTransform);
 
-		/** Primitives that need late update before rendering */
-		TArray<LateUpdatePrimitiveInfo> LateUpdatePrimitives;
+				return NewComponentToWorld;
+			}
+		};
+
+		/*
+		*	Triple buffered so that neither thread ever waits on the other. The game thread only touches the write snapshot and
+		*  the render thread only the read snapshot, the ready index is exchanged atomically between them and flagged when
+		*  it holds a snapshot the render thread hasn't taken yet.
+		*/
+		LateUpdateSnapshot Snapshots[3];
+		int32 WriteSnapshotIndex;
+		int32 ReadSnapshotIndex;
+		volatile int32 ReadySnapshotIndex;
+
+		/** Game thread cache of the late update primitives and what they were gathered from */
+		TArray<LateUpdatePrimitiveInfo> CachedLateUpdatePrimitives;
+		TArray<USceneComponent*> CachedLateUpdateRoots;
+		TArray<USceneComponent*> LateUpdateRoots;
+		int32 CachedLateUpdateHierarchySerial;
+		bool bLateUpdatePrimitivesDirty;
+
+		/** Primitives that had no proxy when gathered (hidden or collision only), the engine doesn't notify when they get one */
+		TArray<TWeakObjectPtr<UPrimitiveComponent>> CachedProxylessPrimitives;
+
+		/** Set by the render thread when a cached proxy was removed or recreated */
+		volatile int32 bFoundStaleLateUpdatePrimitive;
 	};
 	TSharedPtr< FViewExtension, ESPMode::ThreadSafe > ViewExtension;
 
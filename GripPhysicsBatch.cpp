@@ -0,0 +1,149 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "GripPhysicsBatch.h"
+#include "GripMotionControllerComponent.h"
+
+#if WITH_PHYSX
+#include "PhysXSupport.h"
+
+//For UE4 Profiler ~ Stat
+DECLARE_CYCLE_STAT(TEXT("TickGrip ~ PhysicsBatchFlush"), STAT_GripPhysicsBatchFlush, STATGROUP_TickGrip);
+DECLARE_CYCLE_STAT(TEXT("TickGrip ~ PhysicsBatchLockHeld"), STAT_GripPhysicsBatchLockHeld, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGrip ~ KinematicTargetsApplied"), STAT_GripPhysicsBatchTargets, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGrip ~ KinematicTargetsSkipped"), STAT_GripPhysicsBatchTargetsSkipped, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGrip ~ JointDrivesApplied"), STAT_GripPhysicsBatchDrives, STATGROUP_TickGrip);
+
+FGripPhysicsBatch & FGripPhysicsBatch::Get()
+{
+	static FGripPhysicsBatch Batch;
+	return Batch;
+}
+
+FGripPhysicsBatch::FGripPhysicsBatch()
+{
+	FPhysicsDelegates::OnPhysSceneTerm.AddRaw(this, &FGripPhysicsBatch::OnPhysSceneTerm);
+}
+
+void FGripPhysicsBatch::RegisterPhysScene(FPhysScene * PhysScene)
+{
+	check(IsInGameThread());
+
+	if (!PhysScene || RegisteredScenes.Contains(PhysScene))
+		return;
+
+	RegisteredScenes.Add(PhysScene, PhysScene->OnPhysScenePreTick.AddRaw(this, &FGripPhysicsBatch::OnPhysScenePreTick));
+}
+
+void FGripPhysicsBatch::QueueKinematicTarget(int32 SceneIndex, physx::PxRigidDynamic * KinActor, const physx::PxTransform & Target)
+{
+	check(IsInGameThread());
+
+	if (!KinActor)
+		return;
+
+	SceneBatches.FindOrAdd(SceneIndex).KinematicTargets.Add(KinActor, Target);
+}
+
+void FGripPhysicsBatch::QueueJointDrive(int32 SceneIndex, physx::PxD6Joint * Joint, physx::PxD6Drive::Enum DriveType, const physx::PxD6JointDrive & Drive)
+{
+	check(IsInGameThread());
+
+	if (!Joint)
+		return;
+
+	FPendingJointDrives & Pending = SceneBatches.FindOrAdd(SceneIndex).JointDrives.FindOrAdd(Joint);
+	Pending.Drives[DriveType] = Drive;
+	Pending.DriveMask |= (1 << DriveType);
+}
+
+void FGripPhysicsBatch::RemovePending(int32 SceneIndex, physx::PxRigidDynamic * KinActor, physx::PxD6Joint * Joint)
+{
+	check(IsInGameThread());
+
+	FSceneBatch * Batch = SceneBatches.Find(SceneIndex);
+
+	if (!Batch)
+		return;
+
+	if (KinActor)
+		Batch->KinematicTargets.Remove(KinActor);
+
+	if (Joint)
+		Batch->JointDrives.Remove(Joint);
+}
+
+void FGripPhysicsBatch::FlushScene(int32 SceneIndex)
+{
+	FSceneBatch * Batch = SceneBatches.Find(SceneIndex);
+
+	if (!Batch || (!Batch->KinematicTargets.Num() && !Batch->JointDrives.Num()))
+		return;
+
+	SCOPE_CYCLE_COUNTER(STAT_GripPhysicsBatchFlush);
+
+	uint32 TargetsApplied = 0;
+	uint32 TargetsSkipped = 0;
+	uint32 DrivesApplied = 0;
+
+	PxScene* PScene = GetPhysXSceneFromIndex(SceneIndex);
+	if (PScene)
+	{
+		SCOPED_SCENE_WRITE_LOCK(PScene);
+		SCOPE_CYCLE_COUNTER(STAT_GripPhysicsBatchLockHeld);
+
+		for (TPair<PxD6Joint *, FPendingJointDrives> & DrivePair : Batch->JointDrives)
+		{
+			for (int32 DriveType = 0; DriveType < PxD6Drive::eCOUNT; ++DriveType)
+			{
+				if (DrivePair.Value.DriveMask & (1 << DriveType))
+				{
+					DrivePair.Key->setDrive((PxD6Drive::Enum)DriveType, DrivePair.Value.Drives[DriveType]);
+					++DrivesApplied;
+				}
+			}
+		}
+
+		for (TPair<PxRigidDynamic *, PxTransform> & TargetPair : Batch->KinematicTargets)
+		{
+			const PxTransform CurrentPose = TargetPair.Key->getGlobalPose();
+
+			// Don't call moveKinematic if it hasn't changed - that will stop bodies from going to sleep.
+			if ((TargetPair.Value.p - CurrentPose.p).magnitudeSquared() <= 0.01f*0.01f &&
+				FMath::Abs(TargetPair.Value.q.dot(CurrentPose.q)) > (1.f - SMALL_NUMBER))
+			{
+				++TargetsSkipped;
+				continue;
+			}
+
+			TargetPair.Key->setKinematicTarget(TargetPair.Value);
+			++TargetsApplied;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_GripPhysicsBatchTargets, TargetsApplied);
+	INC_DWORD_STAT_BY(STAT_GripPhysicsBatchTargetsSkipped, TargetsSkipped);
+	INC_DWORD_STAT_BY(STAT_GripPhysicsBatchDrives, DrivesApplied);
+
+	// Reset instead of empty so the next frame doesn't reallocate
+	Batch->KinematicTargets.Reset();
+	Batch->JointDrives.Reset();
+}
+
+void FGripPhysicsBatch::OnPhysScenePreTick(FPhysScene * PhysScene, uint32 SceneType, float DeltaTime)
+{
+	FlushScene(PhysScene->PhysXSceneIndex[SceneType]);
+}
+
+void FGripPhysicsBatch::OnPhysSceneTerm(FPhysScene * PhysScene, EPhysicsSceneType SceneType)
+{
+	// Anything still queued points at actors that are going away with the scene
+	SceneBatches.Remove(PhysScene->PhysXSceneIndex[SceneType]);
+
+	if (FDelegateHandle * Handle = RegisteredScenes.Find(PhysScene))
+	{
+		PhysScene->OnPhysScenePreTick.Remove(*Handle);
+		RegisteredScenes.Remove(PhysScene);
+	}
+}
+
+#endif // WITH_PHYSX
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PhysicsPublic.h"
+
+#if WITH_PHYSX
+#include "PhysXPublic.h"
+
+/**
+* Collects the kinematic targets and joint drive changes of every physics grip in the process and applies them
+* once per physics scene, right before that scene simulates, under a single scene write lock.
+* Per grip locking serializes badly against the physics thread once there are a lot of hands holding things.
+* Game thread only.
+*/
+class VREXPANSIONPLUGIN_API FGripPhysicsBatch
+{
+public:
+
+	static FGripPhysicsBatch & Get();
+
+	// Binds the flush to the scenes pre tick, safe to call repeatedly
+	void RegisterPhysScene(FPhysScene * PhysScene);
+
+	// Queues the final kinematic target of a handle, replaces any target already queued for it this frame
+	void QueueKinematicTarget(int32 SceneIndex, physx::PxRigidDynamic * KinActor, const physx::PxTransform & Target);
+
+	// Queues a drive change for a handle joint, replaces any drive already queued for the same axis this frame
+	void QueueJointDrive(int32 SceneIndex, physx::PxD6Joint * Joint, physx::PxD6Drive::Enum DriveType, const physx::PxD6JointDrive & Drive);
+
+	// Drops anything queued for these PhysX objects, has to be called before they are released or set directly
+	void RemovePending(int32 SceneIndex, physx::PxRigidDynamic * KinActor, physx::PxD6Joint * Joint);
+
+	// Applies everything queued for the scene, called automatically from the scenes pre tick
+	void FlushScene(int32 SceneIndex);
+
+private:
+
+	struct FPendingJointDrives
+	{
+		physx::PxD6JointDrive Drives[physx::PxD6Drive::eCOUNT];
+		uint32 DriveMask;
+
+		FPendingJointDrives() :
+			DriveMask(0)
+		{}
+	};
+
+	struct FSceneBatch
+	{
+		TMap<physx::PxRigidDynamic *, physx::PxTransform> KinematicTargets;
+		TMap<physx::PxD6Joint *, FPendingJointDrives> JointDrives;
+	};
+
+	FGripPhysicsBatch();
+
+	void OnPhysScenePreTick(FPhysScene * PhysScene, uint32 SceneType, float DeltaTime);
+	void OnPhysSceneTerm(FPhysScene * PhysScene, EPhysicsSceneType SceneType);
+
+	TMap<int32, FSceneBatch> SceneBatches;
+	TMap<FPhysScene *, FDelegateHandle> RegisteredScenes;
+};
+
+#endif // WITH_PHYSX
@@ -0,0 +1,221 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "GripPhysicsHandlePool.h"
+#include "GripMotionControllerComponent.h"
+
+#if WITH_PHYSX
+#include "PhysXSupport.h"
+
+//For UE4 Profiler ~ Stat
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGrip ~ PhysicsHandlesCreated"), STAT_GripPhysicsHandlesCreated, STATGROUP_TickGrip);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("TickGrip ~ PhysicsHandlesInUse"), STAT_GripPhysicsHandlesInUse, STATGROUP_TickGrip);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("TickGrip ~ PhysicsHandlesPooled"), STAT_GripPhysicsHandlesPooled, STATGROUP_TickGrip);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("TickGrip ~ PhysicsHandlesHighWater"), STAT_GripPhysicsHandlesHighWater, STATGROUP_TickGrip);
+
+static TAutoConsoleVariable<int32> CVarGripPhysicsHandlePoolWarmup(
+	TEXT("vr.GripPhysicsHandlePoolWarmup"),
+	4,
+	TEXT("Number of physics grip handles to pre-create the first time a physics scene is gripped in.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarGripPhysicsHandlePoolMax(
+	TEXT("vr.GripPhysicsHandlePoolMax"),
+	64,
+	TEXT("Maximum number of idle physics grip handles kept per physics scene, extra handles are released on drop.\n"),
+	ECVF_Default);
+
+FGripPhysicsHandlePool & FGripPhysicsHandlePool::Get()
+{
+	static FGripPhysicsHandlePool Pool;
+	return Pool;
+}
+
+FGripPhysicsHandlePool::FGripPhysicsHandlePool() :
+	HighWaterMark(0)
+{
+	FPhysicsDelegates::OnPhysSceneTerm.AddRaw(this, &FGripPhysicsHandlePool::OnPhysSceneTerm);
+}
+
+bool FGripPhysicsHandlePool::CreateHandle(PxScene * Scene, FPooledHandle & OutHandle)
+{
+	PxRigidDynamic* KinActor = Scene->getPhysics().createRigidDynamic(PxTransform(PxIdentity));
+
+	if (!KinActor)
+		return false;
+
+	KinActor->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, true);
+	KinActor->setMass(0.0f);
+	KinActor->setMassSpaceInertiaTensor(PxVec3(0.0f, 0.0f, 0.0f));
+	KinActor->setMaxDepenetrationVelocity(PX_MAX_F32);
+
+	// No bodyinstance
+	KinActor->userData = NULL;
+
+	Scene->addActor(*KinActor);
+
+	PxD6Joint* NewJoint = PxD6JointCreate(Scene->getPhysics(), KinActor, PxTransform(PxIdentity), NULL, PxTransform(PxIdentity));
+
+	if (!NewJoint)
+	{
+		KinActor->release();
+		return false;
+	}
+
+	// No constraint instance
+	NewJoint->userData = NULL;
+
+	// Pretty Much Unbreakable
+	NewJoint->setBreakForce(PX_MAX_REAL, PX_MAX_REAL);
+
+	NewJoint->setMotion(PxD6Axis::eX, PxD6Motion::eFREE);
+	NewJoint->setMotion(PxD6Axis::eY, PxD6Motion::eFREE);
+	NewJoint->setMotion(PxD6Axis::eZ, PxD6Motion::eFREE);
+
+	NewJoint->setMotion(PxD6Axis::eTWIST, PxD6Motion::eFREE);
+	NewJoint->setMotion(PxD6Axis::eSWING1, PxD6Motion::eFREE);
+	NewJoint->setMotion(PxD6Axis::eSWING2, PxD6Motion::eFREE);
+
+	OutHandle = FPooledHandle(KinActor, NewJoint);
+	INC_DWORD_STAT(STAT_GripPhysicsHandlesCreated);
+	return true;
+}
+
+void FGripPhysicsHandlePool::ResetHandle(const FPooledHandle & Handle)
+{
+	// Zeroed drives leave the joint doing nothing, grip setup applies whichever ones it needs
+	const PxD6JointDrive EmptyDrive;
+	for (int32 DriveType = 0; DriveType < PxD6Drive::eCOUNT; ++DriveType)
+	{
+		Handle.Joint->setDrive((PxD6Drive::Enum)DriveType, EmptyDrive);
+	}
+
+	Handle.Joint->setDrivePosition(PxTransform(PxIdentity));
+	Handle.Joint->setDriveVelocity(PxVec3(0.0f), PxVec3(0.0f));
+}
+
+bool FGripPhysicsHandlePool::Acquire(PxScene * Scene, int32 SceneIndex, PxRigidDynamic * TargetActor, const PxTransform & KinPose, const PxTransform & TargetLocalPose, PxRigidDynamic *& OutKinActor, PxD6Joint *& OutJoint)
+{
+	check(IsInGameThread());
+
+	OutKinActor = NULL;
+	OutJoint = NULL;
+
+	if (!Scene || !TargetActor)
+		return false;
+
+	FScenePool * ScenePool = ScenePools.Find(SceneIndex);
+	if (!ScenePool)
+	{
+		ScenePool = &ScenePools.Add(SceneIndex);
+
+		const int32 WarmupCount = FMath::Max(CVarGripPhysicsHandlePoolWarmup.GetValueOnGameThread(), 0);
+		ScenePool->FreeHandles.Reserve(WarmupCount);
+
+		FPooledHandle NewHandle(NULL, NULL);
+		for (int32 i = 0; i < WarmupCount; ++i)
+		{
+			if (CreateHandle(Scene, NewHandle))
+				ScenePool->FreeHandles.Add(NewHandle);
+		}
+	}
+
+	FPooledHandle Handle(NULL, NULL);
+	if (ScenePool->FreeHandles.Num())
+	{
+		Handle = ScenePool->FreeHandles.Pop(false);
+	}
+	else if (!CreateHandle(Scene, Handle))
+	{
+		return false;
+	}
+
+	Handle.KinActor->setGlobalPose(KinPose);
+
+	Handle.Joint->setActors(Handle.KinActor, TargetActor);
+	Handle.Joint->setLocalPose(PxJointActorIndex::eACTOR0, PxTransform(PxIdentity));
+	Handle.Joint->setLocalPose(PxJointActorIndex::eACTOR1, TargetLocalPose);
+
+	ScenePool->NumInUse++;
+	UpdateStats();
+
+	OutKinActor = Handle.KinActor;
+	OutJoint = Handle.Joint;
+	return true;
+}
+
+void FGripPhysicsHandlePool::Release(int32 SceneIndex, PxRigidDynamic * KinActor, PxD6Joint * Joint)
+{
+	check(IsInGameThread());
+
+	if (!KinActor || !Joint)
+		return;
+
+	FScenePool * ScenePool = ScenePools.Find(SceneIndex);
+
+	if (ScenePool)
+		ScenePool->NumInUse = FMath::Max(ScenePool->NumInUse - 1, 0);
+
+	if (!ScenePool || ScenePool->FreeHandles.Num() >= CVarGripPhysicsHandlePoolMax.GetValueOnGameThread())
+	{
+		Joint->release();
+		KinActor->release();
+	}
+	else
+	{
+		FPooledHandle Handle(KinActor, Joint);
+		ResetHandle(Handle);
+
+		// Detach from the gripped body so it can be destroyed while we hold on to the handle, a joint between
+		// a kinematic and the world has nothing to solve so idle handles stay in the scene for free
+		Joint->setActors(KinActor, NULL);
+
+		ScenePool->FreeHandles.Add(Handle);
+	}
+
+	UpdateStats();
+}
+
+void FGripPhysicsHandlePool::UpdateStats()
+{
+	int32 NumInUse = 0;
+	int32 NumPooled = 0;
+
+	for (const TPair<int32, FScenePool> & PoolPair : ScenePools)
+	{
+		NumInUse += PoolPair.Value.NumInUse;
+		NumPooled += PoolPair.Value.FreeHandles.Num();
+	}
+
+	HighWaterMark = FMath::Max(HighWaterMark, NumInUse);
+
+	SET_DWORD_STAT(STAT_GripPhysicsHandlesInUse, NumInUse);
+	SET_DWORD_STAT(STAT_GripPhysicsHandlesPooled, NumPooled);
+	SET_DWORD_STAT(STAT_GripPhysicsHandlesHighWater, HighWaterMark);
+}
+
+void FGripPhysicsHandlePool::OnPhysSceneTerm(FPhysScene * PhysScene, EPhysicsSceneType SceneType)
+{
+	const int32 SceneIndex = PhysScene->PhysXSceneIndex[SceneType];
+	FScenePool * ScenePool = ScenePools.Find(SceneIndex);
+
+	if (!ScenePool)
+		return;
+
+	PxScene* PScene = GetPhysXSceneFromIndex(SceneIndex);
+	if (PScene)
+	{
+		SCOPED_SCENE_WRITE_LOCK(PScene);
+
+		for (const FPooledHandle & Handle : ScenePool->FreeHandles)
+		{
+			Handle.Joint->release();
+			Handle.KinActor->release();
+		}
+	}
+
+	// Scene indices get reused, never carry handles over to the next scene
+	ScenePools.Remove(SceneIndex);
+	UpdateStats();
+}
+
+#endif // WITH_PHYSX
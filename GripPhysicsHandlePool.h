@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PhysicsPublic.h"
+
+#if WITH_PHYSX
+#include "PhysXPublic.h"
+
+/**
+* Per physics scene pool of the kinematic actors and D6 joints that physics grips are driven with.
+* Handles are kept in the scene and re-pointed at new bodies instead of being created and released on every
+* grab and drop, idle handles stay in the scene with their joint detached from the gripped body.
+* Game thread only, the scene write lock has to be held around Acquire and Release.
+*/
+class VREXPANSIONPLUGIN_API FGripPhysicsHandlePool
+{
+public:
+
+	static FGripPhysicsHandlePool & Get();
+
+	// Hands out a kinematic actor at KinPose jointed to TargetActor, drives are zeroed and all motions are free
+	bool Acquire(physx::PxScene * Scene, int32 SceneIndex, physx::PxRigidDynamic * TargetActor, const physx::PxTransform & KinPose, const physx::PxTransform & TargetLocalPose, physx::PxRigidDynamic *& OutKinActor, physx::PxD6Joint *& OutJoint);
+
+	// Detaches the handle and returns it to the scenes pool, anything over the pool limit is released instead
+	void Release(int32 SceneIndex, physx::PxRigidDynamic * KinActor, physx::PxD6Joint * Joint);
+
+private:
+
+	struct FPooledHandle
+	{
+		physx::PxRigidDynamic * KinActor;
+		physx::PxD6Joint * Joint;
+
+		FPooledHandle(physx::PxRigidDynamic * InKinActor, physx::PxD6Joint * InJoint) :
+			KinActor(InKinActor),
+			Joint(InJoint)
+		{}
+	};
+
+	struct FScenePool
+	{
+		TArray<FPooledHandle> FreeHandles;
+		int32 NumInUse;
+
+		FScenePool() :
+			NumInUse(0)
+		{}
+	};
+
+	FGripPhysicsHandlePool();
+
+	bool CreateHandle(physx::PxScene * Scene, FPooledHandle & OutHandle);
+	void ResetHandle(const FPooledHandle & Handle);
+	void UpdateStats();
+
+	void OnPhysSceneTerm(FPhysScene * PhysScene, EPhysicsSceneType SceneType);
+
+	TMap<int32, FScenePool> ScenePools;
+	int32 HighWaterMark;
+};
+
+#endif // WITH_PHYSX
@@ -0,0 +1,106 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "GripMotionControllerComponent.h"
+#include "UObject/Package.h"
+
+// Times physics grip handle lookups on a transient controller, the slot reference and object map against the linear search
+// that GetPhysicsGripIndex used to do, for grips that have a physics handle and for grips that don't.
+// Usage: vr.PhysicsGripLookupBenchmark [NumGrips] [Iterations]
+
+namespace
+{
+	// The lookup GetPhysicsGripIndex did before handles were referenced by slot
+	bool LinearSearchPhysicsGrip(const UGripMotionControllerComponent * Controller, const FBPActorGripInformation & GripInfo, int & index)
+	{
+		for (auto It = Controller->PhysicsGrips.CreateConstIterator(); It; ++It)
+		{
+			if (*It == GripInfo)
+			{
+				index = It.GetIndex();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	template<typename LookupType>
+	void RunPhysicsGripLookup(const TCHAR * LookupName, const TArray<FBPActorGripInformation> & Grips, int32 Iterations, LookupType Lookup)
+	{
+		int32 NumFound = 0;
+		int64 IndexSum = 0;
+
+		const uint32 StartCycles = FPlatformTime::Cycles();
+
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			for (const FBPActorGripInformation & Grip : Grips)
+			{
+				int Index = INDEX_NONE;
+				if (Lookup(Grip, Index))
+				{
+					++NumFound;
+					IndexSum += Index;
+				}
+			}
+		}
+
+		const uint32 Cycles = FPlatformTime::Cycles() - StartCycles;
+		const int32 NumLookups = Grips.Num() * Iterations;
+
+		UE_LOG(LogVRMotionController, Display, TEXT("%-36s %8.2f ns/lookup | found %d of %d (index sum %lld)"),
+			LookupName,
+			NumLookups ? (Cycles * FPlatformTime::GetSecondsPerCycle() * 1e9) / NumLookups : 0.0,
+			NumFound,
+			NumLookups,
+			IndexSum);
+	}
+
+	void RunPhysicsGripLookupBenchmark(const TArray<FString> & Args)
+	{
+		const int32 NumGrips = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 1, 1024) : 8;
+		const int32 Iterations = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 100000;
+
+		// Never registered, only its handle bookkeeping is used and no physx objects are created
+		UGripMotionControllerComponent * Controller = NewObject<UGripMotionControllerComponent>(GetTransientPackage());
+
+		TArray<FBPActorGripInformation> PhysicsGrips;
+		TArray<FBPActorGripInformation> OtherGrips;
+
+		// UObject itself is abstract, the grips only need distinct objects to key on so use bare scene components
+		for (int32 i = 0; i < NumGrips; ++i)
+		{
+			FBPActorGripInformation & PhysicsGrip = PhysicsGrips[PhysicsGrips.AddDefaulted()];
+			PhysicsGrip.GrippedObject = NewObject<USceneComponent>(GetTransientPackage());
+			Controller->CreatePhysicsGrip(PhysicsGrip);
+
+			FBPActorGripInformation & OtherGrip = OtherGrips[OtherGrips.AddDefaulted()];
+			OtherGrip.GrippedObject = NewObject<USceneComponent>(GetTransientPackage());
+		}
+
+		UE_LOG(LogVRMotionController, Display, TEXT("Physics grip lookup benchmark: %d physics grips, %d iterations"), NumGrips, Iterations);
+
+		RunPhysicsGripLookup(TEXT("Physics grip, slot reference"), PhysicsGrips, Iterations,
+			[Controller](const FBPActorGripInformation & Grip, int & Index) { return Controller->GetPhysicsGripIndex(Grip, Index); });
+
+		RunPhysicsGripLookup(TEXT("Physics grip, lost reference"), PhysicsGrips, Iterations,
+			[Controller](const FBPActorGripInformation & Grip, int & Index) { Grip.PhysicsHandle.Reset(); return Controller->GetPhysicsGripIndex(Grip, Index); });
+
+		RunPhysicsGripLookup(TEXT("Physics grip, linear search"), PhysicsGrips, Iterations,
+			[Controller](const FBPActorGripInformation & Grip, int & Index) { return LinearSearchPhysicsGrip(Controller, Grip, Index); });
+
+		RunPhysicsGripLookup(TEXT("Non physics grip, object map"), OtherGrips, Iterations,
+			[Controller](const FBPActorGripInformation & Grip, int & Index) { return Controller->GetPhysicsGripIndex(Grip, Index); });
+
+		RunPhysicsGripLookup(TEXT("Non physics grip, linear search"), OtherGrips, Iterations,
+			[Controller](const FBPActorGripInformation & Grip, int & Index) { return LinearSearchPhysicsGrip(Controller, Grip, Index); });
+
+		Controller->PhysicsGrips.Empty();
+		Controller->PhysicsGripSlots.Empty();
+	}
+}
+
+static FAutoConsoleCommandWithArgs PhysicsGripLookupBenchmarkCommand(
+	TEXT("vr.PhysicsGripLookupBenchmark"),
+	TEXT("Times physics grip handle lookups for [NumGrips] grips (8 default) over [Iterations] (100000 default), slot and object map lookups against a linear search."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunPhysicsGripLookupBenchmark));
@@ -1,6 +1,7 @@
 // Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
 
 #include "GrippableBoxComponent.h"
+#include "GripMotionControllerComponent.h"
 
 //=============================================================================
 UGrippableBoxComponent::~UGrippableBoxComponent()
@@ -169,3 +170,21 @@ FBPInteractionSettings UGrippableBoxComponent::GetInteractionSettings_Implementa
 {
 	return VRGripInterfaceSettings.InteractionSettings;
 }
+
+void UGrippableBoxComponent::OnChildAttached(USceneComponent* ChildComponent)
+{
+	Super::OnChildAttached(ChildComponent);
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
+
+void UGrippableBoxComponent::OnChildDetached(USceneComponent* ChildComponent)
+{
+	Super::OnChildDetached(ChildComponent);
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
+
+void UGrippableBoxComponent::OnVisibilityChanged()
+{
+	Super::OnVisibilityChanged();
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
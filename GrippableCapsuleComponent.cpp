@@ -1,6 +1,7 @@
 // Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
 
 #include "GrippableCapsuleComponent.h"
+#include "GripMotionControllerComponent.h"
 
   //=============================================================================
 UGrippableCapsuleComponent::UGrippableCapsuleComponent(const FObjectInitializer& ObjectInitializer)
@@ -171,3 +172,21 @@ FBPInteractionSettings UGrippableCapsuleComponent::GetInteractionSettings_Implem
 {
 	return VRGripInterfaceSettings.InteractionSettings;
 }
+
+void UGrippableCapsuleComponent::OnChildAttached(USceneComponent* ChildComponent)
+{
+	Super::OnChildAttached(ChildComponent);
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
+
+void UGrippableCapsuleComponent::OnChildDetached(USceneComponent* ChildComponent)
+{
+	Super::OnChildDetached(ChildComponent);
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
+
+void UGrippableCapsuleComponent::OnVisibilityChanged()
+{
+	Super::OnVisibilityChanged();
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
@@ -16,7 +16,7 @@
 */
 
 UCLASS(Blueprintable, meta = (BlueprintSpawnableComponent), ClassGroup = (VRExpansionPlugin))
-class VREXPANSIONPLUGIN_API AGrippableSkeletalMeshActor : public ASkeletalMeshActor, public IVRGripInterface, public IGameplayTagAssetInterface
+class VREXPANSIONPLUGIN_API AGrippableSkeletalMeshActor : public ASkeletalMeshActor, public IVRGripInterface, public IVRGripInterfaceNative, public IGameplayTagAssetInterface
 {
 	GENERATED_UCLASS_BODY()
 
@@ -38,6 +38,22 @@ class VREXPANSIONPLUGIN_API AGrippableSkeletalMeshActor : public ASkeletalMeshAc
 
 	// End Gameplay Tag Interface
 
+	// ------------------------------------------------
+	// Native grip interface, skips ProcessEvent for the per tick queries
+	// ------------------------------------------------
+
+	virtual IVRGripInterfaceNative * GetNativeGripInterface() override { return this; }
+	virtual bool IsInteractible_Native() override { return IsInteractible_Implementation(); }
+	virtual FBPInteractionSettings GetInteractionSettings_Native() override { return GetInteractionSettings_Implementation(); }
+	virtual float GripBreakDistance_Native() override { return GripBreakDistance_Implementation(); }
+	virtual ESecondaryGripType SecondaryGripType_Native() override { return SecondaryGripType_Implementation(); }
+	virtual void TickGrip_Native(UGripMotionControllerComponent * GrippingController, const FBPActorGripInformation & GripInformation, FVector MControllerLocDelta, float DeltaTime) override
+	{
+		TickGrip_Implementation(GrippingController, GripInformation, MControllerLocDelta, DeltaTime);
+	}
+
+	// End Native grip interface
+
 	virtual void PreReplication(IRepChangedPropertyTracker & ChangedPropertyTracker) override;
 
 	UPROPERTY(EditAnywhere, Replicated, BlueprintReadWrite, Category = "VRGripInterface")
@@ -1,6 +1,7 @@
 // Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
 
 #include "GrippableSkeletalMeshComponent.h"
+#include "GripMotionControllerComponent.h"
 
   //=============================================================================
 UGrippableSkeletalMeshComponent::UGrippableSkeletalMeshComponent(const FObjectInitializer& ObjectInitializer)
@@ -170,3 +171,21 @@ FBPInteractionSettings UGrippableSkeletalMeshComponent::GetInteractionSettings_I
 {
 	return VRGripInterfaceSettings.InteractionSettings;
 }
+
+void UGrippableSkeletalMeshComponent::OnChildAttached(USceneComponent* ChildComponent)
+{
+	Super::OnChildAttached(ChildComponent);
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
+
+void UGrippableSkeletalMeshComponent::OnChildDetached(USceneComponent* ChildComponent)
+{
+	Super::OnChildDetached(ChildComponent);
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
+
+void UGrippableSkeletalMeshComponent::OnVisibilityChanged()
+{
+	Super::OnVisibilityChanged();
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
@@ -1,6 +1,7 @@
 // Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
 
 #include "GrippableSphereComponent.h"
+#include "GripMotionControllerComponent.h"
 
   //=============================================================================
 UGrippableSphereComponent::UGrippableSphereComponent(const FObjectInitializer& ObjectInitializer)
@@ -170,3 +171,21 @@ FBPInteractionSettings UGrippableSphereComponent::GetInteractionSettings_Impleme
 {
 	return VRGripInterfaceSettings.InteractionSettings;
 }
+
+void UGrippableSphereComponent::OnChildAttached(USceneComponent* ChildComponent)
+{
+	Super::OnChildAttached(ChildComponent);
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
+
+void UGrippableSphereComponent::OnChildDetached(USceneComponent* ChildComponent)
+{
+	Super::OnChildDetached(ChildComponent);
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
+
+void UGrippableSphereComponent::OnVisibilityChanged()
+{
+	Super::OnVisibilityChanged();
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
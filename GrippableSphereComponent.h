@@ -15,7 +15,7 @@
 */
 
 UCLASS(Blueprintable, meta = (BlueprintSpawnableComponent), ClassGroup = (VRExpansionPlugin))
-class VREXPANSIONPLUGIN_API UGrippableSphereComponent : public USphereComponent, public IVRGripInterface, public IGameplayTagAssetInterface
+class VREXPANSIONPLUGIN_API UGrippableSphereComponent : public USphereComponent, public IVRGripInterface, public IVRGripInterfaceNative, public IGameplayTagAssetInterface
 {
 	GENERATED_UCLASS_BODY()
 
@@ -37,8 +37,29 @@ class VREXPANSIONPLUGIN_API UGrippableSphereComponent : public USphereComponent,
 
 	// End Gameplay Tag Interface
 
+	// ------------------------------------------------
+	// Native grip interface, skips ProcessEvent for the per tick queries
+	// ------------------------------------------------
+
+	virtual IVRGripInterfaceNative * GetNativeGripInterface() override { return this; }
+	virtual bool IsInteractible_Native() override { return IsInteractible_Implementation(); }
+	virtual FBPInteractionSettings GetInteractionSettings_Native() override { return GetInteractionSettings_Implementation(); }
+	virtual float GripBreakDistance_Native() override { return GripBreakDistance_Implementation(); }
+	virtual ESecondaryGripType SecondaryGripType_Native() override { return SecondaryGripType_Implementation(); }
+	virtual void TickGrip_Native(UGripMotionControllerComponent * GrippingController, const FBPActorGripInformation & GripInformation, FVector MControllerLocDelta, float DeltaTime) override
+	{
+		TickGrip_Implementation(GrippingController, GripInformation, MControllerLocDelta, DeltaTime);
+	}
+
+	// End Native grip interface
+
 	virtual void PreReplication(IRepChangedPropertyTracker & ChangedPropertyTracker) override;
 
+	// Hierarchy and visibility changes invalidate the late update caches of the controllers holding this
+	virtual void OnChildAttached(USceneComponent* ChildComponent) override;
+	virtual void OnChildDetached(USceneComponent* ChildComponent) override;
+	virtual void OnVisibilityChanged() override;
+
 	// Requires bReplicates to be true for the component
 	UPROPERTY(EditAnywhere, Replicated, BlueprintReadWrite, Category = "VRGripInterface")
 		bool bRepGripSettingsAndGameplayTags;
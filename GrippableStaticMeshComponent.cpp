@@ -1,6 +1,7 @@
 // Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
 
 #include "GrippableStaticMeshComponent.h"
+#include "GripMotionControllerComponent.h"
 
   //=============================================================================
 UGrippableStaticMeshComponent::UGrippableStaticMeshComponent(const FObjectInitializer& ObjectInitializer)
@@ -170,3 +171,21 @@ FBPInteractionSettings UGrippableStaticMeshComponent::GetInteractionSettings_Imp
 {
 	return VRGripInterfaceSettings.InteractionSettings;
 }
+
+void UGrippableStaticMeshComponent::OnChildAttached(USceneComponent* ChildComponent)
+{
+	Super::OnChildAttached(ChildComponent);
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
+
+void UGrippableStaticMeshComponent::OnChildDetached(USceneComponent* ChildComponent)
+{
+	Super::OnChildDetached(ChildComponent);
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
+
+void UGrippableStaticMeshComponent::OnVisibilityChanged()
+{
+	Super::OnVisibilityChanged();
+	UGripMotionControllerComponent::NotifyLateUpdateHierarchyChanged();
+}
@@ -17,6 +17,8 @@ UReplicatedVRCameraComponent::UReplicatedVRCameraComponent(const FObjectInitiali
 	//bReplicateTransform = true;
 	NetUpdateRate = 100.0f; // 100 htz is default
 	NetUpdateCount = 0.0f;
+	bTransformSentByOwner = false;
+	bSmoothReplicatedMotion = false;
 
 	bUsePawnControlRotation = false;
 	bAutoSetLockToHmd = true;
@@ -47,8 +49,23 @@ void UReplicatedVRCameraComponent::GetLifetimeReplicatedProps(TArray< class FLif
 
 void UReplicatedVRCameraComponent::Server_SendTransform_Implementation(FBPVRComponentPosRep NewTransform)
 {
+	ReceiveTransform(NewTransform);
+}
+
+void UReplicatedVRCameraComponent::ReceiveTransform(const FBPVRComponentPosRep & NewTransform)
+{
+	FBPVRComponentPosRep ResolvedTransform = NewTransform;
+	int32 AckIndex = INDEX_NONE;
+
+	// Relative to a keyframe that never arrived, nothing to do with it
+	if (!PoseBaselineReceiver.Resolve(ResolvedTransform, AckIndex))
+		return;
+
+	if (AckIndex != INDEX_NONE)
+		Client_AckPoseBaseline((uint8)AckIndex);
+
 	// Store new transform and trigger OnRep_Function
-	ReplicatedTransform = NewTransform;
+	ReplicatedTransform = ResolvedTransform;
 
 	// Don't call on rep on the server if the server controls this controller
 	if (!bHasAuthority)
@@ -57,6 +74,11 @@ void UReplicatedVRCameraComponent::Server_SendTransform_Implementation(FBPVRComp
 	}
 }
 
+void UReplicatedVRCameraComponent::Client_AckPoseBaseline_Implementation(uint8 BaselineIndex)
+{
+	PoseBaselineSender.OnBaselineAcked(BaselineIndex);
+}
+
 bool UReplicatedVRCameraComponent::Server_SendTransform_Validate(FBPVRComponentPosRep NewTransform)
 {
 	return true;
@@ -94,26 +116,49 @@ void UReplicatedVRCameraComponent::TickComponent(float DeltaTime, enum ELevelTic
 		// Send changes
 		if (bReplicates)
 		{
-			// Don't rep if no changes
-			if (this->RelativeLocation != ReplicatedTransform.Position || this->RelativeRotation != ReplicatedTransform.Rotation)
+			const bool bPoseChanged = this->RelativeLocation != ReplicatedTransform.Position || this->RelativeRotation != ReplicatedTransform.Rotation;
+
+			if (bPoseChanged)
 			{
 				ReplicatedTransform.Position = this->RelativeLocation;
 				ReplicatedTransform.Rotation = this->RelativeRotation;
+			}
 
-				// Don't bother with any of this if not replicating transform
-				if (GetNetMode() == NM_Client)	//if (bHasAuthority && bReplicateTransform)
+			// Don't bother with any of this if not replicating transform
+			if (GetNetMode() == NM_Client && !bTransformSentByOwner)	//if (bHasAuthority && bReplicateTransform)
+			{
+				bool bSendPose = false;
+
+				if (AdaptiveSendSettings.bUseAdaptiveSendRate)
+				{
+					bSendPose = PoseSendScheduler.ShouldSend(ReplicatedTransform.Position, ReplicatedTransform.Rotation, DeltaTime, NetUpdateRate, AdaptiveSendSettings);
+				}
+				else if (bPoseChanged) // Don't rep if no changes
 				{
 					NetUpdateCount += DeltaTime;
+					bSendPose = NetUpdateCount >= (1.0f / NetUpdateRate);
+				}
 
-					if (NetUpdateCount >= (1.0f / NetUpdateRate))
-					{
-						NetUpdateCount = 0.0f;
-						Server_SendTransform(ReplicatedTransform);
-					}
+				if (bSendPose)
+				{
+					NetUpdateCount = 0.0f;
+					PoseSendScheduler.OnPoseSent(ReplicatedTransform.Position, ReplicatedTransform.Rotation);
+
+					FBPVRComponentPosRep SendTransform = ReplicatedTransform;
+					PoseBaselineSender.PrepareForSend(SendTransform);
+					Server_SendTransform(SendTransform);
 				}
 			}
 		}
 	}
+	else if (bSmoothReplicatedMotion && ReplicatedMotionSmoothing.bUseSnapshotInterpolation)
+	{
+		FVector SampledPosition;
+		FRotator SampledRotation;
+
+		if (ReplicatedPoseBuffer.Sample(GetWorld()->GetRealTimeSeconds(), ReplicatedMotionSmoothing, SampledPosition, SampledRotation))
+			SetRelativeLocationAndRotation(SampledPosition, SampledRotation);
+	}
 }
 
 void UReplicatedVRCameraComponent::GetCameraView(float DeltaTime, FMinimalViewInfo& DesiredView)
@@ -2,6 +2,7 @@
 
 #pragma once
 #include "CoreMinimal.h"
+#include "VRPoseSnapshotBuffer.h"
 #include "ReplicatedVRCameraComponent.generated.h"
 
 
@@ -43,9 +44,22 @@ class VREXPANSIONPLUGIN_API UReplicatedVRCameraComponent : public UCameraCompone
 	UFUNCTION()
 	virtual void OnRep_ReplicatedTransform()
 	{
-		SetRelativeLocationAndRotation(ReplicatedTransform.Position, ReplicatedTransform.Rotation);
+		if (bSmoothReplicatedMotion && ReplicatedMotionSmoothing.bUseSnapshotInterpolation)
+			ReplicatedPoseBuffer.AddSnapshot(ReplicatedTransform.Position, ReplicatedTransform.Rotation, GetWorld()->GetRealTimeSeconds(), ReplicatedMotionSmoothing);
+		else
+			SetRelativeLocationAndRotation(ReplicatedTransform.Position, ReplicatedTransform.Rotation);
 	}
 
+	// Whether to smooth the replicated motion of remote cameras instead of snapping to each update
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRExpansionLibrary|Networking")
+		bool bSmoothReplicatedMotion;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRExpansionLibrary|Networking")
+		FBPVRPoseSmoothingSettings ReplicatedMotionSmoothing;
+
+	// Received poses of a remote camera, sampled in the tick when smoothing
+	FVRPoseSnapshotBuffer ReplicatedPoseBuffer;
+
 	// Rate to update the position to the server, 100htz is default (same as replication rate, should also hit every tick).
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "VRExpansionLibrary")
 	float NetUpdateRate;
@@ -57,6 +71,26 @@ class VREXPANSIONPLUGIN_API UReplicatedVRCameraComponent : public UCameraCompone
 	UFUNCTION(Unreliable, Server, WithValidation)
 	void Server_SendTransform(FBPVRComponentPosRep NewTransform);
 
+	// Set by an owning AVRBaseCharacter that sends this cameras transform in its tracked pose packet instead
+	bool bTransformSentByOwner;
+
+	// Applies a transform received on the server, either from our own RPC or from the owners tracked pose packet
+	void ReceiveTransform(const FBPVRComponentPosRep & NewTransform);
+
+	// When the owning client sends this cameras transform, NetUpdateRate is the rate used while moving fast
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRExpansionLibrary|Networking")
+		FBPVRAdaptiveSendSettings AdaptiveSendSettings;
+
+	FVRPoseSendScheduler PoseSendScheduler;
+
+	// Baseline state for ReplicatedTransform.bDeltaEncodePosition, the sender lives on the owning client and the receiver on the server
+	FVRPoseBaselineSender PoseBaselineSender;
+	FVRPoseBaselineReceiver PoseBaselineReceiver;
+
+	// Server acking a position keyframe so the client can start sending deltas against it
+	UFUNCTION(Unreliable, Client)
+	void Client_AckPoseBaseline(uint8 BaselineIndex);
+
 	// Need this as I can't think of another way for an actor component to make sure it isn't on the server
 	FORCEINLINE bool IsLocallyControlled() const
 	{
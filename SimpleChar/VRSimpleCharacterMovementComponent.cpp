@@ -6,6 +6,7 @@
 =============================================================================*/
 
 #include "VRSimpleCharacterMovementComponent.h"
+#include "VRServerMoveRecorder.h"
 #include "GameFramework/PhysicsVolume.h"
 #include "GameFramework/GameNetworkManager.h"
 #include "AI/Navigation/NavigationSystem.h"
@@ -28,6 +29,8 @@
 
 DECLARE_CYCLE_STAT(TEXT("Char ReplicateMoveToServerVRSimple"), STAT_CharacterMovementReplicateMoveToServerVRSimple, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char CallServerMoveVRSimple"), STAT_CharacterMovementCallServerMoveVRSimple, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char PerformServerMoveVRSimple"), STAT_CharacterMovementPerformServerMoveVRSimple, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char ServerMoveVRSimple Moves"), STAT_CharacterMovementServerMoveVRSimpleMoves, STATGROUP_Character);
 
 
 //#include "PerfCountersHelpers.h"
@@ -903,6 +906,9 @@ void UVRSimpleCharacterMovementComponent::PhysWalking(float deltaTime, int32 Ite
 			{
 				if (ShouldCatchAir(OldFloor, CurrentFloor))
 				{
+					if (AbortServerMovesOnWorker())
+						return;
+
 					CharacterOwner->OnWalkingOffLedge(OldFloor.HitResult.ImpactNormal, OldFloor.HitResult.Normal, OldLocation, timeTick);
 					if (IsMovingOnGround())
 					{
@@ -1075,110 +1081,48 @@ void UVRSimpleCharacterMovementComponent::CallServerMove
 
 	check(NewMove != NULL);
 
-	// Compress rotation down to 5 bytes
-	const uint32 ClientYawPitchINT = PackYawAndPitchTo32(NewMove->SavedControlRotation.Yaw, NewMove->SavedControlRotation.Pitch);
-	const uint8 ClientRollBYTE = FRotator::CompressAxisToByte(NewMove->SavedControlRotation.Roll);
-	//const uint8 CapsuleYawBYTE = FRotator::CompressAxisToByte(NewMove->VRCapsuleRotation.Yaw);
-
-	// Determine if we send absolute or relative location
-	UPrimitiveComponent* ClientMovementBase = NewMove->EndBase.Get();
-	const FName ClientBaseBone = NewMove->EndBoneName;
-	const FVector SendLocation = MovementBaseUtility::UseRelativeLocation(ClientMovementBase) ? NewMove->SavedRelativeLocation : NewMove->SavedLocation;
-
 	// send old move if it exists
 	if (OldMove)
 	{
 		ServerMoveOld(OldMove->TimeStamp, OldMove->Acceleration, OldMove->GetCompressedFlags());
 	}
 
+	FVRServerMove NewServerMove;
+	FillServerMove(NewServerMove, NewMove, true);
+	NewMove->FillServerMoveVRInput(NewServerMove);
+
+	// Sent moves are recorded on the saved move as delta baselines
+	FSavedMove_VRSimpleCharacter * SentNewMove = const_cast<FSavedMove_VRSimpleCharacter *>(NewMove);
+
 	FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
 	if (ClientData->PendingMove.IsValid())
 	{
-		const uint32 OldClientYawPitchINT = PackYawAndPitchTo32(ClientData->PendingMove->SavedControlRotation.Yaw, ClientData->PendingMove->SavedControlRotation.Pitch);
 		FSavedMove_VRSimpleCharacter* oldMove = (FSavedMove_VRSimpleCharacter*)ClientData->PendingMove.Get();
-		//const uint8 OldCapsuleYawBYTE = FRotator::CompressAxisToByte(oldMove->VRCapsuleRotation.Yaw);
+
+		FVRServerMove OldServerMove;
+		FillServerMove(OldServerMove, oldMove, false);
+		oldMove->FillServerMoveVRInput(OldServerMove);
+
+		// The old move goes against the last acked move and the new one against the old one, they always arrive together
+		PrepareServerMove(OldServerMove, oldMove, nullptr);
+		PrepareServerMove(NewServerMove, SentNewMove, oldMove);
 
 		// If we delayed a move without root motion, and our new move has root motion, send these through a special function, so the server knows how to process them.
 		if ((ClientData->PendingMove->RootMotionMontage == NULL) && (NewMove->RootMotionMontage != NULL))
 		{
 			// send two moves simultaneously
-			ServerMoveVRDualHybridRootMotion
-			(
-				ClientData->PendingMove->TimeStamp,
-				ClientData->PendingMove->Acceleration,
-				ClientData->PendingMove->GetCompressedFlags(),
-				OldClientYawPitchINT,
-				//oldMove->VRCapsuleLocation,
-				oldMove->RequestedVelocity,
-				oldMove->LFDiff,
-				oldMove->CustomVRInputVector,
-				//OldCapsuleYawBYTE,
-				NewMove->TimeStamp,
-				NewMove->Acceleration,
-				SendLocation,
-				//NewMove->VRCapsuleLocation,
-				NewMove->RequestedVelocity,
-				NewMove->LFDiff,
-				NewMove->CustomVRInputVector,
-				//CapsuleYawBYTE,
-				NewMove->GetCompressedFlags(),
-				ClientRollBYTE,
-				ClientYawPitchINT,
-				ClientMovementBase,
-				ClientBaseBone,
-				NewMove->MovementMode
-			);
+			ServerMoveVRDualHybridRootMotion(OldServerMove, NewServerMove);
 		}
 		else
 		{
 			// send two moves simultaneously
-			ServerMoveVRDual
-			(
-				ClientData->PendingMove->TimeStamp,
-				ClientData->PendingMove->Acceleration,
-				ClientData->PendingMove->GetCompressedFlags(),
-				OldClientYawPitchINT,
-				//oldMove->VRCapsuleLocation,
-				oldMove->RequestedVelocity,
-				oldMove->LFDiff,
-				oldMove->CustomVRInputVector,
-				//OldCapsuleYawBYTE,
-				NewMove->TimeStamp,
-				NewMove->Acceleration,
-				SendLocation,
-				//NewMove->VRCapsuleLocation,
-				NewMove->RequestedVelocity,
-				NewMove->LFDiff,
-				NewMove->CustomVRInputVector,
-				//CapsuleYawBYTE,
-				NewMove->GetCompressedFlags(),
-				ClientRollBYTE,
-				ClientYawPitchINT,
-				ClientMovementBase,
-				ClientBaseBone,
-				NewMove->MovementMode
-			);
+			ServerMoveVRDual(OldServerMove, NewServerMove);
 		}
 	}
 	else
 	{
-		ServerMoveVR
-		(
-			NewMove->TimeStamp,
-			NewMove->Acceleration,
-			SendLocation,
-			//NewMove->VRCapsuleLocation,
-			NewMove->RequestedVelocity,
-			NewMove->LFDiff,
-			NewMove->CustomVRInputVector,
-			//CapsuleYawBYTE,
-			NewMove->GetCompressedFlags(),
-			ClientRollBYTE,
-			ClientYawPitchINT,
-			ClientMovementBase,
-			ClientBaseBone,
-			NewMove->MovementMode
-		);
+		PrepareServerMove(NewServerMove, SentNewMove, nullptr);
+		ServerMoveVR(NewServerMove);
 	}
 
 
@@ -1282,6 +1226,9 @@ void UVRSimpleCharacterMovementComponent::ReplicateMoveToServer(float DeltaTime,
 			SaveBaseLocation();
 			NewMove->SetInitialPosition(CharacterOwner);
 
+			// The pending moves VR input was reverted with it, carry it in to the combined move
+			((FSavedMove_VRBaseCharacter*)NewMove.Get())->CombineVRInput((FSavedMove_VRBaseCharacter*)ClientData->PendingMove.Get(), CharacterOwner);
+
 			// Remove pending move from move list. It would have to be the last move on the list.
 			if (ClientData->SavedMoves.Num() > 0 && ClientData->SavedMoves.Last() == ClientData->PendingMove)
 			{
@@ -1444,6 +1391,39 @@ void FSavedMove_VRSimpleCharacter::SetInitialPosition(ACharacter* C)
 	FSavedMove_VRBaseCharacter::SetInitialPosition(C);
 }
 
+void FSavedMove_VRSimpleCharacter::FillServerMoveVRInput(FVRServerMove & ServerMove) const
+{
+	// No capsule offset to send for the simple character
+	ServerMove.SetVRInput(RequestedVelocity, LFDiff, CustomVRInputVector);
+}
+
+void FSavedMove_VRSimpleCharacter::SetVRInputFromServerMove(const FVRServerMove & ServerMove)
+{
+	FSavedMove_VRBaseCharacter::SetVRInputFromServerMove(ServerMove);
+
+	// The simple move keeps its VR input in its own fields
+	RequestedVelocity = ServerMove.GetRequestedVelocity();
+	LFDiff = ServerMove.GetLFDiff();
+	CustomVRInputVector = ServerMove.GetCustomVRInputVector();
+}
+
+void FSavedMove_VRSimpleCharacter::CombineVRInput(const FSavedMove_VRBaseCharacter * PendingMove, ACharacter * Character)
+{
+	// The simple move keeps its VR input in its own LFDiff / CustomVRInputVector, the base versions are never filled in
+	const FSavedMove_VRSimpleCharacter * SimplePendingMove = (const FSavedMove_VRSimpleCharacter *)PendingMove;
+
+	CustomVRInputVector += SimplePendingMove->CustomVRInputVector;
+	LFDiff.X += SimplePendingMove->LFDiff.X;
+	LFDiff.Y += SimplePendingMove->LFDiff.Y;
+
+	// Headset movement over both moves is what the combined move adds on to the capsule
+	if (UVRSimpleCharacterMovementComponent * CharMove = Cast<UVRSimpleCharacterMovementComponent>(Character->GetCharacterMovement()))
+	{
+		CharMove->AdditionalVRInputVector = FVector(LFDiff.X, LFDiff.Y, 0.0f);
+		CharMove->CustomVRInputVector = CustomVRInputVector;
+	}
+}
+
 void FSavedMove_VRSimpleCharacter::PrepMoveFor(ACharacter* Character)
 {
 	UVRSimpleCharacterMovementComponent * CharMove = Cast<UVRSimpleCharacterMovementComponent>(Character->GetCharacterMovement());
@@ -1462,102 +1442,95 @@ void FSavedMove_VRSimpleCharacter::PrepMoveFor(ACharacter* Character)
 }
 
 
-bool UVRSimpleCharacterMovementComponent::ServerMoveVR_Validate(float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 MoveFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+bool UVRSimpleCharacterMovementComponent::ServerMoveVR_Validate(FVRServerMove NewMove)
 {
 	return true;
 }
 
-bool UVRSimpleCharacterMovementComponent::ServerMoveVRDual_Validate(float TimeStamp0, FVector_NetQuantize10 InAccel0, uint8 PendingFlags, uint32 View0, FVector_NetQuantize100 rOldRequestedVelocity, FVector_NetQuantize100 OldLFDiff, FVector_NetQuantize100 OldCustVRInputVector, float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+bool UVRSimpleCharacterMovementComponent::ServerMoveVRDual_Validate(FVRServerMove OldMove, FVRServerMove NewMove)
 {
 	return true;
 }
 
-bool UVRSimpleCharacterMovementComponent::ServerMoveVRDualHybridRootMotion_Validate(float TimeStamp0, FVector_NetQuantize10 InAccel0, uint8 PendingFlags, uint32 View0, FVector_NetQuantize100 rOldRequestedVelocity, FVector_NetQuantize100 OldLFDiff, FVector_NetQuantize100 OldCustVRInputVector, float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+bool UVRSimpleCharacterMovementComponent::ServerMoveVRDualHybridRootMotion_Validate(FVRServerMove OldMove, FVRServerMove NewMove)
 {
 	return true;
 }
 
-void UVRSimpleCharacterMovementComponent::ServerMoveVRDual_Implementation(
-	float TimeStamp0,
-	FVector_NetQuantize10 InAccel0,
-	uint8 PendingFlags,
-	uint32 View0,
-	//FVector_NetQuantize100 OldCapsuleLoc,
-	FVector_NetQuantize100 rOldRequestedVelocity,
-	FVector_NetQuantize100 OldLFDiff,
-	FVector_NetQuantize100 OldCustVRInputVector,
-	//uint8 OldCapsuleYaw,
-	float TimeStamp,
-	FVector_NetQuantize10 InAccel,
-	FVector_NetQuantize100 ClientLoc,
-	//FVector_NetQuantize100 CapsuleLoc,
-	FVector_NetQuantize100 rRequestedVelocity,
-	FVector_NetQuantize100 LFDiff,
-	FVector_NetQuantize100 CustVRInputVector,
-	//uint8 CapsuleYaw,
-	uint8 NewFlags,
-	uint8 ClientRoll,
-	uint32 View,
-	UPrimitiveComponent* ClientMovementBase,
-	FName ClientBaseBone,
-	uint8 ClientMovementMode)
+void UVRSimpleCharacterMovementComponent::ServerMoveVRDual_Implementation(FVRServerMove OldMove, FVRServerMove NewMove)
 {
-	ServerMoveVR_Implementation(TimeStamp0, InAccel0, FVector(1.f, 2.f, 3.f), rOldRequestedVelocity, OldLFDiff, OldCustVRInputVector, PendingFlags, ClientRoll, View0, ClientMovementBase, ClientBaseBone, ClientMovementMode);
-	ServerMoveVR_Implementation(TimeStamp, InAccel, ClientLoc, rRequestedVelocity, LFDiff,CustVRInputVector, NewFlags, ClientRoll, View, ClientMovementBase, ClientBaseBone, ClientMovementMode);
+	// The new move is a delta against the old one, so they have to be resolved in order
+	if (!ServerMoveReceiver.Resolve(OldMove) || !ServerMoveReceiver.Resolve(NewMove))
+	{
+		UE_LOG(LogNetPlayerMovement, Verbose, TEXT("ServerMoveVRDual dropped, baseline for move %d not received"), (int32)OldMove.MoveId);
+		return;
+	}
+
+	QueueOrPerformServerMoveVR(OldMove);
+	QueueOrPerformServerMoveVR(NewMove);
 }
 
-void UVRSimpleCharacterMovementComponent::ServerMoveVRDualHybridRootMotion_Implementation(
-	float TimeStamp0,
-	FVector_NetQuantize10 InAccel0,
-	uint8 PendingFlags,
-	uint32 View0,
-	//FVector_NetQuantize100 OldCapsuleLoc,
-	FVector_NetQuantize100 rOldRequestedVelocity,
-	FVector_NetQuantize100 OldLFDiff,
-	FVector_NetQuantize100 OldCustVRInputVector,
-	//uint8 OldCapsuleYaw,
-	float TimeStamp,
-	FVector_NetQuantize10 InAccel,
-	FVector_NetQuantize100 ClientLoc,
-	//FVector_NetQuantize100 CapsuleLoc,
-	FVector_NetQuantize100 rRequestedVelocity,
-	FVector_NetQuantize100 LFDiff,
-	FVector_NetQuantize100 CustVRInputVector,
-	//uint8 CapsuleYaw,
-	uint8 NewFlags,
-	uint8 ClientRoll,
-	uint32 View,
-	UPrimitiveComponent* ClientMovementBase,
-	FName ClientBaseBone,
-	uint8 ClientMovementMode)
+void UVRSimpleCharacterMovementComponent::ServerMoveVRDualHybridRootMotion_Implementation(FVRServerMove OldMove, FVRServerMove NewMove)
 {
+	if (!ServerMoveReceiver.Resolve(OldMove) || !ServerMoveReceiver.Resolve(NewMove))
+	{
+		UE_LOG(LogNetPlayerMovement, Verbose, TEXT("ServerMoveVRDualHybridRootMotion dropped, baseline for move %d not received"), (int32)OldMove.MoveId);
+		return;
+	}
+
 	// First move received didn't use root motion, process it as such.
-	CharacterOwner->bServerMoveIgnoreRootMotion = CharacterOwner->IsPlayingNetworkedRootMotionMontage();
-	ServerMoveVR_Implementation(TimeStamp0, InAccel0, FVector(1.f, 2.f, 3.f), rOldRequestedVelocity, OldLFDiff, OldCustVRInputVector, PendingFlags, ClientRoll, View0, ClientMovementBase, ClientBaseBone, ClientMovementMode);
-	CharacterOwner->bServerMoveIgnoreRootMotion = false;
+	QueueOrPerformServerMoveVR(OldMove, CharacterOwner->IsPlayingNetworkedRootMotionMontage());
+	QueueOrPerformServerMoveVR(NewMove);
+}
+
+void UVRSimpleCharacterMovementComponent::ServerMoveVR_Implementation(FVRServerMove NewMove)
+{
+	if (!ServerMoveReceiver.Resolve(NewMove))
+	{
+		UE_LOG(LogNetPlayerMovement, Verbose, TEXT("ServerMoveVR dropped, baseline for move %d not received"), (int32)NewMove.MoveId);
+		return;
+	}
 
-	ServerMoveVR_Implementation(TimeStamp, InAccel, ClientLoc, rRequestedVelocity, LFDiff, CustVRInputVector, NewFlags, ClientRoll, View, ClientMovementBase, ClientBaseBone, ClientMovementMode);
+	QueueOrPerformServerMoveVR(NewMove);
 }
 
-void UVRSimpleCharacterMovementComponent::ServerMoveVR_Implementation(
-	float TimeStamp,
-	FVector_NetQuantize10 InAccel,
-	FVector_NetQuantize100 ClientLoc,
-	//FVector_NetQuantize100 CapsuleLoc,
-	FVector_NetQuantize100 rRequestedVelocity,
-	FVector_NetQuantize100 LFDiff,
-	FVector_NetQuantize100 CustVRInputVector,
-	//uint8 CapsuleYaw,
-	uint8 MoveFlags,
-	uint8 ClientRoll,
-	uint32 View,
-	UPrimitiveComponent* ClientMovementBase,
-	FName ClientBaseBoneName,
-	uint8 ClientMovementMode)
+void UVRSimpleCharacterMovementComponent::PerformServerMoveVR(const FVRServerMove & Move)
 {
+	SCOPE_CYCLE_COUNTER(STAT_CharacterMovementPerformServerMoveVRSimple);
+
+	FVRServerMoveContext Context;
+	if (!BeginServerMoveVR(Move, Context))
+		return;
+
+	if (Context.bPerformMovement)
+		MoveAutonomous(Context.TimeStamp, Context.DeltaTime, Context.MoveFlags, Context.Accel);
+
+	EndServerMoveVR(Context);
+}
+
+bool UVRSimpleCharacterMovementComponent::BeginServerMoveVR(const FVRServerMove & Move, FVRServerMoveContext & Context)
+{
+	INC_DWORD_STAT(STAT_CharacterMovementServerMoveVRSimpleMoves);
+
+	if (FVRServerMoveRecorder::IsRecording())
+		FVRServerMoveRecorder::RecordMove(this, Move);
+
+	const float TimeStamp = Move.TimeStamp;
+	FVector InAccel = Move.GetAccel();
+	const FVector ClientLoc = Move.GetClientLoc();
+	const FVector rRequestedVelocity = Move.GetRequestedVelocity();
+	const FVector LFDiff = Move.GetLFDiff();
+	const FVector CustVRInputVector = Move.GetCustomVRInputVector();
+	const uint8 MoveFlags = Move.MoveFlags;
+	const uint8 ClientRoll = Move.ClientRoll;
+	const uint32 View = Move.View;
+	UPrimitiveComponent * ClientMovementBase = Move.MovementBase.Get();
+	const FName ClientBaseBoneName = Move.BaseBoneName;
+	const uint8 ClientMovementMode = Move.MovementMode;
+
 	if (!HasValidData() || !IsComponentTickEnabled())
 	{
-		return;
+		return false;
 	}
 
 	FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character();
@@ -1565,7 +1538,7 @@ void UVRSimpleCharacterMovementComponent::ServerMoveVR_Implementation(
 
 	if (!VerifyClientTimeStamp(TimeStamp, *ServerData))
 	{
-		return;
+		return false;
 	}
 
 	bool bServerReadyForClient = true;
@@ -1602,9 +1575,18 @@ void UVRSimpleCharacterMovementComponent::ServerMoveVR_Implementation(
 
 	if (!bServerReadyForClient)
 	{
-		return;
+		return false;
 	}
 
+	Context.TimeStamp = TimeStamp;
+	Context.DeltaTime = DeltaTime;
+	Context.Accel = Accel;
+	Context.ClientLoc = ClientLoc;
+	Context.ClientMovementBase = ClientMovementBase;
+	Context.ClientBaseBoneName = ClientBaseBoneName;
+	Context.ClientMovementMode = ClientMovementMode;
+	Context.MoveFlags = MoveFlags;
+
 	// Perform actual movement
 	if ((CharacterOwner->GetWorldSettings()->Pauser == NULL) && (DeltaTime > 0.f))
 	{
@@ -1627,12 +1609,8 @@ void UVRSimpleCharacterMovementComponent::ServerMoveVR_Implementation(
 
 		CustomVRInputVector = CustVRInputVector;
 
-		MoveAutonomous(TimeStamp, DeltaTime, MoveFlags, Accel);
-		bHasRequestedVelocity = false;
+		Context.bPerformMovement = true;
 	}
 
-	UE_LOG(LogNetPlayerMovement, Verbose, TEXT("ServerMove Time %f Acceleration %s Position %s DeltaTime %f"),
-		TimeStamp, *Accel.ToString(), *UpdatedComponent->GetComponentLocation().ToString(), DeltaTime);
-
-	ServerMoveHandleClientError(TimeStamp, DeltaTime, Accel, ClientLoc, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+	return true;
 }
\ No newline at end of file
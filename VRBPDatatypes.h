@@ -3,6 +3,7 @@
 #pragma once
 #include "CoreMinimal.h"
 #include "EngineMinimal.h"
+#include "Engine/NetSerialization.h"
 
 #include "PhysicsPublic.h"
 #if WITH_PHYSX
@@ -13,6 +14,7 @@
 #include "VRBPDatatypes.generated.h"
 
 class UGripMotionControllerComponent;
+struct FBPGripList;
 
 // Custom movement modes for the characters
 UENUM(BlueprintType)
@@ -112,6 +114,123 @@ public:
 };
 
 
+namespace VRNetQuantize
+{
+	// Reads the rest of a SerializePackedVector after its leading bit count, for formats that share that field with a marker
+	template<uint32 ScaleFactor>
+	FORCEINLINE void ReadPackedVectorAfterBits(FArchive & Ar, uint32 Bits, FVector & Value)
+	{
+		const int32 Bias = 1 << (Bits + 1);
+		const uint32 Max = 1 << (Bits + 2);
+		uint32 DX = 0;
+		uint32 DY = 0;
+		uint32 DZ = 0;
+
+		Ar.SerializeInt(DX, Max);
+		Ar.SerializeInt(DY, Max);
+		Ar.SerializeInt(DZ, Max);
+
+		Value = FVector((int32)DX - Bias, (int32)DY - Bias, (int32)DZ - Bias) / (float)ScaleFactor;
+	}
+
+	// Smallest three quaternion packing, the largest component is dropped and rebuilt from the other three when loading.
+	// Costs 2 + 3 * BitsPerComponent bits, 11 bits per component is under a tenth of a degree of error.
+	FORCEINLINE void SerializeQuatSmallestThree(FArchive & Ar, FQuat & Quat, uint32 BitsPerComponent)
+	{
+		// None of the three kept components can be larger than 1/sqrt(2)
+		const float ComponentRange = 0.707106781f;
+		const uint32 MaxValue = (1 << BitsPerComponent) - 1;
+
+		uint32 LargestIndex = 0;
+		uint32 Packed[3] = { 0, 0, 0 };
+
+		if (Ar.IsSaving())
+		{
+			const FQuat NormalizedQuat = Quat.GetNormalized();
+			const float Components[4] = { NormalizedQuat.X, NormalizedQuat.Y, NormalizedQuat.Z, NormalizedQuat.W };
+
+			for (uint32 i = 1; i < 4; ++i)
+			{
+				if (FMath::Abs(Components[i]) > FMath::Abs(Components[LargestIndex]))
+					LargestIndex = i;
+			}
+
+			// q and -q are the same rotation, flip it so that the dropped component is always positive
+			const float Sign = Components[LargestIndex] < 0.0f ? -1.0f : 1.0f;
+
+			int32 PackedIndex = 0;
+			for (uint32 i = 0; i < 4; ++i)
+			{
+				if (i == LargestIndex)
+					continue;
+
+				const float Normalized = FMath::Clamp((Components[i] * Sign + ComponentRange) / (2.0f * ComponentRange), 0.0f, 1.0f);
+				Packed[PackedIndex++] = (uint32)FMath::RoundToInt(Normalized * MaxValue);
+			}
+		}
+
+		Ar.SerializeBits(&LargestIndex, 2);
+		Ar.SerializeBits(&Packed[0], BitsPerComponent);
+		Ar.SerializeBits(&Packed[1], BitsPerComponent);
+		Ar.SerializeBits(&Packed[2], BitsPerComponent);
+
+		if (Ar.IsLoading())
+		{
+			float Components[4];
+			float SumSquared = 0.0f;
+
+			int32 PackedIndex = 0;
+			for (uint32 i = 0; i < 4; ++i)
+			{
+				if (i == (LargestIndex & 3))
+					continue;
+
+				Components[i] = ((float)Packed[PackedIndex++] / MaxValue) * (2.0f * ComponentRange) - ComponentRange;
+				SumSquared += FMath::Square(Components[i]);
+			}
+
+			Components[LargestIndex & 3] = FMath::Sqrt(FMath::Max(0.0f, 1.0f - SumSquared));
+
+			Quat = FQuat(Components[0], Components[1], Components[2], Components[3]);
+			Quat.Normalize();
+		}
+	}
+
+	// Packs an integer vector with one bit count for all three components, sized to the largest of them.
+	// Components are zig zag encoded so small negative deltas cost as little as small positive ones, 5 + 3 * bits in total.
+	FORCEINLINE void SerializeIntVectorPacked(FArchive & Ar, FIntVector & Value)
+	{
+		uint32 ZigZag[3] = { 0, 0, 0 };
+		uint32 BitsMinusOne = 0;
+
+		if (Ar.IsSaving())
+		{
+			const int32 Components[3] = { Value.X, Value.Y, Value.Z };
+			uint32 Combined = 0;
+
+			for (int32 i = 0; i < 3; ++i)
+			{
+				ZigZag[i] = ((uint32)Components[i] << 1) ^ (uint32)(Components[i] >> 31);
+				Combined |= ZigZag[i];
+			}
+
+			BitsMinusOne = FMath::Max(1u, 32u - FMath::CountLeadingZeros(Combined)) - 1;
+		}
+
+		Ar.SerializeBits(&BitsMinusOne, 5);
+		Ar.SerializeBits(&ZigZag[0], BitsMinusOne + 1);
+		Ar.SerializeBits(&ZigZag[1], BitsMinusOne + 1);
+		Ar.SerializeBits(&ZigZag[2], BitsMinusOne + 1);
+
+		if (Ar.IsLoading())
+		{
+			Value.X = (int32)(ZigZag[0] >> 1) ^ -(int32)(ZigZag[0] & 1);
+			Value.Y = (int32)(ZigZag[1] >> 1) ^ -(int32)(ZigZag[1] & 1);
+			Value.Z = (int32)(ZigZag[2] >> 1) ^ -(int32)(ZigZag[2] & 1);
+		}
+	}
+}
+
 //USTRUCT(BlueprintType, Category = "VRExpansionLibrary|Transform")
 
 USTRUCT(/*noexport, */BlueprintType, Category = "VRExpansionLibrary|Transform", meta = (HasNativeMake = "VRExpansionPlugin.VRExpansionPluginFunctionLibrary.MakeTransform_NetQuantize", HasNativeBreak = "VRExpansionPlugin.VRExpansionPluginFunctionLibrary.BreakTransform_NetQuantize"))
@@ -152,60 +271,147 @@ struct FTransform_NetQuantize : public FTransform
 		: FTransform(InX, InY, InZ, InTranslation)
 	{}
 
+	// The original encoding starts with the bit count of the packed translation, 0-29, which can only be 29 for translations
+	// over 53km. Nothing inside of a world gets there, so 29 marks the versioned encoding and anything else is read as the original.
+	static const uint32 VersionedEncodingMarker = 29;
+	static const uint32 CurrentEncodingVersion = 1;
+
+	// Bits per smallest three rotation component, ~0.01 degrees of error
+	static const uint32 RotationBits = 13;
+
+	enum EScaleEncoding
+	{
+		UnitScale = 0,
+		UniformScale = 1,
+		FullScale = 2
+	};
+
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 	{
 		bOutSuccess = true;
 
+		if (Ar.IsSaving())
+		{
+			uint32 Marker = VersionedEncodingMarker;
+			Ar.SerializeInt(Marker, 30);
+			return NetSerializeVersioned(Ar, bOutSuccess);
+		}
+
+		// Shares its first field with the original encodings translation
+		uint32 MarkerOrBits = 0;
+		Ar.SerializeInt(MarkerOrBits, 30);
+
+		if (MarkerOrBits == VersionedEncodingMarker)
+			return NetSerializeVersioned(Ar, bOutSuccess);
+
+		return NetSerializeOriginal(Ar, MarkerOrBits, bOutSuccess);
+	}
+
+	// Elides unit and uniform scale, smallest three rotation, translation is still an adaptive packed vector
+	bool NetSerializeVersioned(FArchive& Ar, bool& bOutSuccess)
+	{
+		uint8 Version = CurrentEncodingVersion;
+		Ar.SerializeBits(&Version, 2);
+
 		FVector rTranslation;
 		FVector rScale3D;
-		//FQuat rRotation;
-		FRotator rRotation;
+		FQuat rRotation;
 
-		uint16 ShortPitch = 0;
-		uint16 ShortYaw = 0;
-		uint16 ShortRoll = 0;
+		uint8 ScaleEncoding = FullScale;
+		uint8 bIdentityRotation = 0;
 
 		if (Ar.IsSaving())
 		{
 			// Because transforms can be vectorized or not, need to use the inline retrievers
 			rTranslation = this->GetTranslation();
 			rScale3D = this->GetScale3D();
-			rRotation = this->Rotator();//this->GetRotation();
+			rRotation = this->GetRotation();
 
-			// Translation set to 2 decimal precision
-			bOutSuccess &= SerializePackedVector<100, 30>(rTranslation, Ar);
+			// Compared at the 2 decimal precision that a full scale would be sent at
+			const float ScaleTolerance = 0.005f;
+			if (rScale3D.Equals(FVector::OneVector, ScaleTolerance))
+				ScaleEncoding = UnitScale;
+			else if (rScale3D.AllComponentsEqual(ScaleTolerance))
+				ScaleEncoding = UniformScale;
 
-			// Scale set to 2 decimal precision, had it 1 but realized that I used two already even
-			bOutSuccess &= SerializePackedVector<100, 30>(rScale3D, Ar);
-
-			// Rotation converted to FRotator and short compressed, see below for conversion reason
-			// FRotator already serializes compressed short by default but I can save a func call here
-			rRotation.SerializeCompressedShort(Ar);
+			bIdentityRotation = rRotation.Equals(FQuat::Identity, KINDA_SMALL_NUMBER) ? 1 : 0;
+		}
 
-			//Ar << rRotation;
+		bOutSuccess &= SerializePackedVector<100, 30>(rTranslation, Ar);
 
-			// If I converted it to a rotator and serialized as shorts I would save 6 bytes.
-			// I am unsure about a safe method of compressed serializing a quat, though I read through smallest three
-			// Epic already drops W from the Quat and reconstructs it after the send.
-			// Converting to rotator first may have conversion issues and has a perf cost....needs testing, epic attempts to handle
-			// Singularities in their conversion but I haven't tested it in all circumstances
-			//rRotation.SerializeCompressedShort(Ar);
-		}
-		else // If loading
+		Ar.SerializeBits(&ScaleEncoding, 2);
+		switch (ScaleEncoding)
+		{
+		case UnitScale:
+		{
+			rScale3D = FVector::OneVector;
+		}break;
+		case UniformScale:
+		{
+			// Two decimal places, zig zagged so that small negative scales stay small
+			int32 QuantizedScale = Ar.IsSaving() ? FMath::RoundToInt(rScale3D.X * 100.0f) : 0;
+			uint32 PackedScale = (uint32)((QuantizedScale << 1) ^ (QuantizedScale >> 31));
+			Ar.SerializeIntPacked(PackedScale);
+
+			QuantizedScale = (int32)(PackedScale >> 1) ^ -(int32)(PackedScale & 1);
+			rScale3D = FVector(QuantizedScale / 100.0f);
+		}break;
+		case FullScale:
+		default:
 		{
-			bOutSuccess &= SerializePackedVector<100, 30>(rTranslation, Ar);
 			bOutSuccess &= SerializePackedVector<100, 30>(rScale3D, Ar);
+		}break;
+		}
 
-			rRotation.SerializeCompressedShort(Ar);
-
-			//Ar << rRotation;
+		Ar.SerializeBits(&bIdentityRotation, 1);
+		if (bIdentityRotation)
+			rRotation = FQuat::Identity;
+		else
+			VRNetQuantize::SerializeQuatSmallestThree(Ar, rRotation, RotationBits);
 
+		if (Ar.IsLoading())
+		{
 			// Set it
-			this->SetComponents(rRotation.Quaternion(), rTranslation, rScale3D);
+			this->SetComponents(rRotation, rTranslation, rScale3D);
 		}
 
 		return bOutSuccess;
 	}
+
+	// Reads the original encoding, kept so that data written before the versioned encoding (replays) still loads.
+	// TranslationBits is the first field, already read by NetSerialize.
+	bool NetSerializeOriginal(FArchive& Ar, uint32 TranslationBits, bool& bOutSuccess)
+	{
+		check(Ar.IsLoading());
+
+		FVector rTranslation;
+		FVector rScale3D;
+		FRotator rRotation;
+
+		// Rest of a SerializePackedVector<100, 30> after its bit count
+		{
+			const int32 Bias = 1 << (TranslationBits + 1);
+			const uint32 Max = 1 << (TranslationBits + 2);
+			uint32 DX = 0;
+			uint32 DY = 0;
+			uint32 DZ = 0;
+
+			Ar.SerializeInt(DX, Max);
+			Ar.SerializeInt(DY, Max);
+			Ar.SerializeInt(DZ, Max);
+
+			rTranslation = FVector((int32)DX - Bias, (int32)DY - Bias, (int32)DZ - Bias) / 100.0f;
+		}
+
+		bOutSuccess &= SerializePackedVector<100, 30>(rScale3D, Ar);
+
+		rRotation.SerializeCompressedShort(Ar);
+
+		// Set it
+		this->SetComponents(rRotation.Quaternion(), rTranslation, rScale3D);
+
+		return bOutSuccess;
+	}
 };
 
 template<>
@@ -227,6 +433,17 @@ enum class EVRVectorQuantization : uint8
 	RoundTwoDecimals = 1
 };
 
+// How a poses position is encoded on the wire, set by FVRPoseBaselineSender right before sending
+enum class EVRPoseBaselineMode : uint8
+{
+	// Full position
+	Absolute = 0,
+	// Full position that the receiver stores as baseline BaselineIndex and acks
+	Keyframe = 1,
+	// Position is relative to the acked baseline BaselineIndex
+	Delta = 2
+};
+
 USTRUCT()
 struct VREXPANSIONPLUGIN_API FBPVRComponentPosRep
 {
@@ -241,9 +458,74 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = Replication, AdvancedDisplay)
 		EVRVectorQuantization QuantizationLevel;
 
+	// Sends the rotation as a smallest three quaternion instead of three euler shorts
+	UPROPERTY(EditDefaultsOnly, Category = Replication, AdvancedDisplay)
+		bool bUseSmallestThreeRotation;
+
+	// Bits per smallest three component, 11 is under a tenth of a degree of error
+	UPROPERTY(EditDefaultsOnly, Category = Replication, AdvancedDisplay, meta = (editcondition = "bUseSmallestThreeRotation", ClampMin = "8", ClampMax = "15", UIMin = "8", UIMax = "15"))
+		uint8 SmallestThreeBits;
+
+	// Client to server only, sends the position relative to a baseline the server has acked. Isn't replicated, only read by the sender.
+	UPROPERTY(EditDefaultsOnly, Category = Replication, AdvancedDisplay)
+		bool bDeltaEncodePosition;
+
+	// Filled in by FVRPoseBaselineSender before sending and resolved back to absolute by FVRPoseBaselineReceiver
+	EVRPoseBaselineMode BaselineMode;
+	uint8 BaselineIndex;
+
+	// Deltas that fit in this many bits per component, at the quantization level, skip the packed vector
+	static const uint32 SmallDeltaBits = 12;
+
 	FBPVRComponentPosRep()
 	{
 		QuantizationLevel = EVRVectorQuantization::RoundTwoDecimals;
+		bUseSmallestThreeRotation = false;
+		SmallestThreeBits = 11;
+		bDeltaEncodePosition = false;
+		BaselineMode = EVRPoseBaselineMode::Absolute;
+		BaselineIndex = 0;
+	}
+
+	FORCEINLINE float GetQuantizationScale() const
+	{
+		return QuantizationLevel == EVRVectorQuantization::RoundTwoDecimals ? 100.0f : 10.0f;
+	}
+
+	// True if a delta can take the fixed size small delta path at the current quantization level
+	FORCEINLINE bool IsSmallDelta(const FVector & Delta) const
+	{
+		const float MaxQuantized = (float)((1 << (SmallDeltaBits - 1)) - 1);
+		return (Delta.GetAbsMax() * GetQuantizationScale()) < MaxQuantized;
+	}
+
+	FORCEINLINE bool SerializePosition(FVector & InOutPosition, FArchive & Ar)
+	{
+		switch (QuantizationLevel)
+		{
+		case EVRVectorQuantization::RoundTwoDecimals: return SerializePackedVector<100, 30>(InOutPosition, Ar); break;
+		case EVRVectorQuantization::RoundOneDecimal: return SerializePackedVector<10, 24>(InOutPosition, Ar); break;
+		}
+
+		return false;
+	}
+
+	FORCEINLINE uint32 GetMaxPositionBits() const
+	{
+		return QuantizationLevel == EVRVectorQuantization::RoundTwoDecimals ? 30 : 24;
+	}
+
+	// The original encoding starts with the bit count of its packed position, which only reaches its maximum for positions
+	// kilometers away from the parent. Relative poses never get there, so the maximum marks the extended encoding.
+	FORCEINLINE uint32 GetExtendedEncodingMarker() const
+	{
+		return GetMaxPositionBits() - 1;
+	}
+
+	// False if the position is far enough out that the original encodings bit count could collide with the marker
+	FORCEINLINE bool CanUseOriginalEncoding() const
+	{
+		return (Position.GetAbsMax() * GetQuantizationScale()) < (float)(1 << (GetMaxPositionBits() - 2));
 	}
 
 	/** Network serialization */
@@ -265,13 +547,17 @@ public:
 		uint16 ShortRoll = 0;
 		
 		if (Ar.IsSaving())
-		{		
-			switch (QuantizationLevel)
+		{
+			// The extended encoding writes the marker where the original encoding writes its position bit count
+			if (bUseSmallestThreeRotation || BaselineMode != EVRPoseBaselineMode::Absolute || !CanUseOriginalEncoding())
 			{
-			case EVRVectorQuantization::RoundTwoDecimals: bOutSuccess &= SerializePackedVector<100, 30>(Position, Ar); break;
-			case EVRVectorQuantization::RoundOneDecimal: bOutSuccess &= SerializePackedVector<10, 24>(Position, Ar); break;
+				uint32 Marker = GetExtendedEncodingMarker();
+				Ar.SerializeInt(Marker, GetMaxPositionBits());
+				return NetSerializeExtended(Ar, bOutSuccess);
 			}
 
+			bOutSuccess &= SerializePosition(Position, Ar);
+
 			ShortPitch = FRotator::CompressAxisToShort(Rotation.Pitch);
 			ShortYaw = FRotator::CompressAxisToShort(Rotation.Yaw);
 			ShortRoll = FRotator::CompressAxisToShort(Rotation.Roll);
@@ -283,11 +569,20 @@ public:
 		else // If loading
 		{
 			QuantizationLevel = (EVRVectorQuantization)Flags;
+			bUseSmallestThreeRotation = false;
+			BaselineMode = EVRPoseBaselineMode::Absolute;
+
+			// Shares its first field with the bit count of the original encodings packed position
+			uint32 MarkerOrBits = 0;
+			Ar.SerializeInt(MarkerOrBits, GetMaxPositionBits());
+
+			if (MarkerOrBits == GetExtendedEncodingMarker())
+				return NetSerializeExtended(Ar, bOutSuccess);
 
 			switch (QuantizationLevel)
 			{
-			case EVRVectorQuantization::RoundTwoDecimals: bOutSuccess &= SerializePackedVector<100, 30>(Position, Ar); break;
-			case EVRVectorQuantization::RoundOneDecimal: bOutSuccess &= SerializePackedVector<10, 24>(Position, Ar); break;
+			case EVRVectorQuantization::RoundTwoDecimals: VRNetQuantize::ReadPackedVectorAfterBits<100>(Ar, MarkerOrBits, Position); break;
+			case EVRVectorQuantization::RoundOneDecimal: VRNetQuantize::ReadPackedVectorAfterBits<10>(Ar, MarkerOrBits, Position); break;
 			}
 
 			Ar << ShortPitch;
@@ -302,6 +597,88 @@ public:
 		return bOutSuccess;
 	}
 
+	// Smallest three rotation and / or baseline relative position
+	bool NetSerializeExtended(FArchive& Ar, bool& bOutSuccess)
+	{
+		uint8 bSmallestThree = bUseSmallestThreeRotation ? 1 : 0;
+		Ar.SerializeBits(&bSmallestThree, 1);
+		bUseSmallestThreeRotation = bSmallestThree != 0;
+
+		uint8 Mode = (uint8)BaselineMode;
+		Ar.SerializeBits(&Mode, 2);
+		BaselineMode = (EVRPoseBaselineMode)FMath::Min<uint8>(Mode, (uint8)EVRPoseBaselineMode::Delta);
+
+		if (BaselineMode != EVRPoseBaselineMode::Absolute)
+		{
+			uint8 Index = BaselineIndex;
+			Ar.SerializeBits(&Index, 2);
+			BaselineIndex = Index;
+		}
+
+		if (BaselineMode == EVRPoseBaselineMode::Delta)
+		{
+			uint8 bSmallDelta = (Ar.IsSaving() && IsSmallDelta(Position)) ? 1 : 0;
+			Ar.SerializeBits(&bSmallDelta, 1);
+
+			if (bSmallDelta)
+			{
+				const float Scale = GetQuantizationScale();
+				const int32 Bias = 1 << (SmallDeltaBits - 1);
+
+				uint32 X = Ar.IsSaving() ? (uint32)(FMath::RoundToInt(Position.X * Scale) + Bias) : 0;
+				uint32 Y = Ar.IsSaving() ? (uint32)(FMath::RoundToInt(Position.Y * Scale) + Bias) : 0;
+				uint32 Z = Ar.IsSaving() ? (uint32)(FMath::RoundToInt(Position.Z * Scale) + Bias) : 0;
+
+				Ar.SerializeBits(&X, SmallDeltaBits);
+				Ar.SerializeBits(&Y, SmallDeltaBits);
+				Ar.SerializeBits(&Z, SmallDeltaBits);
+
+				if (Ar.IsLoading())
+					Position = FVector((int32)X - Bias, (int32)Y - Bias, (int32)Z - Bias) / Scale;
+			}
+			else
+			{
+				bOutSuccess &= SerializePosition(Position, Ar);
+			}
+		}
+		else
+		{
+			bOutSuccess &= SerializePosition(Position, Ar);
+		}
+
+		if (bUseSmallestThreeRotation)
+		{
+			uint8 BitsMinusEight = (uint8)(FMath::Clamp<uint8>(SmallestThreeBits, 8, 15) - 8);
+			Ar.SerializeBits(&BitsMinusEight, 3);
+			SmallestThreeBits = BitsMinusEight + 8;
+
+			FQuat RotationQuat = Ar.IsSaving() ? Rotation.Quaternion() : FQuat::Identity;
+			VRNetQuantize::SerializeQuatSmallestThree(Ar, RotationQuat, SmallestThreeBits);
+
+			if (Ar.IsLoading())
+				Rotation = RotationQuat.Rotator();
+		}
+		else
+		{
+			uint16 ShortPitch = FRotator::CompressAxisToShort(Rotation.Pitch);
+			uint16 ShortYaw = FRotator::CompressAxisToShort(Rotation.Yaw);
+			uint16 ShortRoll = FRotator::CompressAxisToShort(Rotation.Roll);
+
+			Ar << ShortPitch;
+			Ar << ShortYaw;
+			Ar << ShortRoll;
+
+			if (Ar.IsLoading())
+			{
+				Rotation.Pitch = FRotator::DecompressAxisFromShort(ShortPitch);
+				Rotation.Yaw = FRotator::DecompressAxisFromShort(ShortYaw);
+				Rotation.Roll = FRotator::DecompressAxisFromShort(ShortRoll);
+			}
+		}
+
+		return bOutSuccess;
+	}
+
 };
 
 template<>
@@ -313,6 +690,402 @@ struct TStructOpsTypeTraits< FBPVRComponentPosRep > : public TStructOpsTypeTrait
 	};
 };
 
+// Sender side of the pose baseline delta encoding, one per sending component.
+// Keyframes are sent to a free baseline slot and only used as a baseline once the receiver has acked that slot.
+struct FVRPoseBaselineSender
+{
+	static const int32 NumBaselines = 4;
+
+	// Packets to wait on a keyframe ack before assuming it was lost and keyframing to another slot
+	static const int32 KeyframeAckTimeout = 30;
+
+	FVector Baselines[NumBaselines];
+	int32 AckedIndex;
+	int32 PendingIndex;
+	int32 PacketsSinceKeyframe;
+
+	FVRPoseBaselineSender() :
+		AckedIndex(INDEX_NONE),
+		PendingIndex(INDEX_NONE),
+		PacketsSinceKeyframe(0)
+	{
+		for (int32 i = 0; i < NumBaselines; ++i)
+			Baselines[i] = FVector::ZeroVector;
+	}
+
+	// Sets the baseline mode of an outgoing absolute pose, converting its position to a delta when it can
+	void PrepareForSend(FBPVRComponentPosRep & Pose)
+	{
+		Pose.BaselineMode = EVRPoseBaselineMode::Absolute;
+
+		if (!Pose.bDeltaEncodePosition)
+			return;
+
+		++PacketsSinceKeyframe;
+
+		const bool bWaitingOnAck = PendingIndex != INDEX_NONE && PacketsSinceKeyframe < KeyframeAckTimeout;
+		const FVector Delta = AckedIndex != INDEX_NONE ? Pose.Position - Baselines[AckedIndex] : FVector::ZeroVector;
+
+		if (AckedIndex != INDEX_NONE && (Pose.IsSmallDelta(Delta) || bWaitingOnAck))
+		{
+			Pose.BaselineMode = EVRPoseBaselineMode::Delta;
+			Pose.BaselineIndex = (uint8)AckedIndex;
+			Pose.Position = Delta;
+		}
+
+		// Drifted out of the small delta range, or nothing acked yet, keyframe into a slot that isn't the acked one
+		if (!bWaitingOnAck && (AckedIndex == INDEX_NONE || !Pose.IsSmallDelta(Delta)))
+		{
+			int32 NewIndex = (FMath::Max(PendingIndex, AckedIndex) + 1) % NumBaselines;
+			if (NewIndex == AckedIndex)
+				NewIndex = (NewIndex + 1) % NumBaselines;
+
+			Baselines[NewIndex] = Pose.Position;
+			Pose.BaselineMode = EVRPoseBaselineMode::Keyframe;
+			Pose.BaselineIndex = (uint8)NewIndex;
+
+			PendingIndex = NewIndex;
+			PacketsSinceKeyframe = 0;
+		}
+	}
+
+	void OnBaselineAcked(uint8 Index)
+	{
+		// Late acks for a keyframe we already gave up on are ignored, that slot may have been reused
+		if ((int32)Index == PendingIndex)
+		{
+			AckedIndex = PendingIndex;
+			PendingIndex = INDEX_NONE;
+		}
+	}
+};
+
+// Receiver side of the pose baseline delta encoding
+struct FVRPoseBaselineReceiver
+{
+	FVector Baselines[FVRPoseBaselineSender::NumBaselines];
+	uint8 ValidMask;
+
+	FVRPoseBaselineReceiver() :
+		ValidMask(0)
+	{
+		for (int32 i = 0; i < FVRPoseBaselineSender::NumBaselines; ++i)
+			Baselines[i] = FVector::ZeroVector;
+	}
+
+	// Turns a received pose back into an absolute one, OutAckIndex is set if a keyframe needs to be acked.
+	// Returns false if the pose is relative to a baseline we never received and has to be dropped.
+	bool Resolve(FBPVRComponentPosRep & Pose, int32 & OutAckIndex)
+	{
+		OutAckIndex = INDEX_NONE;
+		const uint8 Index = Pose.BaselineIndex % FVRPoseBaselineSender::NumBaselines;
+
+		switch (Pose.BaselineMode)
+		{
+		case EVRPoseBaselineMode::Keyframe:
+		{
+			Baselines[Index] = Pose.Position;
+			ValidMask |= (1 << Index);
+			OutAckIndex = Index;
+		}break;
+		case EVRPoseBaselineMode::Delta:
+		{
+			if (!(ValidMask & (1 << Index)))
+				return false;
+
+			Pose.Position += Baselines[Index];
+		}break;
+		case EVRPoseBaselineMode::Absolute:
+		default:break;
+		}
+
+		Pose.BaselineMode = EVRPoseBaselineMode::Absolute;
+		return true;
+	}
+};
+
+// How remote tracked components are smoothed between replicated poses, see FVRPoseSnapshotBuffer
+USTRUCT(BlueprintType, Category = "VRExpansionLibrary")
+struct VREXPANSIONPLUGIN_API FBPVRPoseSmoothingSettings
+{
+	GENERATED_BODY()
+public:
+
+	// Buffer received poses and interpolate between them a short delay behind, instead of lerping towards the newest pose over one update interval
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking")
+		bool bUseSnapshotInterpolation;
+
+	// Size the delay from the measured update interval and its jitter, otherwise InterpolationDelay is used as is
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (EditCondition = "bUseSnapshotInterpolation"))
+		bool bAdaptiveDelay;
+
+	// Seconds behind the newest pose to render at when not adaptive, also the starting delay when adaptive
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (ClampMin = "0", UIMin = "0", EditCondition = "bUseSnapshotInterpolation"))
+		float InterpolationDelay;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (ClampMin = "0", UIMin = "0", EditCondition = "bAdaptiveDelay"))
+		float MinInterpolationDelay;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (ClampMin = "0", UIMin = "0", EditCondition = "bAdaptiveDelay"))
+		float MaxInterpolationDelay;
+
+	// Adaptive delay is the mean update interval plus this many times the arrival jitter
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (ClampMin = "0", UIMin = "0", EditCondition = "bAdaptiveDelay"))
+		float JitterDelayScale;
+
+	// How far past the newest pose to keep moving when updates run dry, the pose holds after that
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (ClampMin = "0", UIMin = "0", EditCondition = "bUseSnapshotInterpolation"))
+		float MaxExtrapolationTime;
+
+	FBPVRPoseSmoothingSettings()
+	{
+		bUseSnapshotInterpolation = true;
+		bAdaptiveDelay = true;
+		InterpolationDelay = 0.05f;
+		MinInterpolationDelay = 0.015f;
+		MaxInterpolationDelay = 0.25f;
+		JitterDelayScale = 2.0f;
+		MaxExtrapolationTime = 0.05f;
+	}
+};
+
+// When the owning client sends a tracked components pose, see FVRPoseSendScheduler
+USTRUCT(BlueprintType, Category = "VRExpansionLibrary")
+struct VREXPANSIONPLUGIN_API FBPVRAdaptiveSendSettings
+{
+	GENERATED_BODY()
+public:
+
+	// Scale the send rate with how fast the component is moving instead of always sending at the update rate.
+	// Slow motion then arrives at MinSendRate, so only enable this with snapshot interpolation on the receiving
+	// components (bSmoothReplicatedMotion and bUseSnapshotInterpolation), the fixed rate lerp and no smoothing visibly step.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking")
+		bool bUseAdaptiveSendRate;
+
+	// Rate to send at when barely moving, the update rate is used once at the speeds below
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (ClampMin = "0", UIMin = "0", EditCondition = "bUseAdaptiveSendRate"))
+		float MinSendRate;
+
+	// Linear speed in cm/s that sends at the full update rate
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (ClampMin = "0", UIMin = "0", EditCondition = "bUseAdaptiveSendRate"))
+		float LinearSpeedForMaxRate;
+
+	// Angular speed in deg/s that sends at the full update rate
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (ClampMin = "0", UIMin = "0", EditCondition = "bUseAdaptiveSendRate"))
+		float AngularSpeedForMaxRate;
+
+	// Changes from the last sent pose smaller than these are tracking noise and never sent, cm and degrees
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (ClampMin = "0", UIMin = "0", EditCondition = "bUseAdaptiveSendRate"))
+		float PositionDeadBand;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (ClampMin = "0", UIMin = "0", EditCondition = "bUseAdaptiveSendRate"))
+		float RotationDeadBand;
+
+	// Seconds between forced sends of the current pose while idle, poses are unreliable and this heals a lost final one. 0 to disable.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (ClampMin = "0", UIMin = "0", EditCondition = "bUseAdaptiveSendRate"))
+		float KeyframeInterval;
+
+	FBPVRAdaptiveSendSettings()
+	{
+		bUseAdaptiveSendRate = false;
+		MinSendRate = 10.0f;
+		LinearSpeedForMaxRate = 100.0f;
+		AngularSpeedForMaxRate = 180.0f;
+		PositionDeadBand = 0.05f;
+		RotationDeadBand = 0.1f;
+		KeyframeInterval = 1.0f;
+	}
+};
+
+// Sender side send scheduling for a tracked components pose, one per sending component.
+// Ticked every frame with the current pose, tracks the components speed and the error against the last sent pose.
+struct FVRPoseSendScheduler
+{
+	FVector LastSentPosition;
+	FQuat LastSentRotation;
+	FVector LastSamplePosition;
+	FQuat LastSampleRotation;
+	float LinearSpeed;
+	float AngularSpeed;
+	float TimeSinceSend;
+	bool bHasSample;
+	bool bHasSent;
+
+	FVRPoseSendScheduler() :
+		LastSentPosition(FVector::ZeroVector),
+		LastSentRotation(FQuat::Identity),
+		LastSamplePosition(FVector::ZeroVector),
+		LastSampleRotation(FQuat::Identity),
+		LinearSpeed(0.0f),
+		AngularSpeed(0.0f),
+		TimeSinceSend(0.0f),
+		bHasSample(false),
+		bHasSent(false)
+	{}
+
+	// Returns true if the pose should be sent this frame, call OnPoseSent if it was
+	bool ShouldSend(const FVector & Position, const FRotator & Rotation, float DeltaTime, float MaxRate, const FBPVRAdaptiveSendSettings & Settings)
+	{
+		const FQuat Quat = Rotation.Quaternion();
+		TimeSinceSend += DeltaTime;
+
+		// Weight of a new frame in the speed estimates, a single noisy tracking frame shouldn't spike the rate
+		const float SpeedSmoothing = 0.25f;
+
+		if (bHasSample && DeltaTime > SMALL_NUMBER)
+		{
+			LinearSpeed = FMath::Lerp(LinearSpeed, (Position - LastSamplePosition).Size() / DeltaTime, SpeedSmoothing);
+			AngularSpeed = FMath::Lerp(AngularSpeed, FMath::RadiansToDegrees(Quat.AngularDistance(LastSampleRotation)) / DeltaTime, SpeedSmoothing);
+		}
+
+		LastSamplePosition = Position;
+		LastSampleRotation = Quat;
+		bHasSample = true;
+
+		if (!bHasSent || (Settings.KeyframeInterval > 0.0f && TimeSinceSend >= Settings.KeyframeInterval))
+			return true;
+
+		if ((Position - LastSentPosition).Size() <= Settings.PositionDeadBand &&
+			FMath::RadiansToDegrees(Quat.AngularDistance(LastSentRotation)) <= Settings.RotationDeadBand)
+			return false;
+
+		const float Activity = FMath::Clamp(FMath::Max(
+			LinearSpeed / FMath::Max(Settings.LinearSpeedForMaxRate, KINDA_SMALL_NUMBER),
+			AngularSpeed / FMath::Max(Settings.AngularSpeedForMaxRate, KINDA_SMALL_NUMBER)), 0.0f, 1.0f);
+
+		const float SendRate = FMath::Lerp(FMath::Min(Settings.MinSendRate, MaxRate), MaxRate, Activity);
+		return SendRate > 0.0f && TimeSinceSend >= (1.0f / SendRate);
+	}
+
+	void OnPoseSent(const FVector & Position, const FRotator & Rotation)
+	{
+		LastSentPosition = Position;
+		LastSentRotation = Rotation.Quaternion();
+		TimeSinceSend = 0.0f;
+		bHasSent = true;
+	}
+};
+
+// The pose of an additional tracked component (trackers) in a tracked pose packet
+USTRUCT()
+struct VREXPANSIONPLUGIN_API FBPVRTrackedComponentPose
+{
+	GENERATED_USTRUCT_BODY()
+public:
+
+	UPROPERTY(Transient)
+		USceneComponent * Component;
+
+	UPROPERTY(Transient)
+		FBPVRComponentPosRep Pose;
+
+	FBPVRTrackedComponentPose() :
+		Component(nullptr)
+	{}
+};
+
+// Every tracked pose of a pawn sampled on the same frame, sent to the server as a single RPC
+USTRUCT()
+struct VREXPANSIONPLUGIN_API FBPVRTrackedPosePacket
+{
+	GENERATED_USTRUCT_BODY()
+public:
+
+	enum EPoseSlot
+	{
+		HMDPoseSlot = 1 << 0,
+		LeftControllerPoseSlot = 1 << 1,
+		RightControllerPoseSlot = 1 << 2
+	};
+
+	// Max number of tracker poses that fit in a packet
+	static const int32 MaxTrackerPoses = 15;
+
+	// Senders world time when the poses were sampled
+	UPROPERTY(Transient)
+		float TimeStamp;
+
+	// EPoseSlot flags of the poses that changed since the last packet and are included
+	UPROPERTY(Transient)
+		uint8 PoseMask;
+
+	// Milliseconds the sender displays other pawns tracked components behind their newest update, for lag compensation
+	UPROPERTY(Transient)
+		uint8 RemoteInterpolationDelay;
+
+	UPROPERTY(Transient)
+		FBPVRComponentPosRep HMDPose;
+
+	UPROPERTY(Transient)
+		FBPVRComponentPosRep LeftControllerPose;
+
+	UPROPERTY(Transient)
+		FBPVRComponentPosRep RightControllerPose;
+
+	UPROPERTY(Transient)
+		TArray<FBPVRTrackedComponentPose> TrackerPoses;
+
+	FBPVRTrackedPosePacket() :
+		TimeStamp(0.0f),
+		PoseMask(0),
+		RemoteInterpolationDelay(0)
+	{}
+
+	bool IsEmpty() const
+	{
+		return !PoseMask && !TrackerPoses.Num();
+	}
+
+	/** Network serialization */
+	// Only the included poses are written, the mask, interpolation delay and tracker count cost 15 bits
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		bOutSuccess = true;
+		bool bPoseSuccess = true;
+
+		Ar << TimeStamp;
+		Ar.SerializeBits(&PoseMask, 3);
+		Ar << RemoteInterpolationDelay;
+
+		if (PoseMask & HMDPoseSlot)
+			bOutSuccess &= HMDPose.NetSerialize(Ar, Map, bPoseSuccess);
+
+		if (PoseMask & LeftControllerPoseSlot)
+			bOutSuccess &= LeftControllerPose.NetSerialize(Ar, Map, bPoseSuccess);
+
+		if (PoseMask & RightControllerPoseSlot)
+			bOutSuccess &= RightControllerPose.NetSerialize(Ar, Map, bPoseSuccess);
+
+		uint8 NumTrackers = (uint8)FMath::Min(TrackerPoses.Num(), MaxTrackerPoses);
+		Ar.SerializeBits(&NumTrackers, 4);
+
+		if (Ar.IsLoading())
+			TrackerPoses.SetNum(NumTrackers);
+
+		for (int32 i = 0; i < NumTrackers; ++i)
+		{
+			UObject * TrackedComponent = TrackerPoses[i].Component;
+
+			if (Map)
+				bOutSuccess &= Map->SerializeObject(Ar, USceneComponent::StaticClass(), TrackedComponent);
+
+			TrackerPoses[i].Component = Cast<USceneComponent>(TrackedComponent);
+			bOutSuccess &= TrackerPoses[i].Pose.NetSerialize(Ar, Map, bPoseSuccess);
+		}
+
+		return bOutSuccess;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits< FBPVRTrackedPosePacket > : public TStructOpsTypeTraitsBase2<FBPVRTrackedPosePacket>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
 /*
 Interactive Collision With Physics = Held items can be offset by geometry, uses physics for the offset, pushes physics simulating objects with weight taken into account
 Interactive Collision With Sweep = Held items can be offset by geometry, uses sweep for the offset, pushes physics simulating objects, no weight
@@ -455,10 +1228,15 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AdvancedPhysicsSettings", meta = (editcondition = "bUseCustomAngularValues", ClampMin = "0.000", UIMin = "0.000"))
 		float AngularDamping;
 
+	// Always sweep SweepWithPhysics grips in the same frame, even when vr.GripAsyncSweeps is enabled
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AdvancedPhysicsSettings", meta = (editcondition = "bUseAdvancedPhysicsSettings"))
+		bool bPrecisionCriticalSweep;
+
 	FBPAdvGripPhysicsSettings()
 	{
 		bUseAdvancedPhysicsSettings = false;
 		bUseCustomAngularValues = false;
+		bPrecisionCriticalSweep = false;
 		//bSetCOMToGripLocation = false;
 		AngularStiffness = 0.0f;
 		AngularDamping = 0.0f;
@@ -472,6 +1250,7 @@ public:
 			bUseCustomAngularValues == Other.bUseCustomAngularValues &&
 			FMath::IsNearlyEqual(AngularStiffness, Other.AngularStiffness) &&
 			FMath::IsNearlyEqual(AngularDamping, Other.AngularDamping) &&
+			bPrecisionCriticalSweep == Other.bPrecisionCriticalSweep &&
 			PhysicsConstraintType == Other.PhysicsConstraintType);
 	}
 
@@ -482,6 +1261,7 @@ public:
 			bUseCustomAngularValues != Other.bUseCustomAngularValues ||
 			!FMath::IsNearlyEqual(AngularStiffness, Other.AngularStiffness) ||
 			!FMath::IsNearlyEqual(AngularDamping, Other.AngularDamping) ||
+			bPrecisionCriticalSweep != Other.bPrecisionCriticalSweep ||
 			PhysicsConstraintType != Other.PhysicsConstraintType);
 	}
 
@@ -502,6 +1282,8 @@ public:
 				Ar << AngularStiffness;
 				Ar << AngularDamping;
 			}
+
+			Ar << bPrecisionCriticalSweep;
 		}
 
 		bOutSuccess = true;
@@ -600,41 +1382,150 @@ public:
 };
 
 
+// Cached values - since not using a full serialize now the old array state may not contain what i need to diff
+// I set these in On_Rep now and check against them when new replications happen to control some actions.
+// These are kept in a side table on the motion controller instead of on the grip itself, they are only read
+// during replication and were bloating the grip struct that the tick walks every frame.
+struct VREXPANSIONPLUGIN_API FGripValueCache
+{
+	bool bWasInitiallyRepped;
+	bool bCachedHasSecondaryAttachment;
+	FVector CachedSecondaryRelativeLocation;
+	EGripCollisionType CachedGripCollisionType;
+	EGripMovementReplicationSettings CachedGripMovementReplicationSetting;
+	float CachedStiffness;
+	float CachedDamping;
+	FBPAdvGripPhysicsSettings CachedAdvancedPhysicsSettings;
+
+	FGripValueCache()
+	{
+		// Since i'm not full serializing now I need to check against cached values
+		// The OnRep last value only holds delta now so finding object off of it will not work
+		bWasInitiallyRepped = false;
+		bCachedHasSecondaryAttachment = false;
+		CachedSecondaryRelativeLocation = FVector::ZeroVector;
+		CachedGripCollisionType = EGripCollisionType::InteractiveCollisionWithSweep;
+		CachedGripMovementReplicationSetting = EGripMovementReplicationSettings::ForceClientSideMovement;
+		CachedStiffness = 1500.0f;
+		CachedDamping = 200.0f;
+	}
+};
+
+class IVRGripInterfaceNative;
+
+// Slot of a grips physics handle in the holding controllers PhysicsGrips, so lookups don't have to search for it.
+// Slots are reused once freed, the generation tells a reused slot apart from the one this was set for.
+struct VREXPANSIONPLUGIN_API FGripPhysicsHandleRef
+{
+	int32 Slot;
+	uint32 Generation;
+
+	FGripPhysicsHandleRef()
+	{
+		Reset();
+	}
+
+	FORCEINLINE void Reset()
+	{
+		Slot = INDEX_NONE;
+		Generation = 0;
+	}
+};
+
+// Grip interface state, resolved the first time the grip is processed instead of checking the classes and going
+// through the blueprint event thunks every tick. Reset with MarkGripInterfaceDirty on the holding controller.
+struct VREXPANSIONPLUGIN_API FGripInterfaceCache
+{
+	// The root and actor this was resolved against, a change in either re-resolves it
+	const UObject * CachedRoot;
+	const UObject * CachedActor;
+
+	// Object that answers the interface queries, root is checked before the actor
+	UObject * InterfaceObject;
+
+	// Valid if the interface object is native and the per tick queries aren't overridden in blueprint
+	IVRGripInterfaceNative * NativeInterface;
+
+	// Valid if TickGrip isn't overridden in blueprint on the root / actor
+	IVRGripInterfaceNative * RootTickNative;
+	IVRGripInterfaceNative * ActorTickNative;
+
+	bool bIsValid;
+	bool bRootHasInterface;
+	bool bActorHasInterface;
+
+	// Answers cached from blueprint implementers, native implementers are queried directly
+	bool bIsInteractible;
+	ESecondaryGripType SecondaryGripType;
+	float BreakDistance;
+
+	FGripInterfaceCache()
+	{
+		Reset();
+	}
+
+	FORCEINLINE void Reset()
+	{
+		CachedRoot = nullptr;
+		CachedActor = nullptr;
+		InterfaceObject = nullptr;
+		NativeInterface = nullptr;
+		RootTickNative = nullptr;
+		ActorTickNative = nullptr;
+		bIsValid = false;
+		bRootHasInterface = false;
+		bActorHasInterface = false;
+		bIsInteractible = false;
+		SecondaryGripType = ESecondaryGripType::SG_None;
+		BreakDistance = 0.0f;
+	}
+};
+
 USTRUCT(BlueprintType, Category = "VRExpansionLibrary")
-struct VREXPANSIONPLUGIN_API FBPActorGripInformation
+struct VREXPANSIONPLUGIN_API FBPActorGripInformation : public FFastArraySerializerItem
 {
 	GENERATED_BODY()
 public:
 
-	UPROPERTY(BlueprintReadOnly)
-		EGripTargetType GripTargetType;
+	// Members are ordered by how often the grip tick touches them, everything read per frame is packed
+	// up front and the settings that only matter on grip / drop / replication are at the end.
+
 	UPROPERTY(BlueprintReadOnly)
 		UObject * GrippedObject;
+	UPROPERTY(BlueprintReadOnly)
+		EGripTargetType GripTargetType;
 	UPROPERTY(BlueprintReadOnly)
 		EGripCollisionType GripCollisionType;
 	UPROPERTY(BlueprintReadWrite)
 		EGripLateUpdateSettings GripLateUpdateSetting;
+	UPROPERTY(BlueprintReadOnly)
+		EGripMovementReplicationSettings GripMovementReplicationSetting;
 	UPROPERTY(BlueprintReadOnly, NotReplicated)
 		bool bColliding;
-	UPROPERTY(BlueprintReadWrite)
-		FTransform_NetQuantize RelativeTransform;
 
+	// For multi grip situations
 	UPROPERTY(BlueprintReadOnly)
-		EGripMovementReplicationSettings GripMovementReplicationSetting;
-	UPROPERTY(BlueprintReadOnly)
-		bool bOriginalReplicatesMovement;
+		bool bHasSecondaryAttachment;
 
-	UPROPERTY()
-		float Damping;
-	UPROPERTY()
-		float Stiffness;
+	// These are not replicated, they don't need to be
+	EGripLerpState GripLerpState;
+
+	// Locked transitions for swept movement so they don't just rotate in place on contact
+	bool bIsLocked;
+
+	float curLerp;
 
+	// Lerp transitions
+	// Max value is 16 seconds with two decimal precision, this is to reduce replication overhead
 	UPROPERTY()
-		FBPAdvGripPhysicsSettings AdvancedPhysicsSettings;
+		float LerpToRate;
 
-	// For multi grip situations
-	UPROPERTY(BlueprintReadOnly)
-		bool bHasSecondaryAttachment;
+	UPROPERTY(BlueprintReadWrite)
+		FTransform_NetQuantize RelativeTransform;
+
+	// Optional Additive Transform for programmatic animation
+	UPROPERTY(BlueprintReadWrite, NotReplicated)
+		FTransform AdditionTransform;
 
 	UPROPERTY(BlueprintReadOnly)
 		USceneComponent * SecondaryAttachment;
@@ -643,59 +1534,41 @@ public:
 	UPROPERTY()
 		FVector_NetQuantize100 SecondaryRelativeLocation;
 
-	// Lerp transitions
-	// Max value is 16 seconds with two decimal precision, this is to reduce replication overhead
-	UPROPERTY()
-		float LerpToRate;
-
-	// These are not replicated, they don't need to be
-	EGripLerpState GripLerpState;
-	float curLerp;
-
 	// Store values for frame by frame changes of secondary grips
 	FVector LastRelativeLocation;
 
-	// Optional Additive Transform for programmatic animation
-	UPROPERTY(BlueprintReadWrite, NotReplicated)
-	FTransform AdditionTransform;
-
-	// Locked transitions for swept movement so they don't just rotate in place on contact
-	bool bIsLocked;
 	FQuat LastLockedRotation;
 
-	// Cached values - since not using a full serialize now the old array state may not contain what i need to diff
-	// I set these in On_Rep now and check against them when new replications happen to control some actions.
-	struct FGripValueCache
-	{
-		bool bWasInitiallyRepped;
-		bool bCachedHasSecondaryAttachment;
-		FVector CachedSecondaryRelativeLocation;
-		EGripCollisionType CachedGripCollisionType;
-		EGripMovementReplicationSettings CachedGripMovementReplicationSetting;
-		float CachedStiffness;
-		float CachedDamping;
-		FBPAdvGripPhysicsSettings CachedAdvancedPhysicsSettings;
+	// Not replicated, each side resolves this itself
+	FGripInterfaceCache InterfaceCache;
 
-		FGripValueCache()
-		{
-			// Since i'm not full serializing now I need to check against cached values
-			// The OnRep last value only holds delta now so finding object off of it will not work
-			bWasInitiallyRepped = false;
-			bCachedHasSecondaryAttachment = false;
-			CachedSecondaryRelativeLocation = FVector::ZeroVector;
-			CachedGripCollisionType = EGripCollisionType::InteractiveCollisionWithSweep;
-			CachedGripMovementReplicationSetting = EGripMovementReplicationSettings::ForceClientSideMovement;
-			CachedStiffness = 1500.0f;
-			CachedDamping = 200.0f;
-		}
+	// Not replicated, only a lookup hint that gets repaired when it is found to be stale so it is mutable
+	mutable FGripPhysicsHandleRef PhysicsHandle;
+
+	// Cold data, only read when setting up / changing / dropping the grip
+
+	UPROPERTY(BlueprintReadOnly)
+		bool bOriginalReplicatesMovement;
+
+	UPROPERTY()
+		float Damping;
+	UPROPERTY()
+		float Stiffness;
 
-	}ValueCache;
+	UPROPERTY()
+		FBPAdvGripPhysicsSettings AdvancedPhysicsSettings;
 
 	FORCEINLINE AActor * GetGrippedActor() const
 	{
 		return Cast<AActor>(GrippedObject);
 	}
 
+	// Fast array callbacks for grips in FBPGripList, these run in the middle of receiving the array so they only
+	// queue the grip up on the owning controller, OnRep_GrippedActors does the actual grip / change / drop.
+	void PreReplicatedRemove(const FBPGripList & InArraySerializer);
+	void PostReplicatedAdd(const FBPGripList & InArraySerializer);
+	void PostReplicatedChange(const FBPGripList & InArraySerializer);
+
 	FORCEINLINE UPrimitiveComponent * GetGrippedComponent() const
 	{
 		return Cast<UPrimitiveComponent>(GrippedObject);
@@ -746,7 +1619,10 @@ public:
 		GripCollisionType = EGripCollisionType::InteractiveCollisionWithSweep;
 		GripLateUpdateSetting = EGripLateUpdateSettings::NotWhenCollidingOrDoubleGripping;
 		GripMovementReplicationSetting = EGripMovementReplicationSettings::ForceClientSideMovement;
+		bOriginalReplicatesMovement = false;
 		bIsLocked = false;
+		LastLockedRotation = FQuat::Identity;
+		LastRelativeLocation = FVector::ZeroVector;
 		curLerp = 0.0f;
 		LerpToRate = 0.0f;
 		GripLerpState = EGripLerpState::NotLerping;
@@ -834,6 +1710,85 @@ struct TStructOpsTypeTraits< FBPActorGripInformation > : public TStructOpsTypeTr
 	};
 };*/
 
+// Replicated grip array, delta serialized so that only grips that were added, removed or changed get sent.
+// Mirrors the parts of the TArray interface that the controller uses, the modifying functions mark the array
+// dirty for replication so anything that edits a grip in place on the server needs to call MarkGripDirty after.
+USTRUCT(BlueprintType, Category = "VRExpansionLibrary")
+struct VREXPANSIONPLUGIN_API FBPGripList : public FFastArraySerializer
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(BlueprintReadOnly)
+		TArray<FBPActorGripInformation> Items;
+
+	// Not replicated, set by the controller that owns the list so the item callbacks can reach it
+	UGripMotionControllerComponent * OwningController;
+
+	FBPGripList() :
+		OwningController(nullptr)
+	{}
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo & DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FBPActorGripInformation, FBPGripList>(Items, DeltaParms, *this);
+	}
+
+	// Flags a grip that was edited in place for replication, does nothing for grips that aren't in this list
+	FORCEINLINE void MarkGripDirty(FBPActorGripInformation & Grip)
+	{
+		if (&Grip >= Items.GetData() && &Grip < Items.GetData() + Items.Num())
+			MarkItemDirty(Grip);
+	}
+
+	FORCEINLINE int32 Add(const FBPActorGripInformation & NewGrip)
+	{
+		int32 NewIndex = Items.Add(NewGrip);
+
+		// Grips get copied between the local and replicated lists, never carry over an id from somewhere else
+		Items[NewIndex].ReplicationID = INDEX_NONE;
+		Items[NewIndex].ReplicationKey = INDEX_NONE;
+		Items[NewIndex].MostRecentArrayReplicationKey = INDEX_NONE;
+		MarkItemDirty(Items[NewIndex]);
+
+		return NewIndex;
+	}
+
+	FORCEINLINE void RemoveAt(int32 Index)
+	{
+		Items.RemoveAt(Index);
+		MarkArrayDirty();
+	}
+
+	FORCEINLINE void Empty()
+	{
+		Items.Empty();
+		MarkArrayDirty();
+	}
+
+	FORCEINLINE int32 Num() const { return Items.Num(); }
+	FORCEINLINE bool IsValidIndex(int32 Index) const { return Items.IsValidIndex(Index); }
+	FORCEINLINE FBPActorGripInformation & operator[](int32 Index) { return Items[Index]; }
+	FORCEINLINE const FBPActorGripInformation & operator[](int32 Index) const { return Items[Index]; }
+
+	template <typename ComparisonType>
+	FORCEINLINE bool Contains(const ComparisonType & Item) const { return Items.Contains(Item); }
+
+	FORCEINLINE FBPActorGripInformation * begin() { return Items.GetData(); }
+	FORCEINLINE FBPActorGripInformation * end() { return Items.GetData() + Items.Num(); }
+	FORCEINLINE const FBPActorGripInformation * begin() const { return Items.GetData(); }
+	FORCEINLINE const FBPActorGripInformation * end() const { return Items.GetData() + Items.Num(); }
+};
+
+template<>
+struct TStructOpsTypeTraits< FBPGripList > : public TStructOpsTypeTraitsBase2<FBPGripList>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true
+	};
+};
+
 USTRUCT(BlueprintType, Category = "VRExpansionLibrary")
 struct VREXPANSIONPLUGIN_API FBPInterfaceProperties
 {
@@ -942,8 +1897,12 @@ public:
 
 	physx::PxTransform COMPosition;
 
+	/** Unique per handle on the owning controller, checked against FGripPhysicsHandleRef::Generation */
+	uint32 Generation;
+
 	FBPActorPhysicsHandleInformation()
 	{
+		Generation = 0;
 		HandleData = NULL;
 		KinActorData = NULL;		
 		HandledObject = nullptr;
@@ -2,6 +2,10 @@
 
 #include "VRBaseCharacter.h"
 #include "VRPathFollowingComponent.h"
+#include "GripMotionControllerComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "Engine/NetConnection.h"
+#include "EngineUtils.h"
 //#include "Runtime/Engine/Private/EnginePrivate.h"
 
 FName AVRBaseCharacter::LeftMotionControllerComponentName(TEXT("Left Grip Motion Controller"));
@@ -88,6 +92,328 @@ AVRBaseCharacter::AVRBaseCharacter(const FObjectInitializer& ObjectInitializer)
 	// Setting a minimum of every frame for replication consideration (UT uses this value for characters and projectiles).
 	// Otherwise we will get some massive slow downs if the replication is allowed to hit the 2 per second minimum default
 	MinNetUpdateFrequency = 100.0f;
+
+	bUseUnifiedPoseReplication = true;
+	PoseNetUpdateRate = 100.0f; // 100 htz is default
+	PoseNetUpdateCount = 0.0f;
+	LastReceivedPoseTimeStamp = -1.0f;
+
+	bRecordPoseHistory = false;
+	ClientTransitOffset = 0.0f;
+	bHasClientTransitOffset = false;
+	ClientRemoteInterpolationDelay = 0.0f;
+	RemoteInterpolationDelay = 0.0f;
+	RemoteInterpolationDelayUpdateTime = -1.0f;
+
+	// Runs after every component has ticked so the packet samples them all on the same frame, and before the net driver flushes
+	PoseReplicationTick.bCanEverTick = true;
+	PoseReplicationTick.bStartWithTickEnabled = true;
+	PoseReplicationTick.TickGroup = TG_PostUpdateWork;
+}
+
+void FVRPoseReplicationTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target && !Target->IsPendingKill() && TickType != LEVELTICK_ViewportsOnly)
+	{
+		Target->TickPoseReplication(DeltaTime);
+	}
+}
+
+FString FVRPoseReplicationTickFunction::DiagnosticMessage()
+{
+	return Target ? Target->GetFullName() + TEXT("[PoseReplicationTick]") : TEXT("<NULL>[PoseReplicationTick]");
+}
+
+void AVRBaseCharacter::RegisterActorTickFunctions(bool bRegister)
+{
+	Super::RegisterActorTickFunctions(bRegister);
+
+	if (bRegister)
+	{
+		if (PoseReplicationTick.bCanEverTick)
+		{
+			PoseReplicationTick.Target = this;
+			PoseReplicationTick.SetTickFunctionEnable(PoseReplicationTick.bStartWithTickEnabled);
+			PoseReplicationTick.RegisterTickFunction(GetLevel());
+		}
+	}
+	else if (PoseReplicationTick.IsTickFunctionRegistered())
+	{
+		PoseReplicationTick.UnRegisterTickFunction();
+	}
+}
+
+void AVRBaseCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// The client time offset comes from the tracked pose packet, without it client time stamps can't be mapped for rewinds
+	if (bRecordPoseHistory && !bUseUnifiedPoseReplication && Role == ROLE_Authority)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s has bRecordPoseHistory set without bUseUnifiedPoseReplication, GetServerTimeForClientTime will return the current server time instead of what the client saw"), *GetName());
+	}
+
+	if (!bUseUnifiedPoseReplication)
+	{
+		if (!bRecordPoseHistory)
+			PoseReplicationTick.SetTickFunctionEnable(false);
+
+		return;
+	}
+
+	if (VRReplicatedCamera)
+		VRReplicatedCamera->bTransformSentByOwner = true;
+
+	// Remotes smooth by the controllers update rate, keep it matching what we actually send at
+	if (LeftMotionController)
+	{
+		LeftMotionController->bTransformSentByOwner = true;
+
+		if (Role == ROLE_Authority)
+			LeftMotionController->ControllerNetUpdateRate = PoseNetUpdateRate;
+	}
+
+	if (RightMotionController)
+	{
+		RightMotionController->bTransformSentByOwner = true;
+
+		if (Role == ROLE_Authority)
+			RightMotionController->ControllerNetUpdateRate = PoseNetUpdateRate;
+	}
+}
+
+void AVRBaseCharacter::AddTrackedPoseComponent(UGripMotionControllerComponent * TrackedComponent)
+{
+	if (!bUseUnifiedPoseReplication || !TrackedComponent || TrackedComponent->GetOwner() != this || AdditionalTrackedPoseComponents.Contains(TrackedComponent))
+		return;
+
+	if (AdditionalTrackedPoseComponents.Num() >= FBPVRTrackedPosePacket::MaxTrackerPoses)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("AddTrackedPoseComponent - Tracked pose packet is full, %s will keep sending its own transform"), *TrackedComponent->GetName());
+		return;
+	}
+
+	TrackedComponent->bTransformSentByOwner = true;
+
+	if (Role == ROLE_Authority)
+		TrackedComponent->ControllerNetUpdateRate = PoseNetUpdateRate;
+
+	AdditionalTrackedPoseComponents.Add(TrackedComponent);
+	LastSentTrackerPoses.AddDefaulted();
+}
+
+void AVRBaseCharacter::RemoveTrackedPoseComponent(UGripMotionControllerComponent * TrackedComponent)
+{
+	int32 TrackedIndex = AdditionalTrackedPoseComponents.Find(TrackedComponent);
+
+	if (TrackedIndex == INDEX_NONE)
+		return;
+
+	if (TrackedComponent)
+		TrackedComponent->bTransformSentByOwner = false;
+
+	AdditionalTrackedPoseComponents.RemoveAt(TrackedIndex);
+	LastSentTrackerPoses.RemoveAt(TrackedIndex);
+}
+
+namespace
+{
+	/** Copies a components replicated transform into the packet if it changed since it was last sent */
+	bool PackPoseIfChanged(const FBPVRComponentPosRep & CurrentPose, FBPVRComponentPosRep & LastSentPose, FBPVRComponentPosRep & OutPose)
+	{
+		if (CurrentPose.Position == LastSentPose.Position && CurrentPose.Rotation == LastSentPose.Rotation)
+			return false;
+
+		LastSentPose = CurrentPose;
+		OutPose = CurrentPose;
+		return true;
+	}
+
+	/** Copies a components replicated transform into the packet if its send scheduler says it is due, or if it changed and the fixed rate is due */
+	bool PackPoseIfDue(FVRPoseSendScheduler & Scheduler, const FBPVRAdaptiveSendSettings & Settings, const FBPVRComponentPosRep & CurrentPose, FBPVRComponentPosRep & LastSentPose, FBPVRComponentPosRep & OutPose, float DeltaTime, float MaxRate, bool bFixedRateDue)
+	{
+		if (!Settings.bUseAdaptiveSendRate)
+			return bFixedRateDue && PackPoseIfChanged(CurrentPose, LastSentPose, OutPose);
+
+		if (!Scheduler.ShouldSend(CurrentPose.Position, CurrentPose.Rotation, DeltaTime, MaxRate, Settings))
+			return false;
+
+		Scheduler.OnPoseSent(CurrentPose.Position, CurrentPose.Rotation);
+		LastSentPose = CurrentPose;
+		OutPose = CurrentPose;
+		return true;
+	}
+}
+
+void AVRBaseCharacter::TickPoseReplication(float DeltaTime)
+{
+	// After movement and every tracked component has ticked, so the frame is what the hit tests would have seen
+	if (bRecordPoseHistory && Role == ROLE_Authority)
+	{
+		const FTransform RootTransform = GetRootComponent() ? GetRootComponent()->GetComponentTransform() : GetActorTransform();
+
+		PoseHistory.Record(GetWorld()->GetTimeSeconds(), RootTransform,
+			VRReplicatedCamera ? VRReplicatedCamera->GetComponentTransform() : RootTransform,
+			LeftMotionController ? LeftMotionController->GetComponentTransform() : RootTransform,
+			RightMotionController ? RightMotionController->GetComponentTransform() : RootTransform);
+	}
+
+	if (!bUseUnifiedPoseReplication || GetNetMode() != NM_Client || !IsLocallyControlled() || PoseNetUpdateRate <= 0.0f)
+		return;
+
+	PoseNetUpdateCount += DeltaTime;
+
+	// Components on an adaptive send rate get checked every frame, the rest only at the fixed rate
+	const bool bFixedRateDue = PoseNetUpdateCount >= (1.0f / PoseNetUpdateRate);
+
+	// The components keep their replicated transforms up to date during their own ticks, only when they are tracked and replicating
+	FBPVRTrackedPosePacket Packet;
+
+	if (VRReplicatedCamera && VRReplicatedCamera->GetIsReplicated() && PackPoseIfDue(VRReplicatedCamera->PoseSendScheduler, VRReplicatedCamera->AdaptiveSendSettings,
+		VRReplicatedCamera->ReplicatedTransform, LastSentPoses.HMDPose, Packet.HMDPose, DeltaTime, PoseNetUpdateRate, bFixedRateDue))
+	{
+		VRReplicatedCamera->PoseBaselineSender.PrepareForSend(Packet.HMDPose);
+		Packet.PoseMask |= FBPVRTrackedPosePacket::HMDPoseSlot;
+	}
+
+	if (LeftMotionController && LeftMotionController->GetIsReplicated() && PackPoseIfDue(LeftMotionController->PoseSendScheduler, LeftMotionController->AdaptiveSendSettings,
+		LeftMotionController->ReplicatedControllerTransform, LastSentPoses.LeftControllerPose, Packet.LeftControllerPose, DeltaTime, PoseNetUpdateRate, bFixedRateDue))
+	{
+		LeftMotionController->PoseBaselineSender.PrepareForSend(Packet.LeftControllerPose);
+		Packet.PoseMask |= FBPVRTrackedPosePacket::LeftControllerPoseSlot;
+	}
+
+	if (RightMotionController && RightMotionController->GetIsReplicated() && PackPoseIfDue(RightMotionController->PoseSendScheduler, RightMotionController->AdaptiveSendSettings,
+		RightMotionController->ReplicatedControllerTransform, LastSentPoses.RightControllerPose, Packet.RightControllerPose, DeltaTime, PoseNetUpdateRate, bFixedRateDue))
+	{
+		RightMotionController->PoseBaselineSender.PrepareForSend(Packet.RightControllerPose);
+		Packet.PoseMask |= FBPVRTrackedPosePacket::RightControllerPoseSlot;
+	}
+
+	for (int32 i = 0; i < AdditionalTrackedPoseComponents.Num(); ++i)
+	{
+		UGripMotionControllerComponent * TrackedComponent = AdditionalTrackedPoseComponents[i];
+		FBPVRComponentPosRep TrackerPose;
+
+		if (TrackedComponent && TrackedComponent->GetIsReplicated() && PackPoseIfDue(TrackedComponent->PoseSendScheduler, TrackedComponent->AdaptiveSendSettings,
+			TrackedComponent->ReplicatedControllerTransform, LastSentTrackerPoses[i], TrackerPose, DeltaTime, PoseNetUpdateRate, bFixedRateDue))
+		{
+			FBPVRTrackedComponentPose & NewTrackerPose = Packet.TrackerPoses[Packet.TrackerPoses.AddDefaulted()];
+			NewTrackerPose.Component = TrackedComponent;
+			NewTrackerPose.Pose = TrackerPose;
+			TrackedComponent->PoseBaselineSender.PrepareForSend(NewTrackerPose.Pose);
+		}
+	}
+
+	// Don't rep if no changes
+	if (Packet.IsEmpty())
+		return;
+
+	if (bFixedRateDue)
+		PoseNetUpdateCount = 0.0f;
+
+	Packet.TimeStamp = GetWorld()->GetTimeSeconds();
+	Packet.RemoteInterpolationDelay = (uint8)FMath::Clamp(FMath::RoundToInt(GetRemoteInterpolationDelay() * 1000.0f), 0, 255);
+	Server_SendTrackedPoses(Packet);
+}
+
+float AVRBaseCharacter::GetClientClockOffset() const
+{
+	const UNetConnection * Connection = GetNetConnection();
+	const float OneWayLatency = Connection ? Connection->AvgLag * 0.5f : 0.0f;
+
+	return ClientTransitOffset - OneWayLatency;
+}
+
+float AVRBaseCharacter::GetServerTimeForClientTime(float ClientTime) const
+{
+	if (!bHasClientTransitOffset)
+		return GetWorld()->GetTimeSeconds();
+
+	const UNetConnection * Connection = GetNetConnection();
+	const float ServerToClientLatency = Connection ? Connection->AvgLag * 0.5f : 0.0f;
+
+	return ClientTime + GetClientClockOffset() - ServerToClientLatency - ClientRemoteInterpolationDelay;
+}
+
+float AVRBaseCharacter::GetRemoteInterpolationDelay()
+{
+	// Only changes as the remote buffers adapt, no need to walk the pawns for every packet
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+	if (RemoteInterpolationDelayUpdateTime >= 0.0f && WorldTime - RemoteInterpolationDelayUpdateTime < 1.0f)
+		return RemoteInterpolationDelay;
+
+	RemoteInterpolationDelayUpdateTime = WorldTime;
+
+	float DelaySum = 0.0f;
+	int32 NumDelays = 0;
+
+	for (TActorIterator<AVRBaseCharacter> It(GetWorld()); It; ++It)
+	{
+		if (*It == this || It->IsLocallyControlled())
+			continue;
+
+		const float Delays[] = {
+			It->VRReplicatedCamera ? It->VRReplicatedCamera->ReplicatedPoseBuffer.GetInterpolationDelay() : 0.0f,
+			It->LeftMotionController ? It->LeftMotionController->ReplicatedPoseBuffer.GetInterpolationDelay() : 0.0f,
+			It->RightMotionController ? It->RightMotionController->ReplicatedPoseBuffer.GetInterpolationDelay() : 0.0f
+		};
+
+		for (float Delay : Delays)
+		{
+			if (Delay > 0.0f)
+			{
+				DelaySum += Delay;
+				++NumDelays;
+			}
+		}
+	}
+
+	RemoteInterpolationDelay = NumDelays ? DelaySum / NumDelays : 0.0f;
+	return RemoteInterpolationDelay;
+}
+
+void AVRBaseCharacter::Server_SendTrackedPoses_Implementation(FBPVRTrackedPosePacket NewPoses)
+{
+	// Unreliable, an older packet can arrive after a newer one
+	if (NewPoses.TimeStamp <= LastReceivedPoseTimeStamp)
+		return;
+
+	LastReceivedPoseTimeStamp = NewPoses.TimeStamp;
+
+	// The lowest recent transit offset is the least delayed packet, so drops are taken right away and rises only creep in
+	const float NewTransitOffset = GetWorld()->GetTimeSeconds() - NewPoses.TimeStamp;
+	if (!bHasClientTransitOffset || NewTransitOffset < ClientTransitOffset)
+		ClientTransitOffset = NewTransitOffset;
+	else
+		ClientTransitOffset = FMath::Lerp(ClientTransitOffset, NewTransitOffset, 0.05f);
+
+	bHasClientTransitOffset = true;
+	ClientRemoteInterpolationDelay = NewPoses.RemoteInterpolationDelay / 1000.0f;
+
+	if (VRReplicatedCamera && (NewPoses.PoseMask & FBPVRTrackedPosePacket::HMDPoseSlot))
+		VRReplicatedCamera->ReceiveTransform(NewPoses.HMDPose);
+
+	if (LeftMotionController && (NewPoses.PoseMask & FBPVRTrackedPosePacket::LeftControllerPoseSlot))
+		LeftMotionController->ReceiveControllerTransform(NewPoses.LeftControllerPose);
+
+	if (RightMotionController && (NewPoses.PoseMask & FBPVRTrackedPosePacket::RightControllerPoseSlot))
+		RightMotionController->ReceiveControllerTransform(NewPoses.RightControllerPose);
+
+	for (const FBPVRTrackedComponentPose & TrackerPose : NewPoses.TrackerPoses)
+	{
+		UGripMotionControllerComponent * TrackedComponent = Cast<UGripMotionControllerComponent>(TrackerPose.Component);
+
+		// Only ever apply to our own components
+		if (TrackedComponent && TrackedComponent->GetOwner() == this)
+			TrackedComponent->ReceiveControllerTransform(TrackerPose.Pose);
+	}
+}
+
+bool AVRBaseCharacter::Server_SendTrackedPoses_Validate(FBPVRTrackedPosePacket NewPoses)
+{
+	return NewPoses.TrackerPoses.Num() <= FBPVRTrackedPosePacket::MaxTrackerPoses;
+	// Optionally check to make sure that player is inside of their bounds and deny it if they aren't?
 }
 
 FVector AVRBaseCharacter::GetTeleportLocation(FVector OriginalLocation)
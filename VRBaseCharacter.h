@@ -7,8 +7,37 @@
 #include "VRBaseCharacterMovementComponent.h"
 #include "ReplicatedVRCameraComponent.h"
 #include "ParentRelativeAttachmentComponent.h"
+#include "VRPoseHistory.h"
 #include "VRBaseCharacter.generated.h"
 
+class AVRBaseCharacter;
+class UGripMotionControllerComponent;
+
+// Sends the tracked pose packet after every tracked component has ticked for the frame, and records the servers pose history
+USTRUCT()
+struct FVRPoseReplicationTickFunction : public FTickFunction
+{
+	GENERATED_USTRUCT_BODY()
+
+	AVRBaseCharacter * Target;
+
+	FVRPoseReplicationTickFunction() :
+		Target(nullptr)
+	{}
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FVRPoseReplicationTickFunction> : public TStructOpsTypeTraitsBase2<FVRPoseReplicationTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
 UCLASS()
 class VREXPANSIONPLUGIN_API AVRBaseCharacter : public ACharacter
 {
@@ -90,6 +119,76 @@ public:
 	UPROPERTY(Category = VRBaseCharacter, VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
 		UGripMotionControllerComponent * RightMotionController;
 
+	virtual void BeginPlay() override;
+	virtual void RegisterActorTickFunctions(bool bRegister) override;
+
+	// Sends the HMD, both controllers and any added tracked components to the server in one packet sampled on the same frame,
+	// instead of every component sending its own RPC at its own rate. Components that aren't part of the packet still send their own.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "VRExpansionLibrary|Networking")
+		bool bUseUnifiedPoseReplication;
+
+	// Rate to send the tracked pose packet to the server, 100htz is default. Is copied to the components update rates for remote smoothing.
+	// Components using an adaptive send rate only reach this while moving fast, see their AdaptiveSendSettings.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "VRExpansionLibrary|Networking", meta = (ClampMin = "0", UIMin = "0"))
+		float PoseNetUpdateRate;
+
+	// Used in the pose tick to accumulate before sending updates
+	float PoseNetUpdateCount;
+
+	// Newest packet time stamp the server has applied, anything older arrived out of order and is dropped
+	float LastReceivedPoseTimeStamp;
+
+	// Adds a tracked component (trackers) to the tracked pose packet, needs to be called on the server and the owning client
+	UFUNCTION(BlueprintCallable, Category = "VRExpansionLibrary|Networking")
+		void AddTrackedPoseComponent(UGripMotionControllerComponent * TrackedComponent);
+
+	UFUNCTION(BlueprintCallable, Category = "VRExpansionLibrary|Networking")
+		void RemoveTrackedPoseComponent(UGripMotionControllerComponent * TrackedComponent);
+
+	UPROPERTY(Transient)
+		TArray<UGripMotionControllerComponent *> AdditionalTrackedPoseComponents;
+
+	UPROPERTY()
+		FVRPoseReplicationTickFunction PoseReplicationTick;
+
+	// Last sent poses, only the ones that changed since are included in the next packet
+	FBPVRTrackedPosePacket LastSentPoses;
+	TArray<FBPVRComponentPosRep> LastSentTrackerPoses;
+
+	// Builds and sends the tracked pose packet if it is time to
+	void TickPoseReplication(float DeltaTime);
+
+	// Keep a history of the root, HMD and controller poses on the server for lag compensated hit tests, see FVRPoseRewindScope
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "VRExpansionLibrary|Networking")
+		bool bRecordPoseHistory;
+
+	FVRPoseHistory PoseHistory;
+
+	// Server time on arrival minus the owning clients time stamp for the least delayed recent tracked pose packet,
+	// the clock difference plus the client to server latency
+	float ClientTransitOffset;
+	bool bHasClientTransitOffset;
+
+	// How far behind their newest update the owning client displays other pawns tracked components, from the tracked pose packet
+	float ClientRemoteInterpolationDelay;
+
+	// Estimated server clock minus the owning clients clock, half of the round trip is taken off of the transit offset
+	float GetClientClockOffset() const;
+
+	// Converts a time stamp from the owning clients clock (their world time) to the server time of the poses that the client was
+	// looking at, for rewinding to what the client saw. Other pawns reach the client a server to client trip late and are shown
+	// an interpolation delay behind that. Returns the current server time until the first tracked pose packet has arrived.
+	float GetServerTimeForClientTime(float ClientTime) const;
+
+	// Client side, mean interpolation delay of the other pawns replicated cameras and controllers, sent in the tracked pose packet
+	float GetRemoteInterpolationDelay();
+	float RemoteInterpolationDelay;
+	float RemoteInterpolationDelayUpdateTime;
+
+	// I'm sending it unreliable because it is being resent pretty often
+	UFUNCTION(Unreliable, Server, WithValidation)
+		void Server_SendTrackedPoses(FBPVRTrackedPosePacket NewPoses);
+
 
 	/** Name of the LeftMotionController component. Use this name if you want to use a different class (with ObjectInitializer.SetDefaultSubobjectClass). */
 	static FName LeftMotionControllerComponentName;
@@ -7,6 +7,10 @@
 
 #include "VRBaseCharacterMovementComponent.h"
 #include "VRBPDataTypes.h"
+#include "VRServerMoveRecorder.h"
+#include "VRServerMoveScheduler.h"
+#include "GameFramework/Character.h"
+#include "Components/SkeletalMeshComponent.h"
 
 
 UVRBaseCharacterMovementComponent::UVRBaseCharacterMovementComponent(const FObjectInitializer& ObjectInitializer)
@@ -27,9 +31,13 @@ UVRBaseCharacterMovementComponent::UVRBaseCharacterMovementComponent(const FObje
 	VRReplicateCapsuleHeight = false;
 
 	VRWallSlideScaler = 1.0f;
+
+	bPerformingServerMovesOnWorker = false;
+	bServerMovesOnWorkerAborted = false;
 	VRLowGravWallFrictionScaler = 1.0f;
 	VRLowGravIgnoresDefaultFluidFriction = true;
-	
+
+	ServerMoveSequence = 0;
 }
 
 bool UVRBaseCharacterMovementComponent::FloorSweepTest(
@@ -45,6 +53,8 @@ bool UVRBaseCharacterMovementComponent::FloorSweepTest(
 	bool bBlockingHit = false;
 	TArray<FHitResult> OutHits;
 
+	FVRServerMoveRecorder::CountSweep();
+
 	if (!bUseFlatBaseForFloorChecks)
 	{
 		if (bIgnoreSimulatingComponentsInFloorCheck)
@@ -98,6 +108,7 @@ bool UVRBaseCharacterMovementComponent::FloorSweepTest(
 		{
 			// Test again with the same box, not rotated.
 			OutHit.Reset(1.f, false);
+			FVRServerMoveRecorder::CountSweep();
 
 			if (bIgnoreSimulatingComponentsInFloorCheck)
 			{
@@ -191,6 +202,328 @@ void UVRBaseCharacterMovementComponent::AddCustomReplicatedMovement(FVector Move
 		CustomVRInputVector += Movement; // If not a client, don't bother to round this down.
 }
 
+void UVRBaseCharacterMovementComponent::FillServerMove(FVRServerMove & ServerMove, const FSavedMove_Character * SavedMove, bool bSendClientLoc) const
+{
+	ServerMove.TimeStamp = SavedMove->TimeStamp;
+	ServerMove.Accel = FVRServerMove::Quantize(SavedMove->Acceleration, 10.0f);
+	ServerMove.MoveFlags = SavedMove->GetCompressedFlags();
+
+	// Compress rotation down to 5 bytes
+	ServerMove.View = PackYawAndPitchTo32(SavedMove->SavedControlRotation.Yaw, SavedMove->SavedControlRotation.Pitch);
+	ServerMove.ClientRoll = FRotator::CompressAxisToByte(SavedMove->SavedControlRotation.Roll);
+
+	UPrimitiveComponent * ClientMovementBase = SavedMove->EndBase.Get();
+	ServerMove.MovementBase = ClientMovementBase;
+	ServerMove.BaseBoneName = SavedMove->EndBoneName;
+	ServerMove.MovementMode = SavedMove->MovementMode;
+
+	// Determine if we send absolute or relative location
+	ServerMove.bHasClientLoc = bSendClientLoc;
+	if (bSendClientLoc)
+		ServerMove.ClientLoc = FVRServerMove::Quantize(MovementBaseUtility::UseRelativeLocation(ClientMovementBase) ? SavedMove->SavedRelativeLocation : SavedMove->SavedLocation, 100.0f);
+}
+
+void UVRBaseCharacterMovementComponent::PrepareServerMove(FVRServerMove & ServerMove, FSavedMove_VRBaseCharacter * SavedMove, const FSavedMove_VRBaseCharacter * BaselineMove)
+{
+	if (!BaselineMove)
+	{
+		FNetworkPredictionData_Client_Character * ClientData = GetPredictionData_Client_Character();
+		BaselineMove = (ClientData && ClientData->LastAckedMove.IsValid()) ? (const FSavedMove_VRBaseCharacter *)ClientData->LastAckedMove.Get() : nullptr;
+	}
+
+	const int32 Sequence = ServerMoveSequence++;
+	const int32 BaselineDistance = (BaselineMove && BaselineMove->SentMoveSequence != INDEX_NONE) ? Sequence - BaselineMove->SentMoveSequence : 0;
+
+	ServerMove.MoveId = (uint8)(Sequence & 0xFF);
+
+	// Too old for the server to still have, or never sent
+	if (BaselineDistance <= 0 || BaselineDistance >= FVRServerMove::MaxBaselineDistance)
+	{
+		ServerMove.BaselineDistance = 0;
+		ServerMove.MakeDelta(FVRServerMove());
+	}
+	else
+	{
+		ServerMove.BaselineDistance = (uint8)BaselineDistance;
+		ServerMove.MakeDelta(BaselineMove->SentMove);
+	}
+
+	// Kept as the server will rebuild it
+	SavedMove->SentMove = ServerMove;
+	SavedMove->SentMove.ResolveDelta(ServerMove.BaselineDistance ? BaselineMove->SentMove : FVRServerMove());
+	SavedMove->SentMoveSequence = Sequence;
+}
+
+
+void UVRBaseCharacterMovementComponent::QueueOrPerformServerMoveVR(const FVRServerMove & Move, bool bIgnoreRootMotion)
+{
+	if (FVRServerMoveScheduler::IsEnabled(GetWorld()))
+	{
+		FVRServerMoveScheduler::Get().QueueMove(this, Move, bIgnoreRootMotion);
+		return;
+	}
+
+	// Anything queued before the scheduler was turned off goes first
+	FVRServerMoveScheduler::Get().FlushPawn(this);
+
+	if (bIgnoreRootMotion && CharacterOwner)
+	{
+		CharacterOwner->bServerMoveIgnoreRootMotion = true;
+		PerformServerMoveVR(Move);
+		CharacterOwner->bServerMoveIgnoreRootMotion = false;
+	}
+	else
+	{
+		PerformServerMoveVR(Move);
+	}
+}
+
+void UVRBaseCharacterMovementComponent::ServerMoveOld_Implementation(float OldTimeStamp, FVector_NetQuantize10 OldAccel, uint8 OldMoveFlags)
+{
+	FVRServerMoveScheduler::Get().FlushPawn(this);
+	Super::ServerMoveOld_Implementation(OldTimeStamp, OldAccel, OldMoveFlags);
+}
+
+void UVRBaseCharacterMovementComponent::EndServerMoveVR(const FVRServerMoveContext & Context)
+{
+	if (Context.bPerformMovement)
+		bHasRequestedVelocity = false;
+
+	UE_LOG(LogNetPlayerMovement, Verbose, TEXT("ServerMove Time %f Acceleration %s Position %s DeltaTime %f"),
+		Context.TimeStamp, *Context.Accel.ToString(), *UpdatedComponent->GetComponentLocation().ToString(), Context.DeltaTime);
+
+	ServerMoveHandleClientError(Context.TimeStamp, Context.DeltaTime, Context.Accel, Context.ClientLoc, Context.ClientMovementBase, Context.ClientBaseBoneName, Context.ClientMovementMode);
+}
+
+void UVRBaseCharacterMovementComponent::BeginMoveAutonomous(FVRServerMoveContext & Context)
+{
+	// Matches UCharacterMovementComponent::MoveAutonomous up to its PerformMovement
+	UpdateFromCompressedFlags(Context.MoveFlags);
+	CharacterOwner->CheckJumpInput(Context.DeltaTime);
+
+	Acceleration = ConstrainInputAcceleration(Context.Accel);
+	Acceleration = Acceleration.GetClampedToMaxSize(GetMaxAcceleration());
+	AnalogInputModifier = ComputeAnalogInputModifier();
+
+	Context.OldLocation = UpdatedComponent->GetComponentLocation();
+	Context.OldRotation = UpdatedComponent->GetComponentQuat();
+}
+
+void UVRBaseCharacterMovementComponent::EndMoveAutonomous(const FVRServerMoveContext & Context)
+{
+	// Matches UCharacterMovementComponent::MoveAutonomous after its PerformMovement, which can mark the character pending kill
+	if (!HasValidData())
+		return;
+
+	// Ticks the animation after the movement to keep events, notifies and transitions in sync with the client
+	if (!CharacterOwner->bClientUpdating && !CharacterOwner->IsPlayingRootMotion() && CharacterOwner->GetMesh())
+	{
+		TickCharacterPose(Context.DeltaTime);
+		CharacterOwner->GetMesh()->ConditionallyDispatchQueuedAnimEvents();
+	}
+
+	// Smooth local view of remote clients on listen servers
+	static const auto CVarNetEnableListenServerSmoothing = IConsoleManager::Get().FindConsoleVariable(TEXT("p.NetEnableListenServerSmoothing"));
+	if (CVarNetEnableListenServerSmoothing && CVarNetEnableListenServerSmoothing->GetInt() && CharacterOwner->RemoteRole == ROLE_AutonomousProxy && IsNetMode(NM_ListenServer))
+		SmoothCorrection(Context.OldLocation, Context.OldRotation, UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentQuat());
+}
+
+bool UVRBaseCharacterMovementComponent::CanPerformMovementOnWorker() const
+{
+	// The scheduler holds the movement in a deferred scope, an immediate one inside of it is fatal
+	if (!HasValidData() || !IsComponentTickEnabled() || MovementMode != MOVE_Walking || !UpdatedPrimitive || !bEnableScopedMovementUpdates)
+		return false;
+
+	// Anything that changes mode or shape, or runs game code, from inside of the movement
+	if (CharacterOwner->bIsCrouched || bWantsToCrouch || CharacterOwner->bPressedJump || !PendingLaunchVelocity.IsZero() || bUseRVOAvoidance ||
+		VRReplicatedMovementMode != EVRConjoinedMovementModes::C_MOVE_None || CharacterOwner->bServerMoveIgnoreRootMotion ||
+		CharacterOwner->IsPlayingRootMotion() || CurrentRootMotion.HasActiveRootMotionSources() ||
+		CharacterOwner->OnCharacterMovementUpdated.IsBound())
+		return false;
+
+	UPrimitiveComponent * MovementBase = CharacterOwner->GetMovementBase();
+	if (!MovementBase || MovementBaseUtility::IsDynamicBase(MovementBase))
+		return false;
+
+	// Repulsion pushes the simulating bodies we overlap, overlaps don't change until the movement is committed
+	if (bEnablePhysicsInteraction && RepulsionForce > 0.0f)
+	{
+		for (const FOverlapInfo & Overlap : UpdatedPrimitive->GetOverlapInfos())
+		{
+			const UPrimitiveComponent * OverlapComponent = Overlap.OverlapInfo.Component.Get();
+			if (OverlapComponent && OverlapComponent->IsAnySimulatingPhysics())
+				return false;
+		}
+	}
+
+	return true;
+}
+
+bool UVRBaseCharacterMovementComponent::CanPerformServerMovesOnWorker(const FVRServerMove * Moves, int32 NumMoves) const
+{
+	if (!CanPerformMovementOnWorker())
+		return false;
+
+	UPrimitiveComponent * MovementBase = CharacterOwner->GetMovementBase();
+
+	for (int32 MoveIndex = 0; MoveIndex < NumMoves; ++MoveIndex)
+	{
+		const FVRServerMove & Move = Moves[MoveIndex];
+
+		TEnumAsByte<EMovementMode> ClientMovementMode;
+		TEnumAsByte<EMovementMode> ClientGroundMode;
+		uint8 ClientCustomMode;
+		UnpackNetworkMovementMode(Move.MovementMode, ClientMovementMode, ClientCustomMode, ClientGroundMode);
+
+		// The replicated VR movement mode is packed above the jump and crouch flags
+		if ((Move.MoveFlags & (FSavedMove_Character::FLAG_JumpPressed | FSavedMove_Character::FLAG_WantsToCrouch)) || ((Move.MoveFlags >> 2) & 15) ||
+			ClientMovementMode != MOVE_Walking || Move.MovementBase.Get() != MovementBase)
+			return false;
+	}
+
+	return true;
+}
+
+void UVRBaseCharacterMovementComponent::SaveServerMoveState()
+{
+	FVRServerMoveState & State = ServerMoveStateSnapshot;
+
+	State.Velocity = Velocity;
+	State.Acceleration = Acceleration;
+	State.CurrentFloor = CurrentFloor;
+	State.LastUpdateLocation = LastUpdateLocation;
+	State.LastUpdateRotation = LastUpdateRotation;
+	State.LastUpdateVelocity = LastUpdateVelocity;
+	State.PendingImpulseToApply = PendingImpulseToApply;
+	State.PendingForceToApply = PendingForceToApply;
+	State.RequestedVelocity = RequestedVelocity;
+	State.CustomVRInputVector = CustomVRInputVector;
+	State.AdditionalVRInputVector = AdditionalVRInputVector;
+	State.LastPreAdditiveVRVelocity = LastPreAdditiveVRVelocity;
+	State.VRReplicatedMovementMode = VRReplicatedMovementMode;
+	State.bHasRequestedVelocity = bHasRequestedVelocity;
+	State.bJustTeleported = bJustTeleported;
+	State.bForceNextFloorCheck = bForceNextFloorCheck;
+
+	if (CharacterOwner)
+	{
+		State.bPressedJump = CharacterOwner->bPressedJump;
+		State.bWasJumping = CharacterOwner->bWasJumping;
+		State.JumpKeyHoldTime = CharacterOwner->JumpKeyHoldTime;
+		State.JumpForceTimeRemaining = CharacterOwner->JumpForceTimeRemaining;
+		State.JumpCurrentCount = CharacterOwner->JumpCurrentCount;
+	}
+}
+
+void UVRBaseCharacterMovementComponent::RestoreServerMoveState()
+{
+	const FVRServerMoveState & State = ServerMoveStateSnapshot;
+
+	Velocity = State.Velocity;
+	Acceleration = State.Acceleration;
+	CurrentFloor = State.CurrentFloor;
+	LastUpdateLocation = State.LastUpdateLocation;
+	LastUpdateRotation = State.LastUpdateRotation;
+	LastUpdateVelocity = State.LastUpdateVelocity;
+	PendingImpulseToApply = State.PendingImpulseToApply;
+	PendingForceToApply = State.PendingForceToApply;
+	RequestedVelocity = State.RequestedVelocity;
+	CustomVRInputVector = State.CustomVRInputVector;
+	AdditionalVRInputVector = State.AdditionalVRInputVector;
+	LastPreAdditiveVRVelocity = State.LastPreAdditiveVRVelocity;
+	VRReplicatedMovementMode = State.VRReplicatedMovementMode;
+	bHasRequestedVelocity = State.bHasRequestedVelocity;
+	bJustTeleported = State.bJustTeleported;
+	bForceNextFloorCheck = State.bForceNextFloorCheck;
+
+	if (CharacterOwner)
+	{
+		CharacterOwner->bPressedJump = State.bPressedJump;
+		CharacterOwner->bWasJumping = State.bWasJumping;
+		CharacterOwner->JumpKeyHoldTime = State.JumpKeyHoldTime;
+		CharacterOwner->JumpForceTimeRemaining = State.JumpForceTimeRemaining;
+		CharacterOwner->JumpCurrentCount = State.JumpCurrentCount;
+	}
+
+	DeferredServerMoveImpacts.Reset();
+}
+
+void UVRBaseCharacterMovementComponent::ApplyDeferredServerMoveImpacts()
+{
+	check(!bPerformingServerMovesOnWorker);
+
+	// Reset rather than moved out so the array keeps its allocation for the next move
+	for (int32 ImpactIndex = 0; ImpactIndex < DeferredServerMoveImpacts.Num(); ++ImpactIndex)
+	{
+		const FDeferredImpact Impact = DeferredServerMoveImpacts[ImpactIndex];
+		HandleImpact(Impact.Hit, Impact.TimeSlice, Impact.MoveDelta);
+	}
+
+	DeferredServerMoveImpacts.Reset();
+}
+
+void UVRBaseCharacterMovementComponent::SetMovementMode(EMovementMode NewMovementMode, uint8 NewCustomMode)
+{
+	// Mode changes notify the pawn and blueprints
+	if (bPerformingServerMovesOnWorker && (NewMovementMode != MovementMode || (NewMovementMode == MOVE_Custom && NewCustomMode != CustomMovementMode)))
+	{
+		bServerMovesOnWorkerAborted = true;
+		return;
+	}
+
+	Super::SetMovementMode(NewMovementMode, NewCustomMode);
+}
+
+void UVRBaseCharacterMovementComponent::SetBase(UPrimitiveComponent* NewBase, const FName BoneName, bool bNotifyActor)
+{
+	// A new base adds tick dependencies on it and notifies the pawn
+	if (bPerformingServerMovesOnWorker && CharacterOwner && (NewBase != CharacterOwner->GetMovementBase() || BoneName != CharacterOwner->GetBasedMovement().BoneName))
+	{
+		bServerMovesOnWorkerAborted = true;
+		return;
+	}
+
+	Super::SetBase(NewBase, BoneName, bNotifyActor);
+}
+
+void UVRBaseCharacterMovementComponent::HandleImpact(const FHitResult& Hit, float TimeSlice, const FVector& MoveDelta)
+{
+	if (bPerformingServerMovesOnWorker)
+	{
+		FDeferredImpact & Impact = DeferredServerMoveImpacts[DeferredServerMoveImpacts.AddDefaulted()];
+		Impact.Hit = Hit;
+		Impact.TimeSlice = TimeSlice;
+		Impact.MoveDelta = MoveDelta;
+		return;
+	}
+
+	Super::HandleImpact(Hit, TimeSlice, MoveDelta);
+}
+
+bool UVRBaseCharacterMovementComponent::CheckFall(const FFindFloorResult& OldFloor, const FHitResult& Hit, const FVector& Delta, const FVector& OldLocation, float remainingTime, float timeTick, int32 Iterations, bool bMustJump)
+{
+	// Walking off of a ledge notifies the pawn and starts falling, returning true stops the walking update
+	if (AbortServerMovesOnWorker())
+		return true;
+
+	return Super::CheckFall(OldFloor, Hit, Delta, OldLocation, remainingTime, timeTick, Iterations, bMustJump);
+}
+
+void UVRBaseCharacterMovementComponent::ApplyDownwardForce(float DeltaSeconds)
+{
+	if (bPerformingServerMovesOnWorker)
+	{
+		// Pushes on the floor if it is simulating, which it can only be if the base changed and already aborted
+		const UPrimitiveComponent * FloorComponent = CurrentFloor.HitResult.Component.Get();
+		if (bServerMovesOnWorkerAborted || (StandingDownwardForceScale != 0.0f && FloorComponent && FloorComponent->IsAnySimulatingPhysics()))
+		{
+			bServerMovesOnWorkerAborted = true;
+			return;
+		}
+	}
+
+	Super::ApplyDownwardForce(DeltaSeconds);
+}
 
 void UVRBaseCharacterMovementComponent::ApplyVRMotionToVelocity(float deltaTime)
 {
@@ -479,9 +812,42 @@ void FSavedMove_VRBaseCharacter::Clear()
 	LFDiff = FVector::ZeroVector;
 	RequestedVelocity = FVector::ZeroVector;
 
+	SentMoveSequence = INDEX_NONE;
+
 	FSavedMove_Character::Clear();
 }
 
+void FSavedMove_VRBaseCharacter::CombineVRInput(const FSavedMove_VRBaseCharacter * PendingMove, ACharacter * Character)
+{
+	CustomVRInputVector += PendingMove->CustomVRInputVector;
+	LFDiff.X += PendingMove->LFDiff.X;
+	LFDiff.Y += PendingMove->LFDiff.Y;
+
+	if (UVRBaseCharacterMovementComponent * BaseCharMove = Cast<UVRBaseCharacterMovementComponent>(Character->GetCharacterMovement()))
+	{
+		BaseCharMove->CustomVRInputVector = CustomVRInputVector;
+	}
+}
+
+void FSavedMove_VRBaseCharacter::FillServerMoveVRInput(FVRServerMove & ServerMove) const
+{
+	ServerMove.SetCapsule(VRCapsuleLocation, VRCapsuleRotation.Yaw);
+	ServerMove.SetVRInput(RequestedVelocity, LFDiff, CustomVRInputVector);
+}
+
+void FSavedMove_VRBaseCharacter::SetVRInputFromServerMove(const FVRServerMove & ServerMove)
+{
+	bPressedJump = (ServerMove.MoveFlags & FSavedMove_Character::FLAG_JumpPressed) != 0;
+	bWantsToCrouch = (ServerMove.MoveFlags & FSavedMove_Character::FLAG_WantsToCrouch) != 0;
+	VRReplicatedMovementMode = (EVRConjoinedMovementModes)((ServerMove.MoveFlags >> 2) & 15);
+
+	VRCapsuleLocation = ServerMove.GetCapsuleLoc();
+	VRCapsuleRotation = FRotator(0.0f, FRotator::DecompressAxisFromByte(ServerMove.CapsuleYaw), 0.0f);
+	RequestedVelocity = ServerMove.GetRequestedVelocity();
+	LFDiff = ServerMove.GetLFDiff();
+	CustomVRInputVector = ServerMove.GetCustomVRInputVector();
+}
+
 void FSavedMove_VRBaseCharacter::PrepMoveFor(ACharacter* Character)
 {
 	UVRBaseCharacterMovementComponent * BaseCharMove = Cast<UVRBaseCharacterMovementComponent>(Character->GetCharacterMovement());
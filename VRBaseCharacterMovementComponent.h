@@ -26,6 +26,383 @@
 
 //DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FAIMoveCompletedSignature, FAIRequestID, RequestID, EPathFollowingResult::Type, Result);
 
+/**
+* A client move as sent to the server by the VR movement components, in place of the separately quantized ServerMove parameters.
+* Values are held quantized (acceleration to 1/10th, the rest to 1/100th) so that a move rebuilt from deltas on the server is
+* bit for bit the clients copy. Each move is delta encoded against a baseline, the last move the server acked or the first
+* move of a dual send, and a field that matches its baseline only costs its flag bit. Requested velocity and custom input are
+* impulses and are compared against zero instead.
+*/
+USTRUCT()
+struct VREXPANSIONPLUGIN_API FVRServerMove
+{
+	GENERATED_BODY()
+public:
+
+	// Baselines further back than this are not kept by the server, has to fit in the BaselineDistance bits
+	static const int32 MaxBaselineDistance = 32;
+
+	enum EServerMoveField
+	{
+		SMF_Accel = 1 << 0,
+		SMF_ClientLoc = 1 << 1,
+		SMF_CapsuleLoc = 1 << 2,
+		SMF_CapsuleYaw = 1 << 3,
+		SMF_RequestedVelocity = 1 << 4,
+		SMF_LFDiff = 1 << 5,
+		SMF_CustomVRInput = 1 << 6,
+		SMF_MoveFlags = 1 << 7,
+		SMF_ClientRoll = 1 << 8,
+		SMF_View = 1 << 9,
+		SMF_MovementBase = 1 << 10,
+		SMF_MovementMode = 1 << 11,
+		SMF_NumFields = 12
+	};
+
+	float TimeStamp;
+	FIntVector Accel;
+	FIntVector ClientLoc;
+	FIntVector CapsuleLoc;
+	FIntVector RequestedVelocity;
+	FIntVector LFDiff;
+	FIntVector CustomVRInputVector;
+	uint32 View;
+	uint8 CapsuleYaw;
+	uint8 MoveFlags;
+	uint8 ClientRoll;
+	uint8 MovementMode;
+	TWeakObjectPtr<UPrimitiveComponent> MovementBase;
+	FName BaseBoneName;
+
+	// Low byte of the clients move sequence
+	uint8 MoveId;
+
+	// How many moves before this one its baseline is, 0 if it isn't delta encoded
+	uint8 BaselineDistance;
+
+	// False for the first move of a dual send, the server doesn't check its location
+	bool bHasClientLoc;
+
+	// Fields that differ from the baseline, while delta encoded the vector fields hold the difference
+	uint16 ChangedFields;
+
+	FVRServerMove() :
+		TimeStamp(0.0f),
+		Accel(0),
+		ClientLoc(0),
+		CapsuleLoc(0),
+		RequestedVelocity(0),
+		LFDiff(0),
+		CustomVRInputVector(0),
+		View(0),
+		CapsuleYaw(0),
+		MoveFlags(0),
+		ClientRoll(0),
+		MovementMode(0),
+		BaseBoneName(NAME_None),
+		MoveId(0),
+		BaselineDistance(0),
+		bHasClientLoc(true),
+		ChangedFields(0)
+	{}
+
+	static FORCEINLINE FIntVector Quantize(const FVector & Value, float Scale)
+	{
+		return FIntVector(FMath::RoundToInt(Value.X * Scale), FMath::RoundToInt(Value.Y * Scale), FMath::RoundToInt(Value.Z * Scale));
+	}
+
+	static FORCEINLINE FVector Dequantize(const FIntVector & Value, float Scale)
+	{
+		return FVector(Value.X, Value.Y, Value.Z) / Scale;
+	}
+
+	FORCEINLINE void SetCapsule(const FVector & InCapsuleLoc, float InCapsuleYaw)
+	{
+		CapsuleLoc = Quantize(InCapsuleLoc, 100.0f);
+		CapsuleYaw = FRotator::CompressAxisToByte(InCapsuleYaw);
+	}
+
+	FORCEINLINE void SetVRInput(const FVector & InRequestedVelocity, const FVector & InLFDiff, const FVector & InCustomVRInputVector)
+	{
+		RequestedVelocity = Quantize(InRequestedVelocity, 100.0f);
+		LFDiff = Quantize(InLFDiff, 100.0f);
+		CustomVRInputVector = Quantize(InCustomVRInputVector, 100.0f);
+	}
+
+	FORCEINLINE FVector GetAccel() const { return Dequantize(Accel, 10.0f); }
+	FORCEINLINE FVector GetCapsuleLoc() const { return Dequantize(CapsuleLoc, 100.0f); }
+	FORCEINLINE FVector GetRequestedVelocity() const { return Dequantize(RequestedVelocity, 100.0f); }
+	FORCEINLINE FVector GetLFDiff() const { return Dequantize(LFDiff, 100.0f); }
+	FORCEINLINE FVector GetCustomVRInputVector() const { return Dequantize(CustomVRInputVector, 100.0f); }
+
+	// The first half of a dual move gets the location the engine uses to skip its client error check
+	FORCEINLINE FVector GetClientLoc() const
+	{
+		return bHasClientLoc ? Dequantize(ClientLoc, 100.0f) : FVector(1.f, 2.f, 3.f);
+	}
+
+	// Turns the absolute values into deltas against Baseline and fills in ChangedFields
+	void MakeDelta(const FVRServerMove & Baseline)
+	{
+		ChangedFields = 0;
+
+		// A move without a client location carries its baselines forward so that the next move can delta against it
+		if (!bHasClientLoc)
+			ClientLoc = Baseline.ClientLoc;
+
+		DeltaVector(Accel, Baseline.Accel, SMF_Accel);
+		DeltaVector(ClientLoc, Baseline.ClientLoc, SMF_ClientLoc);
+		DeltaVector(CapsuleLoc, Baseline.CapsuleLoc, SMF_CapsuleLoc);
+		DeltaVector(LFDiff, Baseline.LFDiff, SMF_LFDiff);
+		DeltaVector(RequestedVelocity, FIntVector::ZeroValue, SMF_RequestedVelocity);
+		DeltaVector(CustomVRInputVector, FIntVector::ZeroValue, SMF_CustomVRInput);
+
+		ChangedFields |= CapsuleYaw != Baseline.CapsuleYaw ? SMF_CapsuleYaw : 0;
+		ChangedFields |= MoveFlags != Baseline.MoveFlags ? SMF_MoveFlags : 0;
+		ChangedFields |= ClientRoll != Baseline.ClientRoll ? SMF_ClientRoll : 0;
+		ChangedFields |= View != Baseline.View ? SMF_View : 0;
+		ChangedFields |= MovementMode != Baseline.MovementMode ? SMF_MovementMode : 0;
+		ChangedFields |= (MovementBase != Baseline.MovementBase || BaseBoneName != Baseline.BaseBoneName) ? SMF_MovementBase : 0;
+	}
+
+	// Rebuilds the absolute values from a received delta and the baseline it was made against
+	void ResolveDelta(const FVRServerMove & Baseline)
+	{
+		ResolveVector(Accel, Baseline.Accel, SMF_Accel);
+		ResolveVector(ClientLoc, Baseline.ClientLoc, SMF_ClientLoc);
+		ResolveVector(CapsuleLoc, Baseline.CapsuleLoc, SMF_CapsuleLoc);
+		ResolveVector(LFDiff, Baseline.LFDiff, SMF_LFDiff);
+		ResolveVector(RequestedVelocity, FIntVector::ZeroValue, SMF_RequestedVelocity);
+		ResolveVector(CustomVRInputVector, FIntVector::ZeroValue, SMF_CustomVRInput);
+
+		if (!(ChangedFields & SMF_CapsuleYaw))
+			CapsuleYaw = Baseline.CapsuleYaw;
+
+		if (!(ChangedFields & SMF_MoveFlags))
+			MoveFlags = Baseline.MoveFlags;
+
+		if (!(ChangedFields & SMF_ClientRoll))
+			ClientRoll = Baseline.ClientRoll;
+
+		if (!(ChangedFields & SMF_View))
+			View = Baseline.View;
+
+		if (!(ChangedFields & SMF_MovementMode))
+			MovementMode = Baseline.MovementMode;
+
+		if (!(ChangedFields & SMF_MovementBase))
+		{
+			MovementBase = Baseline.MovementBase;
+			BaseBoneName = Baseline.BaseBoneName;
+		}
+
+		ChangedFields = 0;
+		BaselineDistance = 0;
+	}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		bOutSuccess = true;
+
+		Ar << TimeStamp;
+		Ar << MoveId;
+
+		uint32 Distance = BaselineDistance;
+		Ar.SerializeBits(&Distance, 5);
+		BaselineDistance = (uint8)Distance;
+
+		uint32 bClientLocBit = bHasClientLoc ? 1 : 0;
+		Ar.SerializeBits(&bClientLocBit, 1);
+		bHasClientLoc = bClientLocBit != 0;
+
+		uint32 Changed = ChangedFields;
+		Ar.SerializeBits(&Changed, SMF_NumFields);
+		ChangedFields = (uint16)Changed;
+
+		if (ChangedFields & SMF_Accel)
+			VRNetQuantize::SerializeIntVectorPacked(Ar, Accel);
+
+		if (ChangedFields & SMF_ClientLoc)
+			VRNetQuantize::SerializeIntVectorPacked(Ar, ClientLoc);
+
+		if (ChangedFields & SMF_CapsuleLoc)
+			VRNetQuantize::SerializeIntVectorPacked(Ar, CapsuleLoc);
+
+		if (ChangedFields & SMF_CapsuleYaw)
+			Ar << CapsuleYaw;
+
+		if (ChangedFields & SMF_RequestedVelocity)
+			VRNetQuantize::SerializeIntVectorPacked(Ar, RequestedVelocity);
+
+		if (ChangedFields & SMF_LFDiff)
+			VRNetQuantize::SerializeIntVectorPacked(Ar, LFDiff);
+
+		if (ChangedFields & SMF_CustomVRInput)
+			VRNetQuantize::SerializeIntVectorPacked(Ar, CustomVRInputVector);
+
+		if (ChangedFields & SMF_MoveFlags)
+			Ar << MoveFlags;
+
+		if (ChangedFields & SMF_ClientRoll)
+			Ar << ClientRoll;
+
+		if (ChangedFields & SMF_View)
+			Ar << View;
+
+		if (ChangedFields & SMF_MovementBase)
+		{
+			UObject * BaseObject = MovementBase.Get();
+			bOutSuccess &= Map ? Map->SerializeObject(Ar, UPrimitiveComponent::StaticClass(), BaseObject) : true;
+			MovementBase = Cast<UPrimitiveComponent>(BaseObject);
+			Ar << BaseBoneName;
+		}
+
+		if (ChangedFields & SMF_MovementMode)
+			Ar << MovementMode;
+
+		return bOutSuccess;
+	}
+
+private:
+
+	FORCEINLINE void DeltaVector(FIntVector & Value, const FIntVector & BaselineValue, uint16 Field)
+	{
+		Value -= BaselineValue;
+		if (Value != FIntVector::ZeroValue)
+			ChangedFields |= Field;
+	}
+
+	FORCEINLINE void ResolveVector(FIntVector & Value, const FIntVector & BaselineValue, uint16 Field)
+	{
+		Value = (ChangedFields & Field) ? Value + BaselineValue : BaselineValue;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits< FVRServerMove > : public TStructOpsTypeTraitsBase2<FVRServerMove>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+// Server side of the FVRServerMove delta encoding, keeps the last received move in each of MaxBaselineDistance slots
+struct FVRServerMoveReceiver
+{
+	FVRServerMove Moves[FVRServerMove::MaxBaselineDistance];
+	uint32 ValidMask;
+
+	FVRServerMoveReceiver() :
+		ValidMask(0)
+	{}
+
+	// Turns a received move back into absolute values and keeps it as a baseline for later moves.
+	// Returns false if it is relative to a move we don't have and has to be dropped.
+	bool Resolve(FVRServerMove & Move)
+	{
+		static const FVRServerMove EmptyBaseline;
+
+		if (Move.BaselineDistance)
+		{
+			const uint8 BaselineId = Move.MoveId - Move.BaselineDistance;
+			const int32 BaselineSlot = BaselineId % FVRServerMove::MaxBaselineDistance;
+
+			if (!(ValidMask & (1u << BaselineSlot)) || Moves[BaselineSlot].MoveId != BaselineId)
+				return false;
+
+			Move.ResolveDelta(Moves[BaselineSlot]);
+		}
+		else
+		{
+			Move.ResolveDelta(EmptyBaseline);
+		}
+
+		// A move that arrives late doesn't replace a newer one in its slot
+		const int32 Slot = Move.MoveId % FVRServerMove::MaxBaselineDistance;
+		if (!(ValidMask & (1u << Slot)) || (int8)(Move.MoveId - Moves[Slot].MoveId) > 0)
+		{
+			Moves[Slot] = Move;
+			ValidMask |= (1u << Slot);
+		}
+
+		return true;
+	}
+};
+
+/**
+* A server move between its game thread steps, filled in by BeginServerMoveVR. The server move scheduler begins and ends
+* moves on the game thread and only runs the PerformMovement in between on a worker thread.
+*/
+struct VREXPANSIONPLUGIN_API FVRServerMoveContext
+{
+	float TimeStamp;
+	float DeltaTime;
+	FVector Accel;
+	FVector ClientLoc;
+	UPrimitiveComponent * ClientMovementBase;
+	FName ClientBaseBoneName;
+	uint8 ClientMovementMode;
+	uint8 MoveFlags;
+
+	// False when the move only updates the time stamps and view before the client error check
+	bool bPerformMovement;
+
+	// Where MoveAutonomous started from, for the listen server smoothing
+	FVector OldLocation;
+	FQuat OldRotation;
+
+	FVRServerMoveContext() :
+		TimeStamp(0.0f),
+		DeltaTime(0.0f),
+		Accel(FVector::ZeroVector),
+		ClientLoc(FVector::ZeroVector),
+		ClientMovementBase(nullptr),
+		ClientBaseBoneName(NAME_None),
+		ClientMovementMode(0),
+		MoveFlags(0),
+		bPerformMovement(false),
+		OldLocation(FVector::ZeroVector),
+		OldRotation(FQuat::Identity)
+	{}
+};
+
+/**
+* What PerformMovement can change on a movement component and its pawn, saved before the server move scheduler runs it on a
+* worker thread so that it can be thrown away and performed again on the game thread.
+* The component transform itself is reverted with the deferred movement scope the movement runs under.
+*/
+struct VREXPANSIONPLUGIN_API FVRServerMoveState
+{
+	FVector Velocity;
+	FVector Acceleration;
+	FFindFloorResult CurrentFloor;
+	FVector LastUpdateLocation;
+	FQuat LastUpdateRotation;
+	FVector LastUpdateVelocity;
+	FVector PendingImpulseToApply;
+	FVector PendingForceToApply;
+	FVector RequestedVelocity;
+	FVector CustomVRInputVector;
+	FVector AdditionalVRInputVector;
+	FVector LastPreAdditiveVRVelocity;
+	EVRConjoinedMovementModes VRReplicatedMovementMode;
+	bool bHasRequestedVelocity;
+	bool bJustTeleported;
+	bool bForceNextFloorCheck;
+
+	// Character jump state, cleared by every move
+	bool bPressedJump;
+	bool bWasJumping;
+	float JumpKeyHoldTime;
+	float JumpForceTimeRemaining;
+	int32 JumpCurrentCount;
+
+	// VR root capsule placement, VR character only
+	FVector CapsuleCameraLoc;
+	FRotator CapsuleCameraRot;
+	FVector CapsuleDifferenceFromLastFrame;
+};
 
 UCLASS()
 class VREXPANSIONPLUGIN_API UVRBaseCharacterMovementComponent : public UCharacterMovementComponent
@@ -69,6 +446,87 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "BaseVRCharacterMovementComponent|VRLocations")
 		void AddCustomReplicatedMovement(FVector Movement);
 
+	// Fills in the parts of a server move that come from the engine saved move, bSendClientLoc is false for the first move of a dual send
+	void FillServerMove(FVRServerMove & ServerMove, const FSavedMove_Character * SavedMove, bool bSendClientLoc) const;
+
+	// Records a filled in server move on the saved move it was made from and delta encodes it for sending.
+	// The baseline is BaselineMove if set (the first move of a dual send), otherwise the last move the server acked.
+	void PrepareServerMove(FVRServerMove & ServerMove, class FSavedMove_VRBaseCharacter * SavedMove, const class FSavedMove_VRBaseCharacter * BaselineMove);
+
+	// Performs a received move once it has been resolved against its baseline, implemented by the VR and simple movement components
+	// as BeginServerMoveVR, MoveAutonomous and EndServerMoveVR
+	virtual void PerformServerMoveVR(const FVRServerMove & Move) {}
+
+	// Everything of a server move before MoveAutonomous: the time stamp checks, the controllers view and rotation, and the VR
+	// input and capsule. Returns false if the move was dropped before there was anything to check against the client.
+	virtual bool BeginServerMoveVR(const FVRServerMove & Move, FVRServerMoveContext & Context) { return false; }
+
+	// Checks where the move left the pawn against the client and sends a correction if needed
+	void EndServerMoveVR(const FVRServerMoveContext & Context);
+
+	// MoveAutonomous split around its PerformMovement, so the server move scheduler can run just the movement on a worker
+	void BeginMoveAutonomous(FVRServerMoveContext & Context);
+	void EndMoveAutonomous(const FVRServerMoveContext & Context);
+
+	// Called by the ServerMoveVR RPCs with each resolved move, performs it or hands it to the server move scheduler
+	void QueueOrPerformServerMoveVR(const FVRServerMove & Move, bool bIgnoreRootMotion = false);
+
+	// Only performed if newer than the last move, so anything still queued for this pawn goes first
+	virtual void ServerMoveOld_Implementation(float OldTimeStamp, FVector_NetQuantize10 OldAccel, uint8 OldMoveFlags) override;
+
+	// Whether the server move scheduler can run PerformMovement on a worker thread right now. Only plain walking on a static base
+	// qualifies, with nothing bound or enabled that would run game thread only code from inside the movement.
+	virtual bool CanPerformMovementOnWorker() const;
+
+	// Whether the server move scheduler should give these queued moves to a worker thread, checked once before the first of them
+	virtual bool CanPerformServerMovesOnWorker(const FVRServerMove * Moves, int32 NumMoves) const;
+
+	// Saves and restores ServerMoveStateSnapshot around a worker PerformMovement
+	virtual void SaveServerMoveState();
+	virtual void RestoreServerMoveState();
+
+	// Kept on the component so that saving it doesn't allocate
+	FVRServerMoveState ServerMoveStateSnapshot;
+
+	// Set by the scheduler while this components movement runs on a worker, game thread only work is refused or queued
+	bool bPerformingServerMovesOnWorker;
+
+	// Set on the worker when the movement needed something it can't do there, the scheduler reverts it and redoes it on the game thread
+	bool bServerMovesOnWorkerAborted;
+
+	// Returns true and flags the abort if running on a worker
+	FORCEINLINE bool AbortServerMovesOnWorker()
+	{
+		if (!bPerformingServerMovesOnWorker)
+			return false;
+
+		bServerMovesOnWorkerAborted = true;
+		return true;
+	}
+
+	struct FDeferredImpact
+	{
+		FHitResult Hit;
+		float TimeSlice;
+		FVector MoveDelta;
+	};
+
+	// Impacts from worker movement, they push physics objects and notify the pawn so they are handled once the movement is committed
+	TArray<FDeferredImpact> DeferredServerMoveImpacts;
+	void ApplyDeferredServerMoveImpacts();
+
+	virtual void SetMovementMode(EMovementMode NewMovementMode, uint8 NewCustomMode = 0) override;
+	virtual void SetBase(UPrimitiveComponent* NewBase, const FName BoneName = NAME_None, bool bNotifyActor = true) override;
+	virtual void HandleImpact(const FHitResult& Hit, float TimeSlice = 0.f, const FVector& MoveDelta = FVector::ZeroVector) override;
+	virtual bool CheckFall(const FFindFloorResult& OldFloor, const FHitResult& Hit, const FVector& Delta, const FVector& OldLocation, float remainingTime, float timeTick, int32 Iterations, bool bMustJump) override;
+	virtual void ApplyDownwardForce(float DeltaSeconds) override;
+
+	// Server side baselines for the received moves
+	FVRServerMoveReceiver ServerMoveReceiver;
+
+	// Client side count of moves sent
+	int32 ServerMoveSequence;
+
 	FVector CustomVRInputVector;
 	FVector AdditionalVRInputVector;
 
@@ -214,11 +672,16 @@ public:
 	FRotator VRCapsuleRotation;
 	FVector RequestedVelocity;
 
+	// This move as it was sent to the server, the baseline for later moves once it is acked
+	FVRServerMove SentMove;
+	int32 SentMoveSequence;
+
 	void Clear();
 	virtual void SetInitialPosition(ACharacter* C);
 
 	FSavedMove_VRBaseCharacter() : FSavedMove_Character()
 	{
+		SentMoveSequence = INDEX_NONE;
 		CustomVRInputVector = FVector::ZeroVector;
 
 		VRCapsuleLocation = FVector::ZeroVector;
@@ -248,14 +711,26 @@ public:
 	{
 		FSavedMove_VRBaseCharacter * nMove = (FSavedMove_VRBaseCharacter *)NewMove.Get();
 
-		if (!nMove || (VRReplicatedMovementMode != nMove->VRReplicatedMovementMode) || (CustomVRInputVector != nMove->CustomVRInputVector)
-			|| (!LFDiff.IsNearlyZero() && !nMove->LFDiff.IsNearlyZero()) || (!RequestedVelocity.IsNearlyZero() && !nMove->RequestedVelocity.IsNearlyZero())
+		// Custom input and the X/Y of LFDiff are displacements and get summed by CombineVRInput.
+		// LFDiff.Z is the capsule half height, a height change has to go out as its own move.
+		if (!nMove || (VRReplicatedMovementMode != nMove->VRReplicatedMovementMode) || !FMath::IsNearlyEqual(LFDiff.Z, nMove->LFDiff.Z)
+			|| (!RequestedVelocity.IsNearlyZero() && !nMove->RequestedVelocity.IsNearlyZero())
 			)
 			return false;
 
 		return FSavedMove_Character::CanCombineWith(NewMove, Character, MaxDelta);
 	}
 
+	// Called on a new move after the pending move has been reverted and combined in to it (after SetInitialPosition).
+	// Adds the pending moves VR input, which would otherwise be lost with the revert, and applies the sum to the movement component.
+	virtual void CombineVRInput(const FSavedMove_VRBaseCharacter * PendingMove, ACharacter * Character);
+
+	// Fills in the VR fields of the server move sent for this move
+	virtual void FillServerMoveVRInput(FVRServerMove & ServerMove) const;
+
+	// The inverse of FillServerMoveVRInput plus the compressed flags, rebuilds the clients input for this move from a received server move
+	virtual void SetVRInputFromServerMove(const FVRServerMove & ServerMove);
+
 
 	virtual bool IsImportantMove(const FSavedMovePtr& LastAckedMove) const override
 	{
@@ -6,6 +6,7 @@
 =============================================================================*/
 
 #include "VRCharacterMovementComponent.h"
+#include "VRServerMoveRecorder.h"
 #include "GameFramework/PhysicsVolume.h"
 #include "GameFramework/GameNetworkManager.h"
 #include "GameFramework/Character.h"
@@ -34,9 +35,14 @@ DEFINE_LOG_CATEGORY_STATIC(LogCharacterMovement, Log, All);
  */
 DECLARE_CYCLE_STAT(TEXT("Char StepUp"), STAT_CharStepUp, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char FindFloor"), STAT_CharFindFloor, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char FindFloor Cache Hits"), STAT_CharFindFloorCacheHits, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char FindFloor Cache Misses"), STAT_CharFindFloorCacheMisses, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char ReplicateMoveToServer"), STAT_CharacterMovementReplicateMoveToServer, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char CallServerMove"), STAT_CharacterMovementCallServerMove, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char PerformServerMoveVR"), STAT_CharacterMovementPerformServerMoveVR, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char ServerMoveVR Moves"), STAT_CharacterMovementServerMoveVRMoves, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char CombineNetMove"), STAT_CharacterMovementCombineNetMove, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char VR Moves Combined"), STAT_CharacterMovementVRMovesCombined, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char PhysWalking"), STAT_CharPhysWalking, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char PhysFalling"), STAT_CharPhysFalling, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char PhysNavWalking"), STAT_CharPhysNavWalking, STATGROUP_Character);
@@ -458,6 +464,18 @@ void FSavedMove_VRCharacter::SetInitialPosition(ACharacter* C)
 	FSavedMove_VRBaseCharacter::SetInitialPosition(C);
 }
 
+void FSavedMove_VRCharacter::CombineVRInput(const FSavedMove_VRBaseCharacter * PendingMove, ACharacter * Character)
+{
+	FSavedMove_VRBaseCharacter::CombineVRInput(PendingMove, Character);
+
+	// Headset movement over both moves is what the combined move steps up / sweeps with
+	if (AVRCharacter * VRC = Cast<AVRCharacter>(Character))
+	{
+		if (VRC->VRRootReference)
+			VRC->VRRootReference->DifferenceFromLastFrame = FVector(LFDiff.X, LFDiff.Y, 0.0f);
+	}
+}
+
 void FSavedMove_VRCharacter::PrepMoveFor(ACharacter* Character)
 {
 	UVRCharacterMovementComponent * CharMove = Cast<UVRCharacterMovementComponent>(Character->GetCharacterMovement());
@@ -481,102 +499,97 @@ void FSavedMove_VRCharacter::PrepMoveFor(ACharacter* Character)
 	FSavedMove_VRBaseCharacter::PrepMoveFor(Character);
 }
 
-bool UVRCharacterMovementComponent::ServerMoveVR_Validate(float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 CapsuleLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 CapsuleYaw, uint8 MoveFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+bool UVRCharacterMovementComponent::ServerMoveVR_Validate(FVRServerMove NewMove)
 {
 	return true;
 }
 
-bool UVRCharacterMovementComponent::ServerMoveVRDual_Validate(float TimeStamp0, FVector_NetQuantize10 InAccel0, uint8 PendingFlags, uint32 View0, FVector_NetQuantize100 OldCapsuleLoc, FVector_NetQuantize100 rOldRequestedVelocity, FVector_NetQuantize100 OldLFDiff, FVector_NetQuantize100 OldCustVRInputVector, uint8 OldCapsuleYaw, float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 CapsuleLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 CapsuleYaw, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+bool UVRCharacterMovementComponent::ServerMoveVRDual_Validate(FVRServerMove OldMove, FVRServerMove NewMove)
 {
 	return true;
 }
 
-bool UVRCharacterMovementComponent::ServerMoveVRDualHybridRootMotion_Validate(float TimeStamp0, FVector_NetQuantize10 InAccel0, uint8 PendingFlags, uint32 View0, FVector_NetQuantize100 OldCapsuleLoc, FVector_NetQuantize100 rOldRequestedVelocity, FVector_NetQuantize100 OldLFDiff, FVector_NetQuantize100 OldCustVRInputVector, uint8 OldCapsuleYaw, float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 CapsuleLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 CapsuleYaw, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+bool UVRCharacterMovementComponent::ServerMoveVRDualHybridRootMotion_Validate(FVRServerMove OldMove, FVRServerMove NewMove)
 {
 	return true;
 }
 
-void UVRCharacterMovementComponent::ServerMoveVRDual_Implementation(
-	float TimeStamp0,
-	FVector_NetQuantize10 InAccel0,
-	uint8 PendingFlags,
-	uint32 View0,
-	FVector_NetQuantize100 OldCapsuleLoc, 
-	FVector_NetQuantize100 rOldRequestedVelocity,
-	FVector_NetQuantize100 OldLFDiff,
-	FVector_NetQuantize100 OldCustVRInputVector,
-	uint8 OldCapsuleYaw,
-	float TimeStamp,
-	FVector_NetQuantize10 InAccel,
-	FVector_NetQuantize100 ClientLoc,
-	FVector_NetQuantize100 CapsuleLoc,
-	FVector_NetQuantize100 rRequestedVelocity,
-	FVector_NetQuantize100 LFDiff,
-	FVector_NetQuantize100 CustVRInputVector,
-	uint8 CapsuleYaw,
-	uint8 NewFlags,
-	uint8 ClientRoll,
-	uint32 View,
-	UPrimitiveComponent* ClientMovementBase,
-	FName ClientBaseBone,
-	uint8 ClientMovementMode)
+void UVRCharacterMovementComponent::ServerMoveVRDual_Implementation(FVRServerMove OldMove, FVRServerMove NewMove)
 {
-	ServerMoveVR_Implementation(TimeStamp0, InAccel0, FVector(1.f, 2.f, 3.f), OldCapsuleLoc, rOldRequestedVelocity, OldLFDiff, OldCustVRInputVector, OldCapsuleYaw, PendingFlags, ClientRoll, View0, ClientMovementBase, ClientBaseBone, ClientMovementMode);
-	ServerMoveVR_Implementation(TimeStamp, InAccel, ClientLoc, CapsuleLoc, rRequestedVelocity, LFDiff, CustVRInputVector, CapsuleYaw, NewFlags, ClientRoll, View, ClientMovementBase, ClientBaseBone, ClientMovementMode);
+	// The new move is a delta against the old one, so they have to be resolved in order
+	if (!ServerMoveReceiver.Resolve(OldMove) || !ServerMoveReceiver.Resolve(NewMove))
+	{
+		UE_LOG(LogNetPlayerMovement, Verbose, TEXT("ServerMoveVRDual dropped, baseline for move %d not received"), (int32)OldMove.MoveId);
+		return;
+	}
+
+	QueueOrPerformServerMoveVR(OldMove);
+	QueueOrPerformServerMoveVR(NewMove);
 }
 
-void UVRCharacterMovementComponent::ServerMoveVRDualHybridRootMotion_Implementation(
-	float TimeStamp0,
-	FVector_NetQuantize10 InAccel0,
-	uint8 PendingFlags,
-	uint32 View0,
-	FVector_NetQuantize100 OldCapsuleLoc,
-	FVector_NetQuantize100 rOldRequestedVelocity,
-	FVector_NetQuantize100 OldLFDiff,
-	FVector_NetQuantize100 OldCustVRInputVector,
-	uint8 OldCapsuleYaw,
-	float TimeStamp,
-	FVector_NetQuantize10 InAccel,
-	FVector_NetQuantize100 ClientLoc,
-	FVector_NetQuantize100 CapsuleLoc,
-	FVector_NetQuantize100 rRequestedVelocity,
-	FVector_NetQuantize100 LFDiff,
-	FVector_NetQuantize100 CustVRInputVector,
-	uint8 CapsuleYaw,
-	uint8 NewFlags,
-	uint8 ClientRoll,
-	uint32 View,
-	UPrimitiveComponent* ClientMovementBase,
-	FName ClientBaseBone,
-	uint8 ClientMovementMode)
+void UVRCharacterMovementComponent::ServerMoveVRDualHybridRootMotion_Implementation(FVRServerMove OldMove, FVRServerMove NewMove)
 {
+	if (!ServerMoveReceiver.Resolve(OldMove) || !ServerMoveReceiver.Resolve(NewMove))
+	{
+		UE_LOG(LogNetPlayerMovement, Verbose, TEXT("ServerMoveVRDualHybridRootMotion dropped, baseline for move %d not received"), (int32)OldMove.MoveId);
+		return;
+	}
+
 	// First move received didn't use root motion, process it as such.
-	CharacterOwner->bServerMoveIgnoreRootMotion = CharacterOwner->IsPlayingNetworkedRootMotionMontage();
-	ServerMoveVR_Implementation(TimeStamp0, InAccel0, FVector(1.f, 2.f, 3.f), OldCapsuleLoc, rOldRequestedVelocity, OldLFDiff, OldCustVRInputVector, OldCapsuleYaw, PendingFlags, ClientRoll, View0, ClientMovementBase, ClientBaseBone, ClientMovementMode);
-	CharacterOwner->bServerMoveIgnoreRootMotion = false;
+	QueueOrPerformServerMoveVR(OldMove, CharacterOwner->IsPlayingNetworkedRootMotionMontage());
+	QueueOrPerformServerMoveVR(NewMove);
+}
+
+void UVRCharacterMovementComponent::ServerMoveVR_Implementation(FVRServerMove NewMove)
+{
+	if (!ServerMoveReceiver.Resolve(NewMove))
+	{
+		UE_LOG(LogNetPlayerMovement, Verbose, TEXT("ServerMoveVR dropped, baseline for move %d not received"), (int32)NewMove.MoveId);
+		return;
+	}
+
+	QueueOrPerformServerMoveVR(NewMove);
+}
+
+void UVRCharacterMovementComponent::PerformServerMoveVR(const FVRServerMove & Move)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharacterMovementPerformServerMoveVR);
+
+	FVRServerMoveContext Context;
+	if (!BeginServerMoveVR(Move, Context))
+		return;
+
+	if (Context.bPerformMovement)
+		MoveAutonomous(Context.TimeStamp, Context.DeltaTime, Context.MoveFlags, Context.Accel);
 
-	ServerMoveVR_Implementation(TimeStamp, InAccel, ClientLoc, CapsuleLoc, rRequestedVelocity, LFDiff, CustVRInputVector, CapsuleYaw, NewFlags, ClientRoll, View, ClientMovementBase, ClientBaseBone, ClientMovementMode);
+	EndServerMoveVR(Context);
 }
 
-void UVRCharacterMovementComponent::ServerMoveVR_Implementation(
-	float TimeStamp,
-	FVector_NetQuantize10 InAccel,
-	FVector_NetQuantize100 ClientLoc,
-	FVector_NetQuantize100 CapsuleLoc,
-	FVector_NetQuantize100 rRequestedVelocity,
-	FVector_NetQuantize100 LFDiff,
-	FVector_NetQuantize100 CustVRInputVector,
-	uint8 CapsuleYaw,
-	uint8 MoveFlags,
-	uint8 ClientRoll,
-	uint32 View,
-	UPrimitiveComponent* ClientMovementBase,
-	FName ClientBaseBoneName,
-	uint8 ClientMovementMode)
+bool UVRCharacterMovementComponent::BeginServerMoveVR(const FVRServerMove & Move, FVRServerMoveContext & Context)
 {
+	INC_DWORD_STAT(STAT_CharacterMovementServerMoveVRMoves);
+
+	if (FVRServerMoveRecorder::IsRecording())
+		FVRServerMoveRecorder::RecordMove(this, Move);
+
+	const float TimeStamp = Move.TimeStamp;
+	FVector InAccel = Move.GetAccel();
+	const FVector ClientLoc = Move.GetClientLoc();
+	const FVector CapsuleLoc = Move.GetCapsuleLoc();
+	const FVector rRequestedVelocity = Move.GetRequestedVelocity();
+	const FVector LFDiff = Move.GetLFDiff();
+	const FVector CustVRInputVector = Move.GetCustomVRInputVector();
+	const uint8 CapsuleYaw = Move.CapsuleYaw;
+	const uint8 MoveFlags = Move.MoveFlags;
+	const uint8 ClientRoll = Move.ClientRoll;
+	const uint32 View = Move.View;
+	UPrimitiveComponent * ClientMovementBase = Move.MovementBase.Get();
+	const FName ClientBaseBoneName = Move.BaseBoneName;
+	const uint8 ClientMovementMode = Move.MovementMode;
+
 	if (!HasValidData() || !IsComponentTickEnabled())
 	{
-		return;
+		return false;
 	}
 
 	FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character();
@@ -584,7 +597,7 @@ void UVRCharacterMovementComponent::ServerMoveVR_Implementation(
 
 	if (!VerifyClientTimeStamp(TimeStamp, *ServerData))
 	{
-		return;
+		return false;
 	}
 
 	bool bServerReadyForClient = true;
@@ -621,9 +634,18 @@ void UVRCharacterMovementComponent::ServerMoveVR_Implementation(
 
 	if (!bServerReadyForClient)
 	{
-		return;
+		return false;
 	}
 
+	Context.TimeStamp = TimeStamp;
+	Context.DeltaTime = DeltaTime;
+	Context.Accel = Accel;
+	Context.ClientLoc = ClientLoc;
+	Context.ClientMovementBase = ClientMovementBase;
+	Context.ClientBaseBoneName = ClientBaseBoneName;
+	Context.ClientMovementMode = ClientMovementMode;
+	Context.MoveFlags = MoveFlags;
+
 	// Perform actual movement
 	//Comment out 4.16
 	//if ((CharacterOwner->GetWorldSettings()->Pauser == NULL) && (DeltaTime > 0.f))
@@ -672,14 +694,10 @@ void UVRCharacterMovementComponent::ServerMoveVR_Implementation(
 			*/
 		}
 
-		MoveAutonomous(TimeStamp, DeltaTime, MoveFlags, Accel);
-		bHasRequestedVelocity = false;
+		Context.bPerformMovement = true;
 	}
 
-	UE_LOG(LogNetPlayerMovement, Verbose, TEXT("ServerMove Time %f Acceleration %s Position %s DeltaTime %f"),
-		TimeStamp, *Accel.ToString(), *UpdatedComponent->GetComponentLocation().ToString(), DeltaTime);
-
-	ServerMoveHandleClientError(TimeStamp, DeltaTime, Accel, ClientLoc, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+	return true;
 }
 
 
@@ -699,110 +717,48 @@ void UVRCharacterMovementComponent::CallServerMove
 
 	check(NewMove != NULL);
 
-	// Compress rotation down to 5 bytes
-	const uint32 ClientYawPitchINT = PackYawAndPitchTo32(NewMove->SavedControlRotation.Yaw, NewMove->SavedControlRotation.Pitch);
-	const uint8 ClientRollBYTE = FRotator::CompressAxisToByte(NewMove->SavedControlRotation.Roll);
-	const uint8 CapsuleYawBYTE = FRotator::CompressAxisToByte(NewMove->VRCapsuleRotation.Yaw);
-
-	// Determine if we send absolute or relative location
-	UPrimitiveComponent* ClientMovementBase = NewMove->EndBase.Get();
-	const FName ClientBaseBone = NewMove->EndBoneName;
-	const FVector SendLocation = MovementBaseUtility::UseRelativeLocation(ClientMovementBase) ? NewMove->SavedRelativeLocation : NewMove->SavedLocation;
-
 	// send old move if it exists
 	if (OldMove)
 	{
 		ServerMoveOld(OldMove->TimeStamp, OldMove->Acceleration, OldMove->GetCompressedFlags());
 	}
 
+	FVRServerMove NewServerMove;
+	FillServerMove(NewServerMove, NewMove, true);
+	NewMove->FillServerMoveVRInput(NewServerMove);
+
+	// Sent moves are recorded on the saved move as delta baselines
+	FSavedMove_VRCharacter * SentNewMove = const_cast<FSavedMove_VRCharacter *>(NewMove);
+
 	FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
 	if (ClientData->PendingMove.IsValid())
 	{
-		const uint32 OldClientYawPitchINT = PackYawAndPitchTo32(ClientData->PendingMove->SavedControlRotation.Yaw, ClientData->PendingMove->SavedControlRotation.Pitch);
 		FSavedMove_VRCharacter* oldMove = (FSavedMove_VRCharacter*)ClientData->PendingMove.Get();
-		const uint8 OldCapsuleYawBYTE = FRotator::CompressAxisToByte(oldMove->VRCapsuleRotation.Yaw);
+
+		FVRServerMove OldServerMove;
+		FillServerMove(OldServerMove, oldMove, false);
+		oldMove->FillServerMoveVRInput(OldServerMove);
+
+		// The old move goes against the last acked move and the new one against the old one, they always arrive together
+		PrepareServerMove(OldServerMove, oldMove, nullptr);
+		PrepareServerMove(NewServerMove, SentNewMove, oldMove);
 
 		// If we delayed a move without root motion, and our new move has root motion, send these through a special function, so the server knows how to process them.
 		if ((ClientData->PendingMove->RootMotionMontage == NULL) && (NewMove->RootMotionMontage != NULL))
 		{
 			// send two moves simultaneously
-			ServerMoveVRDualHybridRootMotion
-				(
-					ClientData->PendingMove->TimeStamp,
-					ClientData->PendingMove->Acceleration,
-					ClientData->PendingMove->GetCompressedFlags(),
-					OldClientYawPitchINT,
-					oldMove->VRCapsuleLocation,
-					oldMove->RequestedVelocity,
-					oldMove->LFDiff,
-					oldMove->CustomVRInputVector,//AdditionalInputVector,
-					OldCapsuleYawBYTE,
-					NewMove->TimeStamp,
-					NewMove->Acceleration,
-					SendLocation,
-					NewMove->VRCapsuleLocation,
-					NewMove->RequestedVelocity,
-					NewMove->LFDiff,
-					NewMove->CustomVRInputVector,//AdditionalInputVector,
-					CapsuleYawBYTE,
-					NewMove->GetCompressedFlags(),
-					ClientRollBYTE,
-					ClientYawPitchINT,
-					ClientMovementBase,
-					ClientBaseBone,
-					NewMove->MovementMode
-					);
+			ServerMoveVRDualHybridRootMotion(OldServerMove, NewServerMove);
 		}
 		else
 		{
 			// send two moves simultaneously
-			ServerMoveVRDual
-				(
-					ClientData->PendingMove->TimeStamp,
-					ClientData->PendingMove->Acceleration,
-					ClientData->PendingMove->GetCompressedFlags(),
-					OldClientYawPitchINT,
-					oldMove->VRCapsuleLocation,
-					oldMove->RequestedVelocity,
-					oldMove->LFDiff,
-					oldMove->CustomVRInputVector,//AdditionalInputVector,
-					OldCapsuleYawBYTE,
-					NewMove->TimeStamp,
-					NewMove->Acceleration,
-					SendLocation,
-					NewMove->VRCapsuleLocation,
-					NewMove->RequestedVelocity,
-					NewMove->LFDiff,
-					NewMove->CustomVRInputVector,//AdditionalInputVector,
-					CapsuleYawBYTE,
-					NewMove->GetCompressedFlags(),
-					ClientRollBYTE,
-					ClientYawPitchINT,
-					ClientMovementBase,
-					ClientBaseBone,
-					NewMove->MovementMode
-					);
+			ServerMoveVRDual(OldServerMove, NewServerMove);
 		}
 	}
 	else
 	{
-		ServerMoveVR
-			(
-				NewMove->TimeStamp,
-				NewMove->Acceleration,
-				SendLocation,
-				NewMove->VRCapsuleLocation,
-				NewMove->RequestedVelocity,
-				NewMove->LFDiff,
-				NewMove->CustomVRInputVector,//AdditionalInputVector,
-				CapsuleYawBYTE,
-				NewMove->GetCompressedFlags(),
-				ClientRollBYTE,
-				ClientYawPitchINT,
-				ClientMovementBase,
-				ClientBaseBone,
-				NewMove->MovementMode
-				);
+		PrepareServerMove(NewServerMove, SentNewMove, nullptr);
+		ServerMoveVR(NewServerMove);
 	}
 
 
@@ -930,6 +886,7 @@ void UVRCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iteration
 				bool bWasBlockingHit = false;
 
 				bWasBlockingHit = GetWorld()->SweepSingleByChannel(HitRes, VRRootCapsule->OffsetComponentToWorld.GetLocation(), VRRootCapsule->OffsetComponentToWorld.GetLocation() + VRRootCapsule->DifferenceFromLastFrame, FQuat(0.0f, 0.0f, 0.0f, 1.0f), VRRootCapsule->GetCollisionObjectType(), VRRootCapsule->GetCollisionShape(), Params, ResponseParam);
+				FVRServerMoveRecorder::CountSweep();
 				
 				const FVector GravDir(0.f, 0.f, -1.f);
 				if (CanStepUp(HitRes) || (CharacterOwner->GetMovementBase() != NULL && CharacterOwner->GetMovementBase()->GetOwner() == HitRes.GetActor()))
@@ -1015,6 +972,9 @@ void UVRCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iteration
 			{
 				if (ShouldCatchAir(OldFloor, CurrentFloor))
 				{
+					if (AbortServerMovesOnWorker())
+						return;
+
 					CharacterOwner->OnWalkingOffLedge(OldFloor.HitResult.ImpactNormal, OldFloor.HitResult.Normal, OldLocation, timeTick);
 					if (IsMovingOnGround())
 					{
@@ -1180,13 +1140,10 @@ void UVRCharacterMovementComponent::ReplicateMoveToServer(float DeltaTime, const
 	}
 
 	NewMove->SetMoveFor(CharacterOwner, DeltaTime, NewAcceleration, *ClientData);
-	// Causing really bad crash when using vr offset location, rather remove for now than have it merge move improperly.
 
 	// see if the two moves could be combined
 	// do not combine moves which have different TimeStamps (before and after reset).
-	
-
-	// Don' merge with a vr capsule
+	// FSavedMove_VRCharacter::CanCombineWith keeps this to moves with the same VR offset, which the overlap test below relies on.
 	if (bAllowMovementMerging && ClientData->PendingMove.IsValid() && !ClientData->PendingMove->bOldTimeStampBeforeReset && ClientData->PendingMove->CanCombineWith(NewMove, CharacterOwner, ClientData->MaxMoveDeltaTime * CharacterOwner->GetActorTimeDilation()))
 	{
 		SCOPE_CYCLE_COUNTER(STAT_CharacterMovementCombineNetMove);
@@ -1225,6 +1182,10 @@ void UVRCharacterMovementComponent::ReplicateMoveToServer(float DeltaTime, const
 			SaveBaseLocation();
 			NewMove->SetInitialPosition(CharacterOwner);
 
+			// The pending moves VR input was reverted with it, carry it in to the combined move
+			((FSavedMove_VRBaseCharacter*)NewMove.Get())->CombineVRInput((FSavedMove_VRBaseCharacter*)ClientData->PendingMove.Get(), CharacterOwner);
+			INC_DWORD_STAT(STAT_CharacterMovementVRMovesCombined);
+
 			// Remove pending move from move list. It would have to be the last move on the list.
 			if (ClientData->SavedMoves.Num() > 0 && ClientData->SavedMoves.Last() == ClientData->PendingMove)
 			{
@@ -1333,8 +1294,10 @@ UVRCharacterMovementComponent::UVRCharacterMovementComponent(const FObjectInitia
 	// 0.1f is low slide and still impacts surfaces well
 	// This variable is a bit of a hack, it reduces the movement of the pawn in the direction of relative movement
 	WallRepulsionMultiplier = 0.01f;
+	VRFloorCacheRadius = 2.0f;
+	VRFloorCacheMaxAge = 0.5f;
 
-	bAllowMovementMerging = false;
+	bAllowMovementMerging = true;
 	bRequestedMoveUseAcceleration = false;
 }
 
@@ -2244,6 +2207,18 @@ void UVRCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation, FF
 	if (VRRootCapsule)
 		UseCapsuleLocation = VRRootCapsule->OffsetComponentToWorld.GetLocation();
 
+	// Room scale sway moves the capsule a little every tick, don't re-sweep for it while standing on the same flat floor
+	if (!DownwardSweepResult && !bForceNextFloorCheck && !bJustTeleported)
+	{
+		if (GetCachedFloor(UseCapsuleLocation, OutFloorResult))
+		{
+			INC_DWORD_STAT(STAT_CharFindFloorCacheHits);
+			return;
+		}
+
+		INC_DWORD_STAT(STAT_CharFindFloorCacheMisses);
+	}
+
 	// Increase height check slightly if walking, to prevent floor height adjustment from later invalidating the floor result.
 	const float HeightCheckAdjust = (IsMovingOnGround() ? MAX_FLOOR_DIST + KINDA_SMALL_NUMBER : -MAX_FLOOR_DIST);
 
@@ -2354,6 +2329,116 @@ void UVRCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation, FF
 			}
 		}
 	}
+
+	UpdateFloorCache(UseCapsuleLocation, OutFloorResult);
+}
+
+bool UVRCharacterMovementComponent::GetCachedFloor(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult) const
+{
+	if (!FloorCache.bValid || VRFloorCacheRadius <= 0.0f || !IsMovingOnGround())
+		return false;
+
+	UPrimitiveComponent * MovementBase = CharacterOwner->GetMovementBase();
+	const UCapsuleComponent * Capsule = CharacterOwner->GetCapsuleComponent();
+
+	// Base changed or started moving, or the capsule was resized
+	if (!MovementBase || FloorCache.Base.Get() != MovementBase || MovementBaseUtility::IsDynamicBase(MovementBase) ||
+		Capsule->GetScaledCapsuleRadius() != FloorCache.CapsuleRadius || Capsule->GetScaledCapsuleHalfHeight() != FloorCache.CapsuleHalfHeight)
+	{
+		FloorCache.bValid = false;
+		return false;
+	}
+
+	if (VRFloorCacheMaxAge > 0.0f && GetWorld()->GetTimeSeconds() - FloorCache.TimeStamp > VRFloorCacheMaxAge)
+	{
+		FloorCache.bValid = false;
+		return false;
+	}
+
+	const FVector Delta = CapsuleLocation - FloorCache.CapsuleLocation;
+
+	if (!FMath::IsNearlyZero(Delta.Z) || Delta.SizeSquared2D() > FMath::Square(VRFloorCacheRadius))
+		return false;
+
+	OutFloorResult = FloorCache.Floor;
+
+	// Floor is flat so only the trace positions move with the capsule
+	FHitResult & Hit = OutFloorResult.HitResult;
+	Hit.Location += Delta;
+	Hit.ImpactPoint += Delta;
+	Hit.TraceStart += Delta;
+	Hit.TraceEnd += Delta;
+
+	return true;
+}
+
+void UVRCharacterMovementComponent::UpdateFloorCache(const FVector& CapsuleLocation, const FFindFloorResult& FloorResult) const
+{
+	// Anything but a flat walkable floor on a static base changes under horizontal movement
+	const float MinFlatFloorNormalZ = 0.999f;
+
+	UPrimitiveComponent * MovementBase = CharacterOwner->GetMovementBase();
+
+	if (VRFloorCacheRadius <= 0.0f || !FloorResult.IsWalkableFloor() || FloorResult.bLineTrace ||
+		FloorResult.HitResult.Component.Get() != MovementBase || !MovementBase || MovementBaseUtility::IsDynamicBase(MovementBase) ||
+		FloorResult.HitResult.Normal.Z < MinFlatFloorNormalZ || FloorResult.HitResult.ImpactNormal.Z < MinFlatFloorNormalZ)
+	{
+		FloorCache.bValid = false;
+		return;
+	}
+
+	FloorCache.Floor = FloorResult;
+	FloorCache.CapsuleLocation = CapsuleLocation;
+	FloorCache.Base = MovementBase;
+	FloorCache.CapsuleRadius = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	FloorCache.CapsuleHalfHeight = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	FloorCache.TimeStamp = GetWorld()->GetTimeSeconds();
+	FloorCache.bValid = true;
+}
+
+void UVRCharacterMovementComponent::OnTeleported()
+{
+	InvalidateFloorCache();
+	Super::OnTeleported();
+}
+
+void UVRCharacterMovementComponent::SetBase(UPrimitiveComponent* NewBase, const FName BoneName, bool bNotifyActor)
+{
+	if (!CharacterOwner || CharacterOwner->GetMovementBase() != NewBase)
+		InvalidateFloorCache();
+
+	Super::SetBase(NewBase, BoneName, bNotifyActor);
+}
+
+void UVRCharacterMovementComponent::SaveServerMoveState()
+{
+	Super::SaveServerMoveState();
+
+	FVRServerMoveState & State = ServerMoveStateSnapshot;
+
+	if (VRRootCapsule)
+	{
+		State.CapsuleCameraLoc = VRRootCapsule->curCameraLoc;
+		State.CapsuleCameraRot = VRRootCapsule->curCameraRot;
+		State.CapsuleDifferenceFromLastFrame = VRRootCapsule->DifferenceFromLastFrame;
+	}
+}
+
+void UVRCharacterMovementComponent::RestoreServerMoveState()
+{
+	Super::RestoreServerMoveState();
+
+	const FVRServerMoveState & State = ServerMoveStateSnapshot;
+
+	if (VRRootCapsule)
+	{
+		VRRootCapsule->curCameraLoc = State.CapsuleCameraLoc;
+		VRRootCapsule->curCameraRot = State.CapsuleCameraRot;
+		VRRootCapsule->DifferenceFromLastFrame = State.CapsuleDifferenceFromLastFrame;
+		VRRootCapsule->GenerateOffsetToWorld(false);
+	}
+
+	InvalidateFloorCache();
 }
 
 // MOVED TO BASE VR CHARCTER MOVEMENT COMPONENT
@@ -80,10 +80,21 @@ public:
 	virtual bool IsWithinClimbingEdgeTolerance(const FVector& CapsuleLocation, const FVector& TestImpactPoint, const float CapsuleRadius) const;
 	virtual bool VRClimbStepUp(const FVector& GravDir, const FVector& Delta, const FHitResult &InHit, FStepDownResult* OutStepDownResult = nullptr) override;
 
-	// Allow merging movement replication (may cause issues when >10 players due to capsule location
+	// Allow merging movement replication, moves are only combined while the HMD offset stays (close to) the same and their
+	// custom input and headset movement are summed in to the combined move.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRCharacterMovementComponent")
 	bool bAllowMovementMerging;
 
+	// Reuse the last floor result while walking on a flat, static floor and the VR capsule has only moved (swayed) this far
+	// horizontally since it was found. 0 disables the cache.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRCharacterMovementComponent", meta = (ClampMin = "0.0", UIMin = "0"))
+	float VRFloorCacheRadius;
+
+	// Seconds a cached floor is reused for before FindFloor sweeps again, so that anything the cache checks miss
+	// (a floor that was removed or moved without becoming a dynamic base) is picked up. 0 never expires it.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRCharacterMovementComponent", meta = (ClampMin = "0.0", UIMin = "0"))
+	float VRFloorCacheMaxAge;
+
 	// Higher values will cause more slide but better step up
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRCharacterMovementComponent", meta = (ClampMin = "0.01", UIMin = "0", ClampMax = "1.0", UIMax = "1"))
 	float WallRepulsionMultiplier;
@@ -145,21 +156,25 @@ public:
 
 	/** Replicated function sent by client to server - contains client movement and view info. */
 	UFUNCTION(unreliable, server, WithValidation)
-	virtual void ServerMoveVR(float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 CapsuleLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 CapsuleYaw, uint8 CompressedMoveFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode);
-	virtual void ServerMoveVR_Implementation(float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 CapsuleLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 CapsuleYaw, uint8 CompressedMoveFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode);
-	virtual bool ServerMoveVR_Validate(float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 CapsuleLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 CapsuleYaw, uint8 CompressedMoveFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode);
+	virtual void ServerMoveVR(FVRServerMove NewMove);
+	virtual void ServerMoveVR_Implementation(FVRServerMove NewMove);
+	virtual bool ServerMoveVR_Validate(FVRServerMove NewMove);
 
 	/** Replicated function sent by client to server - contains client movement and view info for two moves. */
 	UFUNCTION(unreliable, server, WithValidation)
-	virtual void ServerMoveVRDual(float TimeStamp0, FVector_NetQuantize10 InAccel0, uint8 PendingFlags, uint32 View0, FVector_NetQuantize100 OldCapsuleLoc, FVector_NetQuantize100 rOldRequestedVelocity, FVector_NetQuantize100 OldLFDiff, FVector_NetQuantize100 OldCustVRInputVector, uint8 OldCapsuleYaw, float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 CapsuleLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 CapsuleYaw, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode);
-	virtual void ServerMoveVRDual_Implementation(float TimeStamp0, FVector_NetQuantize10 InAccel0, uint8 PendingFlags, uint32 View0, FVector_NetQuantize100 OldCapsuleLoc, FVector_NetQuantize100 rOldRequestedVelocity, FVector_NetQuantize100 OldLFDiff, FVector_NetQuantize100 OldCustVRInputVector, uint8 OldCapsuleYaw, float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 CapsuleLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 CapsuleYaw, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode);
-	virtual bool ServerMoveVRDual_Validate(float TimeStamp0, FVector_NetQuantize10 InAccel0, uint8 PendingFlags, uint32 View0, FVector_NetQuantize100 OldCapsuleLoc, FVector_NetQuantize100 rOldRequestedVelocity, FVector_NetQuantize100 OldLFDiff, FVector_NetQuantize100 OldCustVRInputVector, uint8 OldCapsuleYaw, float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 CapsuleLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 CapsuleYaw, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode);
+	virtual void ServerMoveVRDual(FVRServerMove OldMove, FVRServerMove NewMove);
+	virtual void ServerMoveVRDual_Implementation(FVRServerMove OldMove, FVRServerMove NewMove);
+	virtual bool ServerMoveVRDual_Validate(FVRServerMove OldMove, FVRServerMove NewMove);
 
 	/** Replicated function sent by client to server - contains client movement and view info for two moves. First move is non root motion, second is root motion. */
 	UFUNCTION(unreliable, server, WithValidation)
-	virtual void ServerMoveVRDualHybridRootMotion(float TimeStamp0, FVector_NetQuantize10 InAccel0, uint8 PendingFlags, uint32 View0, FVector_NetQuantize100 OldCapsuleLoc,FVector_NetQuantize100 rOldRequestedVelocity, FVector_NetQuantize100 OldLFDiff, FVector_NetQuantize100 OldCustVRInputVector, uint8 OldCapsuleYaw, float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 CapsuleLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 CapsuleYaw, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode);
-	virtual void ServerMoveVRDualHybridRootMotion_Implementation(float TimeStamp0, FVector_NetQuantize10 InAccel0, uint8 PendingFlags, uint32 View0, FVector_NetQuantize100 OldCapsuleLoc, FVector_NetQuantize100 rOldRequestedVelocity, FVector_NetQuantize100 OldLFDiff, FVector_NetQuantize100 OldCustVRInputVector, uint8 OldCapsuleYaw, float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 CapsuleLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 CapsuleYaw, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode);
-	virtual bool ServerMoveVRDualHybridRootMotion_Validate(float TimeStamp0, FVector_NetQuantize10 InAccel0, uint8 PendingFlags, uint32 View0, FVector_NetQuantize100 OldCapsuleLoc, FVector_NetQuantize100 rOldRequestedVelocity, FVector_NetQuantize100 OldLFDiff, FVector_NetQuantize100 OldCustVRInputVector, uint8 OldCapsuleYaw, float TimeStamp, FVector_NetQuantize10 InAccel, FVector_NetQuantize100 ClientLoc, FVector_NetQuantize100 CapsuleLoc, FVector_NetQuantize100 rRequestedVelocity, FVector_NetQuantize100 LFDiff, FVector_NetQuantize100 CustVRInputVector, uint8 CapsuleYaw, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode);
+	virtual void ServerMoveVRDualHybridRootMotion(FVRServerMove OldMove, FVRServerMove NewMove);
+	virtual void ServerMoveVRDualHybridRootMotion_Implementation(FVRServerMove OldMove, FVRServerMove NewMove);
+	virtual bool ServerMoveVRDualHybridRootMotion_Validate(FVRServerMove OldMove, FVRServerMove NewMove);
+
+	// Performs a received move once it has been resolved against its baseline
+	virtual void PerformServerMoveVR(const FVRServerMove & Move) override;
+	virtual bool BeginServerMoveVR(const FVRServerMove & Move, FVRServerMoveContext & Context) override;
 
 
 	FNetworkPredictionData_Client* GetPredictionData_Client() const override;
@@ -219,6 +234,46 @@ public:
 	// Had to force it within the function to use VRLocation instead.
 	virtual void FindFloor(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult, bool bZeroDelta, const FHitResult* DownwardSweepResult) const override;
 
+	// Floor cache for FindFloor, only ever holds a walkable floor on a static base with a near vertical normal
+	// so that small horizontal moves of the capsule can't change the floor distance.
+	struct FVRFloorCache
+	{
+		FFindFloorResult Floor;
+		FVector CapsuleLocation;
+		TWeakObjectPtr<UPrimitiveComponent> Base;
+		float CapsuleRadius;
+		float CapsuleHalfHeight;
+		float TimeStamp;
+		bool bValid;
+
+		FVRFloorCache() :
+			CapsuleLocation(FVector::ZeroVector),
+			CapsuleRadius(0.0f),
+			CapsuleHalfHeight(0.0f),
+			TimeStamp(0.0f),
+			bValid(false)
+		{}
+	};
+
+	mutable FVRFloorCache FloorCache;
+
+	// Fills OutFloorResult from the floor cache if the capsule is still close enough to where it was found
+	bool GetCachedFloor(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult) const;
+	void UpdateFloorCache(const FVector& CapsuleLocation, const FFindFloorResult& FloorResult) const;
+
+	FORCEINLINE void InvalidateFloorCache()
+	{
+		FloorCache.bValid = false;
+	}
+
+	// Both move the capsule off of the floor it was cached on
+	virtual void OnTeleported() override;
+	virtual void SetBase(UPrimitiveComponent* NewBase, const FName BoneName = NAME_None, bool bNotifyActor = true) override;
+
+	// Adds the VR root capsule placement that the movement can change
+	virtual void SaveServerMoveState() override;
+	virtual void RestoreServerMoveState() override;
+
 	// Need to use actual capsule location for step up
 	bool StepUp(const FVector& GravDir, const FVector& Delta, const FHitResult &InHit, FStepDownResult* OutStepDownResult) override;
 
@@ -296,10 +351,28 @@ public:
 
 	virtual void SetInitialPosition(ACharacter* C);
 	virtual void PrepMoveFor(ACharacter* Character) override;
+	virtual void CombineVRInput(const FSavedMove_VRBaseCharacter * PendingMove, ACharacter * Character) override;
 
 	FSavedMove_VRCharacter() : FSavedMove_VRBaseCharacter()
 	{}
 
+	bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* Character, float MaxDelta) const override
+	{
+		FSavedMove_VRCharacter * nMove = (FSavedMove_VRCharacter *)NewMove.Get();
+
+		// The combined move is replayed from the pending moves start with only the new moves capsule offset, so the
+		// offset can't have moved more than a sliver between them or the revert and overlap test are done in the wrong spot.
+		const float MaxCapsuleOffsetDelta = 2.0f;
+		const float MaxCapsuleYawDelta = 5.0f;
+
+		if (!nMove || !VRCapsuleLocation.Equals(nMove->VRCapsuleLocation, MaxCapsuleOffsetDelta)
+			|| FMath::Abs(FRotator::NormalizeAxis(VRCapsuleRotation.Yaw - nMove->VRCapsuleRotation.Yaw)) > MaxCapsuleYawDelta
+			)
+			return false;
+
+		return FSavedMove_VRBaseCharacter::CanCombineWith(NewMove, Character, MaxDelta);
+	}
+
 };
 
 // Need this for capsule location replication
@@ -309,7 +382,10 @@ public:
 	FNetworkPredictionData_Client_VRCharacter(const UCharacterMovementComponent& ClientMovement)
 		: FNetworkPredictionData_Client_Character(ClientMovement)
 	{
-
+		// Fill the free move list up front, the engine recycles moves through it from then on instead of reallocating them
+		FreeMoves.Reserve(MaxFreeMoveCount);
+		while (FreeMoves.Num() < MaxFreeMoveCount)
+			FreeMoves.Add(AllocateNewMove());
 	}
 
 	FSavedMovePtr AllocateNewMove()
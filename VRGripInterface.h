@@ -10,6 +10,22 @@
 #include "VRGripInterface.generated.h"
 
 
+// Native C++ mirror of the IVRGripInterface queries that the motion controller makes every grip tick.
+// The Execute_ functions always go through ProcessEvent, even when the implementer is native, so native grippables
+// return this from GetNativeGripInterface() and the controller calls it directly as long as the matching event isn't
+// overridden in blueprint. Each function forwards to the matching virtual _Implementation.
+class VREXPANSIONPLUGIN_API IVRGripInterfaceNative
+{
+public:
+	virtual ~IVRGripInterfaceNative() {}
+
+	virtual bool IsInteractible_Native() = 0;
+	virtual FBPInteractionSettings GetInteractionSettings_Native() = 0;
+	virtual float GripBreakDistance_Native() = 0;
+	virtual ESecondaryGripType SecondaryGripType_Native() = 0;
+	virtual void TickGrip_Native(UGripMotionControllerComponent * GrippingController, const FBPActorGripInformation & GripInformation, FVector MControllerLocDelta, float DeltaTime) = 0;
+};
+
 UINTERFACE(Blueprintable)
 class VREXPANSIONPLUGIN_API UVRGripInterface: public UInterface
 {
@@ -23,6 +39,9 @@ class VREXPANSIONPLUGIN_API IVRGripInterface
  
 public:
 
+	// Returns the native mirror of this interface if the implementer has one, blueprint only implementers return null
+	virtual IVRGripInterfaceNative * GetNativeGripInterface() { return nullptr; }
+
 	// Set up as deny instead of allow so that default allows for gripping
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "VRGripInterface")
 		bool DenyGripping();
@@ -0,0 +1,320 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "VRBPDatatypes.h"
+#include "GripMotionControllerComponent.h"
+#include "ReplicatedVRCameraComponent.h"
+#include "Containers/Ticker.h"
+#include "Serialization/BitWriter.h"
+#include "Serialization/BitReader.h"
+#include "UObject/UObjectIterator.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+// Runs recorded relative poses of tracked components through each FBPVRComponentPosRep encoding and logs the bits per
+// pose and the position / rotation error. Recording and benchmarking are separate so that every run measures the same motion.
+// Usage: vr.RecordPoses [Frames] [FileName], move the HMD and controllers around while it records.
+//        vr.PoseEncodingBenchmark [FileName]
+
+namespace
+{
+	struct FPoseEncodingResult
+	{
+		double TotalBits;
+		double PositionErrorSum;
+		float PositionErrorMax;
+		double RotationErrorSum;
+		float RotationErrorMax;
+		int32 NumPoses;
+		int32 NumDropped;
+
+		FPoseEncodingResult() :
+			TotalBits(0.0),
+			PositionErrorSum(0.0),
+			PositionErrorMax(0.0f),
+			RotationErrorSum(0.0),
+			RotationErrorMax(0.0f),
+			NumPoses(0),
+			NumDropped(0)
+		{}
+	};
+
+	const uint32 PoseFileMagic = 0x50525256; // "VRRP"
+	const int32 PoseFileVersion = 1;
+
+	struct FPoseRecording
+	{
+		TWeakObjectPtr<UWorld> World;
+		int32 FramesLeft;
+		FString FileName;
+
+		// One track per component so that deltas follow each components own motion
+		TMap<const USceneComponent *, TArray<FTransform>> Tracks;
+		FDelegateHandle TickerHandle;
+
+		FPoseRecording() :
+			FramesLeft(0)
+		{}
+	};
+
+	FPoseRecording PoseRecording;
+
+	// File layout: header, then each track as its pose count followed by the poses
+	bool SerializePoseTracks(FArchive & Ar, TArray<TArray<FTransform>> & Tracks)
+	{
+		uint32 Magic = PoseFileMagic;
+		int32 Version = PoseFileVersion;
+		Ar << Magic;
+		Ar << Version;
+
+		if (Magic != PoseFileMagic || Version != PoseFileVersion)
+			return false;
+
+		int32 NumTracks = Tracks.Num();
+		Ar << NumTracks;
+
+		// Every pose and track takes more than a byte, anything claiming more is a broken file
+		if (Ar.IsLoading())
+		{
+			if (NumTracks < 0 || NumTracks > Ar.TotalSize())
+				return false;
+
+			Tracks.SetNum(NumTracks);
+		}
+
+		for (TArray<FTransform> & Track : Tracks)
+		{
+			int32 NumPoses = Track.Num();
+			Ar << NumPoses;
+
+			if (Ar.IsLoading())
+			{
+				if (NumPoses < 0 || NumPoses > Ar.TotalSize())
+					return false;
+
+				Track.SetNum(NumPoses);
+			}
+
+			for (FTransform & Pose : Track)
+			{
+				FVector Location = Pose.GetLocation();
+				FQuat Rotation = Pose.GetRotation();
+				Ar << Location;
+				Ar << Rotation;
+
+				if (Ar.IsLoading())
+					Pose = FTransform(Rotation, Location);
+			}
+
+			if (Ar.IsError())
+				return false;
+		}
+
+		return !Ar.IsError();
+	}
+
+	FString GetPoseFileName(const TArray<FString> & Args, int32 ArgIndex)
+	{
+		FString FileName = Args.IsValidIndex(ArgIndex) ? Args[ArgIndex] : TEXT("VRPoses.vrposes");
+
+		if (FPaths::IsRelative(FileName))
+			FileName = FPaths::Combine(*FPaths::GameSavedDir(), *FileName);
+
+		return FileName;
+	}
+
+	void RunPoseEncoding(const TArray<TArray<FTransform>> & Tracks, const TCHAR * EncodingName, const FBPVRComponentPosRep & EncodingSettings)
+	{
+		FPoseEncodingResult Result;
+
+		for (const TArray<FTransform> & Track : Tracks)
+		{
+			FVRPoseBaselineSender Sender;
+			FVRPoseBaselineReceiver Receiver;
+
+			for (const FTransform & SourcePose : Track)
+			{
+				FBPVRComponentPosRep Pose = EncodingSettings;
+				Pose.Position = SourcePose.GetLocation();
+				Pose.Rotation = SourcePose.Rotator();
+				Sender.PrepareForSend(Pose);
+
+				bool bSuccess = true;
+				FBitWriter Writer(1024, true);
+				Pose.NetSerialize(Writer, nullptr, bSuccess);
+
+				FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+				FBPVRComponentPosRep ReceivedPose;
+				ReceivedPose.NetSerialize(Reader, nullptr, bSuccess);
+
+				Result.TotalBits += Writer.GetNumBits();
+
+				int32 AckIndex = INDEX_NONE;
+				if (!bSuccess || !Receiver.Resolve(ReceivedPose, AckIndex))
+				{
+					++Result.NumDropped;
+					continue;
+				}
+
+				// Acks arrive instantly here, over a real connection deltas stay on the old baseline for a round trip longer
+				if (AckIndex != INDEX_NONE)
+					Sender.OnBaselineAcked((uint8)AckIndex);
+
+				const float PositionError = (ReceivedPose.Position - SourcePose.GetLocation()).Size();
+				const float RotationError = FMath::RadiansToDegrees(SourcePose.GetRotation().AngularDistance(ReceivedPose.Rotation.Quaternion()));
+
+				Result.PositionErrorSum += PositionError;
+				Result.PositionErrorMax = FMath::Max(Result.PositionErrorMax, PositionError);
+				Result.RotationErrorSum += RotationError;
+				Result.RotationErrorMax = FMath::Max(Result.RotationErrorMax, RotationError);
+				++Result.NumPoses;
+			}
+		}
+
+		const int32 NumSent = Result.NumPoses + Result.NumDropped;
+		if (!NumSent)
+			return;
+
+		UE_LOG(LogVRMotionController, Display, TEXT("%-32s %6.1f bits/pose | pos err avg %.4f max %.4f cm | rot err avg %.4f max %.4f deg | dropped %d"),
+			EncodingName,
+			Result.TotalBits / NumSent,
+			Result.NumPoses ? Result.PositionErrorSum / Result.NumPoses : 0.0,
+			Result.PositionErrorMax,
+			Result.NumPoses ? Result.RotationErrorSum / Result.NumPoses : 0.0,
+			Result.RotationErrorMax,
+			Result.NumDropped);
+	}
+
+	void RunPoseEncodingBenchmark(const TArray<FString> & Args)
+	{
+		const FString FileName = GetPoseFileName(Args, 0);
+
+		TArray<uint8> Data;
+		if (!FFileHelper::LoadFileToArray(Data, *FileName))
+		{
+			UE_LOG(LogVRMotionController, Warning, TEXT("Couldn't read pose recording %s, record one with vr.RecordPoses"), *FileName);
+			return;
+		}
+
+		TArray<TArray<FTransform>> Tracks;
+		FMemoryReader Reader(Data);
+		if (!SerializePoseTracks(Reader, Tracks))
+		{
+			UE_LOG(LogVRMotionController, Warning, TEXT("%s is not a valid pose recording"), *FileName);
+			return;
+		}
+
+		int32 NumPoses = 0;
+		for (const TArray<FTransform> & Track : Tracks)
+			NumPoses += Track.Num();
+
+		UE_LOG(LogVRMotionController, Display, TEXT("Pose encoding benchmark: %d poses from %d components in %s"), NumPoses, Tracks.Num(), *FileName);
+
+		FBPVRComponentPosRep Encoding;
+
+		Encoding.QuantizationLevel = EVRVectorQuantization::RoundTwoDecimals;
+		RunPoseEncoding(Tracks, TEXT("Euler shorts, two decimals"), Encoding);
+
+		Encoding.QuantizationLevel = EVRVectorQuantization::RoundOneDecimal;
+		RunPoseEncoding(Tracks, TEXT("Euler shorts, one decimal"), Encoding);
+
+		Encoding.QuantizationLevel = EVRVectorQuantization::RoundTwoDecimals;
+		Encoding.bUseSmallestThreeRotation = true;
+
+		const uint8 SmallestThreeBits[] = { 9, 11, 13, 15 };
+		for (uint8 Bits : SmallestThreeBits)
+		{
+			Encoding.SmallestThreeBits = Bits;
+			RunPoseEncoding(Tracks, *FString::Printf(TEXT("Smallest three %d, two decimals"), Bits), Encoding);
+		}
+
+		Encoding.bDeltaEncodePosition = true;
+
+		Encoding.SmallestThreeBits = 11;
+		RunPoseEncoding(Tracks, TEXT("Smallest three 11, delta"), Encoding);
+
+		Encoding.bUseSmallestThreeRotation = false;
+		RunPoseEncoding(Tracks, TEXT("Euler shorts, delta"), Encoding);
+	}
+
+	void WritePoseRecording()
+	{
+		TArray<TArray<FTransform>> Tracks;
+		int32 NumPoses = 0;
+
+		for (TPair<const USceneComponent *, TArray<FTransform>> & Track : PoseRecording.Tracks)
+		{
+			NumPoses += Track.Value.Num();
+			Tracks.Add(MoveTemp(Track.Value));
+		}
+
+		PoseRecording.Tracks.Empty();
+
+		TArray<uint8> Data;
+		FMemoryWriter Writer(Data);
+
+		if (!SerializePoseTracks(Writer, Tracks) || !FFileHelper::SaveArrayToFile(Data, *PoseRecording.FileName))
+		{
+			UE_LOG(LogVRMotionController, Warning, TEXT("Failed to write pose recording to %s"), *PoseRecording.FileName);
+			return;
+		}
+
+		UE_LOG(LogVRMotionController, Display, TEXT("Wrote %d poses from %d components to %s"), NumPoses, Tracks.Num(), *PoseRecording.FileName);
+	}
+
+	bool TickPoseRecording(float DeltaTime)
+	{
+		UWorld * World = PoseRecording.World.Get();
+
+		if (!World)
+		{
+			PoseRecording.Tracks.Empty();
+			PoseRecording.TickerHandle.Reset();
+			return false;
+		}
+
+		for (TObjectIterator<UGripMotionControllerComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == World && It->IsRegistered())
+				PoseRecording.Tracks.FindOrAdd(*It).Add(It->GetRelativeTransform());
+		}
+
+		for (TObjectIterator<UReplicatedVRCameraComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == World && It->IsRegistered())
+				PoseRecording.Tracks.FindOrAdd(*It).Add(It->GetRelativeTransform());
+		}
+
+		if (--PoseRecording.FramesLeft > 0)
+			return true;
+
+		WritePoseRecording();
+		PoseRecording.TickerHandle.Reset();
+		return false;
+	}
+
+	void StartPoseRecording(const TArray<FString> & Args, UWorld * World)
+	{
+		if (!World || PoseRecording.TickerHandle.IsValid())
+			return;
+
+		PoseRecording.World = World;
+		PoseRecording.FramesLeft = Args.Num() ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 600;
+		PoseRecording.FileName = GetPoseFileName(Args, 1);
+		PoseRecording.Tracks.Empty();
+		PoseRecording.TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&TickPoseRecording));
+
+		UE_LOG(LogVRMotionController, Display, TEXT("Recording tracked component poses for %d frames"), PoseRecording.FramesLeft);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs RecordPosesCommand(
+	TEXT("vr.RecordPoses"),
+	TEXT("Records tracked component poses for [Frames] frames (600 default) and writes them to [FileName] (Saved/VRPoses.vrposes default)."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StartPoseRecording));
+
+static FAutoConsoleCommandWithArgs PoseEncodingBenchmarkCommand(
+	TEXT("vr.PoseEncodingBenchmark"),
+	TEXT("Loads a vr.RecordPoses recording [FileName] (Saved/VRPoses.vrposes default) and logs bits per pose and error for each pose encoding."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunPoseEncodingBenchmark));
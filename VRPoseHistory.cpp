@@ -0,0 +1,147 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "VRPoseHistory.h"
+#include "VRBaseCharacter.h"
+#include "GripMotionControllerComponent.h"
+
+//For UE4 Profiler ~ Stat
+DECLARE_CYCLE_STAT(TEXT("TickGrip ~ PoseHistoryRewind"), STAT_PoseHistoryRewind, STATGROUP_TickGrip);
+DECLARE_CYCLE_STAT(TEXT("TickGrip ~ PoseHistoryRestore"), STAT_PoseHistoryRestore, STATGROUP_TickGrip);
+
+FVRPoseHistory::FVRPoseHistory()
+{
+	Reset();
+}
+
+void FVRPoseHistory::Reset()
+{
+	First = 0;
+	Num = 0;
+}
+
+void FVRPoseHistory::Record(float Time, const FTransform & Root, const FTransform & HMD, const FTransform & LeftController, const FTransform & RightController)
+{
+	FPoseFrame * Frame = nullptr;
+
+	if (Num && Time <= GetFrame(Num - 1).Time)
+	{
+		Frame = &Frames[(First + Num - 1) % MaxFrames];
+	}
+	else
+	{
+		// Overwrite the oldest once full
+		if (Num == MaxFrames)
+		{
+			First = (First + 1) % MaxFrames;
+			--Num;
+		}
+
+		Frame = &Frames[(First + Num) % MaxFrames];
+		++Num;
+	}
+
+	Frame->Time = Time;
+	Frame->Root = Root;
+	Frame->HMD = HMD;
+	Frame->LeftController = LeftController;
+	Frame->RightController = RightController;
+}
+
+bool FVRPoseHistory::Sample(float Time, FPoseFrame & OutFrame) const
+{
+	if (!Num)
+		return false;
+
+	if (Time <= GetFrame(0).Time)
+	{
+		OutFrame = GetFrame(0);
+		return true;
+	}
+
+	if (Time >= GetFrame(Num - 1).Time)
+	{
+		OutFrame = GetFrame(Num - 1);
+		return true;
+	}
+
+	// Newest frame at or before Time
+	int32 Low = 0;
+	int32 High = Num - 1;
+	while (High - Low > 1)
+	{
+		const int32 Mid = (Low + High) / 2;
+
+		if (GetFrame(Mid).Time <= Time)
+			Low = Mid;
+		else
+			High = Mid;
+	}
+
+	const FPoseFrame & Before = GetFrame(Low);
+	const FPoseFrame & After = GetFrame(High);
+	const float Alpha = (Time - Before.Time) / (After.Time - Before.Time);
+
+	OutFrame.Time = Time;
+	OutFrame.Root.Blend(Before.Root, After.Root, Alpha);
+	OutFrame.HMD.Blend(Before.HMD, After.HMD, Alpha);
+	OutFrame.LeftController.Blend(Before.LeftController, After.LeftController, Alpha);
+	OutFrame.RightController.Blend(Before.RightController, After.RightController, Alpha);
+	return true;
+}
+
+FVRPoseRewindScope::FVRPoseRewindScope(const TArray<AVRBaseCharacter *> & Pawns, float RewindTime) :
+	NumRewound(0)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PoseHistoryRewind);
+
+	FVRPoseHistory::FPoseFrame Frame;
+
+	for (AVRBaseCharacter * Pawn : Pawns)
+	{
+		if (!Pawn || Pawn->IsPendingKill() || !Pawn->PoseHistory.Sample(RewindTime, Frame))
+			continue;
+
+		// Root first, the rest are placed relative to it once it is rewound
+		Rewind(Pawn->GetRootComponent(), Frame.Root);
+		Rewind(Pawn->VRReplicatedCamera, Frame.HMD);
+		Rewind(Pawn->LeftMotionController, Frame.LeftController);
+		Rewind(Pawn->RightMotionController, Frame.RightController);
+
+		++NumRewound;
+	}
+}
+
+FVRPoseRewindScope::~FVRPoseRewindScope()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PoseHistoryRestore);
+
+	for (int32 i = RewoundComponents.Num() - 1; i >= 0; --i)
+	{
+		FRewoundComponent & Rewound = RewoundComponents[i];
+
+		if (!Rewound.Component || Rewound.Component->IsPendingKill())
+			continue;
+
+		Rewound.Component->RelativeLocation = Rewound.OriginalRelativeLocation;
+		Rewound.Component->RelativeRotation = Rewound.OriginalRelativeRotation;
+		Rewound.Component->UpdateComponentToWorld(EUpdateTransformFlags::None, ETeleportType::TeleportPhysics);
+	}
+}
+
+void FVRPoseRewindScope::Rewind(USceneComponent * Component, const FTransform & WorldTransform)
+{
+	if (!Component)
+		return;
+
+	FRewoundComponent & Rewound = RewoundComponents[RewoundComponents.AddUninitialized()];
+	Rewound.Component = Component;
+	Rewound.OriginalRelativeLocation = Component->RelativeLocation;
+	Rewound.OriginalRelativeRotation = Component->RelativeRotation;
+
+	const FTransform RelativeTransform = Component->GetAttachParent() ? WorldTransform.GetRelativeTransform(Component->GetAttachParent()->GetSocketTransform(Component->GetAttachSocketName())) : WorldTransform;
+
+	// Set directly and updated with a teleport, going through MoveComponent would update overlaps at the rewound spot
+	Component->RelativeLocation = RelativeTransform.GetLocation();
+	Component->RelativeRotation = RelativeTransform.Rotator();
+	Component->UpdateComponentToWorld(EUpdateTransformFlags::None, ETeleportType::TeleportPhysics);
+}
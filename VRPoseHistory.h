@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AVRBaseCharacter;
+class USceneComponent;
+
+/**
+* Server side history of a pawns tracked poses for lag compensated hit tests on hands and heads.
+* Fixed capacity ring of world space root (capsule), HMD and controller transforms, stored inline so recording
+* never allocates and a rewind only touches one contiguous block per pawn.
+*/
+struct VREXPANSIONPLUGIN_API FVRPoseHistory
+{
+public:
+
+	// At a 60htz server tick this covers a little over a second
+	static const int32 MaxFrames = 64;
+
+	struct FPoseFrame
+	{
+		FTransform Root;
+		FTransform HMD;
+		FTransform LeftController;
+		FTransform RightController;
+		float Time;
+	};
+
+	FVRPoseHistory();
+
+	// Records a frame, Time has to be increasing, a frame with the same time as the newest replaces it
+	void Record(float Time, const FTransform & Root, const FTransform & HMD, const FTransform & LeftController, const FTransform & RightController);
+
+	// Gets the poses at Time, interpolated between the recorded frames around it and clamped to the recorded range.
+	// Returns false if nothing has been recorded.
+	bool Sample(float Time, FPoseFrame & OutFrame) const;
+
+	void Reset();
+
+	FORCEINLINE int32 GetNum() const
+	{
+		return Num;
+	}
+
+	FORCEINLINE float GetOldestTime() const
+	{
+		return Num ? GetFrame(0).Time : 0.0f;
+	}
+
+private:
+
+	// Oldest to newest, Frames[(First + i) % MaxFrames]
+	FPoseFrame Frames[MaxFrames];
+	int32 First;
+	int32 Num;
+
+	FORCEINLINE const FPoseFrame & GetFrame(int32 Index) const
+	{
+		return Frames[(First + Index) % MaxFrames];
+	}
+};
+
+/**
+* Rewinds a set of pawns to where their pose history has them at a server time and puts them back when it goes out of scope.
+* The root, camera and controllers are teleported so anything attached to them (hand meshes, head colliders) is traced in its
+* rewound spot. They are moved by setting the transform directly instead of through MoveComponent, so the round trip doesn't
+* fire begin / end overlap events.
+*
+*	{
+*		FVRPoseRewindScope Rewind(Pawns, Shooter->GetServerTimeForClientTime(ShotClientTime));
+*		GetWorld()->LineTraceSingleByChannel(...);
+*	}
+*/
+class VREXPANSIONPLUGIN_API FVRPoseRewindScope : public FNoncopyable
+{
+public:
+
+	FVRPoseRewindScope(const TArray<AVRBaseCharacter *> & Pawns, float RewindTime);
+	~FVRPoseRewindScope();
+
+	FORCEINLINE int32 GetNumRewound() const
+	{
+		return NumRewound;
+	}
+
+private:
+
+	struct FRewoundComponent
+	{
+		USceneComponent * Component;
+		FVector OriginalRelativeLocation;
+		FRotator OriginalRelativeRotation;
+	};
+
+	void Rewind(USceneComponent * Component, const FTransform & WorldTransform);
+
+	// Root, camera and both controllers per pawn, inline for a full 64 player server so a rewind never allocates
+	static const int32 MaxInlineRewoundComponents = 64 * 4;
+
+	// In rewind order, restored in reverse so that each component is put back relative to its still rewound parent
+	TArray<FRewoundComponent, TInlineAllocator<MaxInlineRewoundComponents>> RewoundComponents;
+	int32 NumRewound;
+};
@@ -0,0 +1,205 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "VRPoseSnapshotBuffer.h"
+#include "GripMotionControllerComponent.h"
+
+//For UE4 Profiler ~ Stat
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGrip ~ PoseSamplesExtrapolated"), STAT_PoseSamplesExtrapolated, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGrip ~ PoseSamplesStarved"), STAT_PoseSamplesStarved, STATGROUP_TickGrip);
+
+// Weight of a new interval in the running interval / jitter estimates
+static const float PoseIntervalSmoothing = 0.1f;
+
+// Rate the delay eases towards its target at, slow enough that the shift in playback speed isn't visible
+static const float PoseDelayInterpSpeed = 2.0f;
+
+FVRPoseSnapshotBuffer::FVRPoseSnapshotBuffer()
+{
+	Reset();
+}
+
+void FVRPoseSnapshotBuffer::Reset()
+{
+	First = 0;
+	Num = 0;
+	MeanInterval = 0.0f;
+	IntervalJitter = 0.0f;
+	CurrentDelay = 0.0f;
+	LastSampleTime = 0.0;
+	bHasDelay = false;
+}
+
+void FVRPoseSnapshotBuffer::PushSnapshot(double Time, const FVector & Position, const FQuat & Rotation)
+{
+	if (Num == MaxSnapshots)
+	{
+		First = (First + 1) % MaxSnapshots;
+		--Num;
+	}
+
+	FPoseSnapshot & NewSnapshot = Snapshots[(First + Num) % MaxSnapshots];
+	NewSnapshot.Time = Time;
+	NewSnapshot.Position = Position;
+	NewSnapshot.Rotation = Rotation;
+	++Num;
+}
+
+void FVRPoseSnapshotBuffer::AddSnapshot(const FVector & Position, const FRotator & Rotation, double ArrivalTime, const FBPVRPoseSmoothingSettings & Settings)
+{
+	FQuat NewRotation = Rotation.Quaternion();
+
+	if (!Num)
+	{
+		PushSnapshot(ArrivalTime, Position, NewRotation);
+		return;
+	}
+
+	const FPoseSnapshot & Newest = GetSnapshot(Num - 1);
+
+	// Keep every rotation in the same hemisphere as the one before it so the spline doesn't take the long way around
+	if ((Newest.Rotation | NewRotation) < 0.0f)
+		NewRotation = NewRotation * -1.0f;
+
+	const float Interval = (float)(ArrivalTime - Newest.Time);
+
+	// More than one update processed in the same frame, the newest wins
+	if (Interval <= KINDA_SMALL_NUMBER)
+	{
+		FPoseSnapshot & Replaced = Snapshots[(First + Num - 1) % MaxSnapshots];
+		Replaced.Position = Position;
+		Replaced.Rotation = NewRotation;
+		return;
+	}
+
+	// Poses are only sent when they change, so a long gap is the sender sitting still and not network jitter.
+	// Hold the last pose until just before this one instead of crawling across the whole gap, and keep it out of the estimates.
+	const float GapInterval = MeanInterval > 0.0f ? FMath::Max(MeanInterval * 4.0f, Settings.MaxInterpolationDelay) : Settings.MaxInterpolationDelay;
+	if (Interval > GapInterval)
+	{
+		const double HoldTime = ArrivalTime - (MeanInterval > 0.0f ? MeanInterval : Settings.InterpolationDelay);
+
+		if (HoldTime > Newest.Time)
+		{
+			// Copied, pushing can overwrite the slot Newest refers to
+			const FVector HoldPosition = Newest.Position;
+			const FQuat HoldRotation = Newest.Rotation;
+			PushSnapshot(HoldTime, HoldPosition, HoldRotation);
+		}
+	}
+	else
+	{
+		if (MeanInterval <= 0.0f)
+			MeanInterval = Interval;
+		else
+			MeanInterval = FMath::Lerp(MeanInterval, Interval, PoseIntervalSmoothing);
+
+		IntervalJitter = FMath::Lerp(IntervalJitter, FMath::Abs(Interval - MeanInterval), PoseIntervalSmoothing);
+	}
+
+	PushSnapshot(ArrivalTime, Position, NewRotation);
+}
+
+void FVRPoseSnapshotBuffer::InterpolateSegment(int32 Index, double RenderTime, FVector & OutPosition, FQuat & OutRotation) const
+{
+	const FPoseSnapshot & Start = GetSnapshot(Index);
+	const FPoseSnapshot & End = GetSnapshot(Index + 1);
+	const FPoseSnapshot & Prev = Index > 0 ? GetSnapshot(Index - 1) : Start;
+	const FPoseSnapshot & Next = Index + 2 < Num ? GetSnapshot(Index + 2) : End;
+
+	const float SegmentDuration = (float)(End.Time - Start.Time);
+	const float Alpha = FMath::Clamp((float)(RenderTime - Start.Time) / SegmentDuration, 0.0f, 1.0f);
+
+	// Catmull-Rom tangents for unevenly spaced poses, scaled to this segments duration
+	const FVector StartTangent = (End.Position - Prev.Position) * (SegmentDuration / (float)(End.Time - Prev.Time));
+	const FVector EndTangent = (Next.Position - Start.Position) * (SegmentDuration / (float)(Next.Time - Start.Time));
+
+	OutPosition = FMath::CubicInterp(Start.Position, StartTangent, End.Position, EndTangent, Alpha);
+
+	FQuat StartRotTangent, EndRotTangent;
+	FQuat::CalcTangents(Prev.Rotation, Start.Rotation, End.Rotation, 0.0f, StartRotTangent);
+	FQuat::CalcTangents(Start.Rotation, End.Rotation, Next.Rotation, 0.0f, EndRotTangent);
+
+	OutRotation = FQuat::Squad(Start.Rotation, StartRotTangent, End.Rotation, EndRotTangent, Alpha);
+}
+
+void FVRPoseSnapshotBuffer::Extrapolate(double RenderTime, const FBPVRPoseSmoothingSettings & Settings, FVector & OutPosition, FQuat & OutRotation) const
+{
+	const FPoseSnapshot & Newest = GetSnapshot(Num - 1);
+	OutPosition = Newest.Position;
+	OutRotation = Newest.Rotation;
+
+	if (Num < 2)
+		return;
+
+	const FPoseSnapshot & Prev = GetSnapshot(Num - 2);
+	const float Ahead = FMath::Min((float)(RenderTime - Newest.Time), Settings.MaxExtrapolationTime);
+
+	if (Ahead <= 0.0f)
+		return;
+
+	// Carry on at the last segments velocity
+	const float Scale = Ahead / (float)(Newest.Time - Prev.Time);
+	OutPosition += (Newest.Position - Prev.Position) * Scale;
+
+	FVector Axis;
+	float Angle;
+	(Newest.Rotation * Prev.Rotation.Inverse()).ToAxisAndAngle(Axis, Angle);
+	OutRotation = FQuat(Axis, FMath::UnwindRadians(Angle) * Scale) * Newest.Rotation;
+	OutRotation.Normalize();
+}
+
+bool FVRPoseSnapshotBuffer::Sample(double Now, const FBPVRPoseSmoothingSettings & Settings, FVector & OutPosition, FRotator & OutRotation)
+{
+	if (!Num)
+		return false;
+
+	float TargetDelay = Settings.InterpolationDelay;
+	if (Settings.bAdaptiveDelay && MeanInterval > 0.0f)
+		TargetDelay = FMath::Clamp(MeanInterval + IntervalJitter * Settings.JitterDelayScale, Settings.MinInterpolationDelay, Settings.MaxInterpolationDelay);
+
+	if (!bHasDelay)
+	{
+		CurrentDelay = TargetDelay;
+		bHasDelay = true;
+	}
+	else
+	{
+		// Eased instead of set so the render time never jumps, playback just runs slightly fast or slow for a moment
+		CurrentDelay = FMath::FInterpTo(CurrentDelay, TargetDelay, (float)FMath::Max(Now - LastSampleTime, 0.0), PoseDelayInterpSpeed);
+	}
+
+	LastSampleTime = Now;
+
+	const double RenderTime = Now - CurrentDelay;
+	FQuat SampledRotation = FQuat::Identity;
+
+	if (RenderTime <= GetSnapshot(0).Time)
+	{
+		OutPosition = GetSnapshot(0).Position;
+		SampledRotation = GetSnapshot(0).Rotation;
+	}
+	else if (RenderTime >= GetSnapshot(Num - 1).Time)
+	{
+		if (RenderTime - GetSnapshot(Num - 1).Time > Settings.MaxExtrapolationTime)
+		{
+			INC_DWORD_STAT(STAT_PoseSamplesStarved);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_PoseSamplesExtrapolated);
+		}
+
+		Extrapolate(RenderTime, Settings, OutPosition, SampledRotation);
+	}
+	else
+	{
+		int32 Index = Num - 2;
+		while (Index > 0 && GetSnapshot(Index).Time > RenderTime)
+			--Index;
+
+		InterpolateSegment(Index, RenderTime, OutPosition, SampledRotation);
+	}
+
+	OutRotation = SampledRotation.Rotator();
+	return true;
+}
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VRBPDatatypes.h"
+
+/**
+* Jitter buffer for the replicated poses of remote tracked components (motion controllers, cameras).
+* Poses are stamped with their local arrival time and sampled a short delay behind the newest one, with hermite
+* interpolation for the position and a quaternion spline for the rotation. When the delay is adaptive it is sized from
+* the measured update interval and arrival jitter, so a late update is covered by the buffer instead of hitching.
+* Past the newest pose it extrapolates for a bounded time and then holds.
+*/
+struct VREXPANSIONPLUGIN_API FVRPoseSnapshotBuffer
+{
+public:
+
+	static const int32 MaxSnapshots = 8;
+
+	FVRPoseSnapshotBuffer();
+
+	// Adds a received pose, ArrivalTime has to come from the same clock as the times passed in to Sample
+	void AddSnapshot(const FVector & Position, const FRotator & Rotation, double ArrivalTime, const FBPVRPoseSmoothingSettings & Settings);
+
+	// Gets the pose to display at Now, returns false if nothing has been received yet
+	bool Sample(double Now, const FBPVRPoseSmoothingSettings & Settings, FVector & OutPosition, FRotator & OutRotation);
+
+	void Reset();
+
+	FORCEINLINE float GetInterpolationDelay() const
+	{
+		return CurrentDelay;
+	}
+
+private:
+
+	struct FPoseSnapshot
+	{
+		double Time;
+		FVector Position;
+		FQuat Rotation;
+	};
+
+	// Oldest to newest, Snapshots[(First + i) % MaxSnapshots]
+	FPoseSnapshot Snapshots[MaxSnapshots];
+	int32 First;
+	int32 Num;
+
+	FORCEINLINE const FPoseSnapshot & GetSnapshot(int32 Index) const
+	{
+		return Snapshots[(First + Index) % MaxSnapshots];
+	}
+
+	void PushSnapshot(double Time, const FVector & Position, const FQuat & Rotation);
+	void InterpolateSegment(int32 Index, double RenderTime, FVector & OutPosition, FQuat & OutRotation) const;
+	void Extrapolate(double RenderTime, const FBPVRPoseSmoothingSettings & Settings, FVector & OutPosition, FQuat & OutRotation) const;
+
+	// Running estimates of the update interval and of how far arrivals stray from it
+	float MeanInterval;
+	float IntervalJitter;
+
+	float CurrentDelay;
+	double LastSampleTime;
+	bool bHasDelay;
+};
@@ -1,6 +1,7 @@
 // Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
 
 #include "VRRootComponent.h"
+#include "VRServerMoveRecorder.h"
 //#include "Runtime/Engine/Private/EnginePrivate.h"
 
 #include "PhysicsPublic.h"
@@ -16,6 +17,13 @@
 
 static int32 bEnableFastOverlapCheck = 1;
 
+static TAutoConsoleVariable<int32> CVarVRRootIncrementalOverlaps(
+	TEXT("vr.VRRootIncrementalOverlaps"),
+	1,
+	TEXT("1: VR root overlap updates after swept moves test only the components the sweeps reported.\n")
+	TEXT("0: Swept overlaps are never converted and every update runs a full overlap query, to compare against with vr.ReplayServerMoves.\n"),
+	ECVF_Default);
+
 
 // LOOKING_FOR_PERF_ISSUES
 #define PERF_MOVECOMPONENT_STATS 0
@@ -258,6 +266,15 @@ UVRRootComponent::UVRRootComponent(const FObjectInitializer& ObjectInitializer)
 	curCameraLoc = FVector::ZeroVector;
 	TargetPrimitiveComponent = NULL;
 	owningVRChar = NULL;
+	OwningCharacterMovement = NULL;
+
+	bSweptOverlapsCoverMove = false;
+	bSweptSinceOverlapUpdate = false;
+
+	RelativeMovementSweepDistance = 0.5f;
+	RelativeMovementSweepInterval = 0.05f;
+	PendingRelativeMovement = FVector::ZeroVector;
+	TimeSinceRelativeMovementSweep = 0.0f;
 	//VRCameraCollider = NULL;
 
 	bUseWalkingCollisionOverride = false;
@@ -280,6 +297,8 @@ void UVRRootComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (ACharacter * OwningCharacter = Cast<ACharacter>(this->GetOwner()))
+		OwningCharacterMovement = OwningCharacter->GetCharacterMovement();
 
 	if(AVRBaseCharacter * vrOwner = Cast<AVRBaseCharacter>(this->GetOwner()))
 	{ 
@@ -345,44 +364,50 @@ void UVRRootComponent::TickComponent(float DeltaTime, enum ELevelTick TickType,
 			OnUpdateTransform(EUpdateTransformFlags::None, ETeleportType::None);
 			//GenerateOffsetToWorld(false);
 
-			FHitResult OutHit;
-			FCollisionQueryParams Params("RelativeMovementSweep", false, GetOwner());
-			FCollisionResponseParams ResponseParam;
-
-			InitSweepCollisionParams(Params, ResponseParam);
-			Params.bFindInitialOverlaps = true;
-			bool bBlockingHit = false;
+			PendingRelativeMovement += OffsetComponentToWorld.GetLocation() - LastPosition;
+			TimeSinceRelativeMovementSweep += DeltaTime;
 
-			if (bUseWalkingCollisionOverride)
+			// Sway is swept in batches, bHadRelativeMovement holds the last sweeps result in between
+			if (PendingRelativeMovement.SizeSquared() >= FMath::Square(RelativeMovementSweepDistance) || TimeSinceRelativeMovementSweep >= RelativeMovementSweepInterval)
 			{
-				ACharacter * OwningCharacter = Cast<ACharacter>(GetOwner());
+				INC_DWORD_STAT(STAT_VRRootRelativeSweeps);
+				FVRServerMoveRecorder::CountSweep();
+
+				// Swept from where the accumulated movement started relative to the capsules current spot, so that the
+				// characters own movement since the last sweep isn't swept again.
+				const FVector SweepStart = OffsetComponentToWorld.GetLocation() - PendingRelativeMovement;
+				PendingRelativeMovement = FVector::ZeroVector;
+				TimeSinceRelativeMovementSweep = 0.0f;
+
+				FHitResult OutHit;
+				FCollisionQueryParams Params("RelativeMovementSweep", false, GetOwner());
+				FCollisionResponseParams ResponseParam;
+
+				InitSweepCollisionParams(Params, ResponseParam);
+				Params.bFindInitialOverlaps = true;
+
+				ECollisionChannel SweepChannel = GetCollisionObjectType();
 
-				bool bAllowWalkingCollision = false;
-				if (OwningCharacter)
+				if (bUseWalkingCollisionOverride && OwningCharacterMovement &&
+					(OwningCharacterMovement->MovementMode == EMovementMode::MOVE_Walking || OwningCharacterMovement->MovementMode == EMovementMode::MOVE_NavWalking))
 				{
-					if (UCharacterMovementComponent * CharMove = Cast<UCharacterMovementComponent>(OwningCharacter->GetCharacterMovement()))
-					{
-						if (CharMove->MovementMode == EMovementMode::MOVE_Walking || CharMove->MovementMode == EMovementMode::MOVE_NavWalking)
-							bAllowWalkingCollision = true;
-					}
+					SweepChannel = WalkingCollisionOverride;
 				}
 
-				if (bAllowWalkingCollision)
-					bBlockingHit = GetWorld()->SweepSingleByChannel(OutHit, LastPosition, OffsetComponentToWorld.GetLocation(), FQuat(0.0f, 0.0f, 0.0f, 1.0f), WalkingCollisionOverride, GetCollisionShape(), Params, ResponseParam);
+				const bool bBlockingHit = GetWorld()->SweepSingleByChannel(OutHit, SweepStart, OffsetComponentToWorld.GetLocation(), FQuat(0.0f, 0.0f, 0.0f, 1.0f), SweepChannel, GetCollisionShape(), Params, ResponseParam);
+
+				// #TODO: should i consider the ignore physics objects setting for the sim check here?
+				if (bBlockingHit && OutHit.Component.IsValid() && !OutHit.Component->IsSimulatingPhysics())
+				{
+					bHadRelativeMovement = true;
+				}
 				else
-					bBlockingHit = GetWorld()->SweepSingleByChannel(OutHit, LastPosition, OffsetComponentToWorld.GetLocation(), FQuat(0.0f, 0.0f, 0.0f, 1.0f), GetCollisionObjectType(), GetCollisionShape(), Params, ResponseParam);
-				// If we had a valid blocking hit
+					bHadRelativeMovement = false;
 			}
 			else
-				bBlockingHit = GetWorld()->SweepSingleByChannel(OutHit, LastPosition, OffsetComponentToWorld.GetLocation(), FQuat(0.0f, 0.0f, 0.0f, 1.0f), GetCollisionObjectType(), GetCollisionShape(), Params, ResponseParam);
-
-			// #TODO: should i consider the ignore physics objects setting for the sim check here?
-			if (bBlockingHit && OutHit.Component.IsValid() && !OutHit.Component->IsSimulatingPhysics())
 			{
-				bHadRelativeMovement = true;
+				INC_DWORD_STAT(STAT_VRRootRelativeSweepsSkipped);
 			}
-			else
-				bHadRelativeMovement = false;
 
 			lastCameraLoc = curCameraLoc;
 			lastCameraRot = curCameraRot;
@@ -391,7 +416,13 @@ void UVRRootComponent::TickComponent(float DeltaTime, enum ELevelTick TickType,
 			DifferenceFromLastFrame.Z = 0.0f; // Reset Z to zero, its not used anyway and this lets me reuse the Z component for capsule half height
 		}
 		else
+		{
 			bHadRelativeMovement = false;
+
+			// Nothing moved, an unswept remainder under the threshold is dropped rather than swept from a stale start once sway resumes
+			PendingRelativeMovement = FVector::ZeroVector;
+			TimeSinceRelativeMovementSweep = 0.0f;
+		}
 	}
 	else
 	{
@@ -596,6 +627,7 @@ bool UVRRootComponent::MoveComponentImpl(const FVector& Delta, const FQuat& NewR
 			InitSweepCollisionParams(Params, ResponseParam);
 
 			bool const bHadBlockingHit = MyWorld->ComponentSweepMulti(Hits, this, TraceStart, TraceEnd, InitialRotationQuat, Params);
+			FVRServerMoveRecorder::CountSweep();
 
 			if (Hits.Num() > 0)
 			{
@@ -748,6 +780,11 @@ bool UVRRootComponent::MoveComponentImpl(const FVector& Delta, const FQuat& NewR
 	// Handle overlap notifications.
 	if (bMoved)
 	{
+		if (!bIncludesOverlapsAtEnd)
+			bSweptOverlapsCoverMove = false;
+		else if (bSweep && !bRotationOnly)
+			bSweptSinceOverlapUpdate = true;
+
 		if (IsDeferringMovementUpdates())
 		{
 			// Defer UpdateOverlaps until the scoped move ends.
@@ -808,6 +845,35 @@ bool UVRRootComponent::MoveComponentImpl(const FVector& Delta, const FQuat& NewR
 	return bMoved;
 }
 
+void UVRRootComponent::UpdateOverlaps(TArray<FOverlapInfo> const* NewPendingOverlaps, bool bDoNotifies, const TArray<FOverlapInfo>* OverlapsAtEndLocation)
+{
+	TArray<FOverlapInfo> SweptOverlapsAtEndLocation;
+
+	if (!OverlapsAtEndLocation && NewPendingOverlaps && bSweptOverlapsCoverMove && bSweptSinceOverlapUpdate)
+	{
+		// Tested at the offset location, the engines own conversion for scoped moves would test at the component location
+		OverlapsAtEndLocation = ConvertSweptOverlapsToCurrentOverlaps(SweptOverlapsAtEndLocation, *NewPendingOverlaps, 0, OffsetComponentToWorld.GetLocation(), GetComponentQuat());
+	}
+
+	if (OverlapsAtEndLocation)
+	{
+		INC_DWORD_STAT(STAT_VRRootOverlapUpdatesIncremental);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_VRRootOverlapUpdatesFull);
+
+		if (bGenerateOverlapEvents && IsQueryCollisionEnabled())
+			FVRServerMoveRecorder::CountOverlapQuery();
+	}
+
+	// Reset before the update, overlap events can move us again
+	bSweptOverlapsCoverMove = true;
+	bSweptSinceOverlapUpdate = false;
+
+	Super::UpdateOverlaps(NewPendingOverlaps, bDoNotifies, OverlapsAtEndLocation);
+}
+
 const TArray<FOverlapInfo>* UVRRootComponent::ConvertSweptOverlapsToCurrentOverlaps(
 	TArray<FOverlapInfo>& OverlapsAtEndLocation, const TArray<FOverlapInfo>& SweptOverlaps, int32 SweptOverlapsIndex,
 	const FVector& EndLocation, const FQuat& EndRotationQuat)
@@ -817,7 +883,7 @@ const TArray<FOverlapInfo>* UVRRootComponent::ConvertSweptOverlapsToCurrentOverl
 	static const auto CVarAllowCachedOverlaps = IConsoleManager::Get().FindConsoleVariable(TEXT("p.AllowCachedOverlaps"));
 
 	const TArray<FOverlapInfo>* Result = nullptr;
-	if (bGenerateOverlapEvents && CVarAllowCachedOverlaps->GetInt())
+	if (bGenerateOverlapEvents && CVarAllowCachedOverlaps->GetInt() && CVarVRRootIncrementalOverlaps.GetValueOnGameThread())
 	{
 		const AActor* Actor = GetOwner();
 		if (Actor && Actor->GetRootComponent() == this)
@@ -840,9 +906,12 @@ const TArray<FOverlapInfo>* UVRRootComponent::ConvertSweptOverlapsToCurrentOverl
 							// Not handled yet. We could do it by checking every body explicitly and track each body index in the overlap test, but this seems like a rare need.
 							return nullptr;
 						}
-						else if (OtherPrimitive->ComponentOverlapComponent(this, EndLocation, EndRotationQuat, UnusedQueryParams))
+						else
 						{
-							OverlapsAtEndLocation.Add(OtherOverlap);
+							FVRServerMoveRecorder::CountOverlapQuery();
+
+							if (OtherPrimitive->ComponentOverlapComponent(this, EndLocation, EndRotationQuat, UnusedQueryParams))
+								OverlapsAtEndLocation.Add(OtherOverlap);
 						}
 					}
 				}
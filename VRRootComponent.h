@@ -10,10 +10,15 @@
 //DECLARE_STATS_GROUP(TEXT("VRPhysicsUpdate"), STATGROUP_VRPhysics, STATCAT_Advanced);
 
 class AVRBaseCharacter;
+class UCharacterMovementComponent;
 
 DECLARE_STATS_GROUP(TEXT("VRRootComponent"), STATGROUP_VRRootComponent, STATCAT_Advanced);
 DECLARE_CYCLE_STAT(TEXT("VR Root Set Half Height"), STAT_VRRootSetHalfHeight, STATGROUP_VRRootComponent);
 DECLARE_CYCLE_STAT(TEXT("VR Root Set Capsule Size"), STAT_VRRootSetCapsuleSize, STATGROUP_VRRootComponent);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VR Root Relative Movement Sweeps"), STAT_VRRootRelativeSweeps, STATGROUP_VRRootComponent);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VR Root Relative Movement Sweeps Skipped"), STAT_VRRootRelativeSweepsSkipped, STATGROUP_VRRootComponent);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VR Root Overlap Updates Incremental"), STAT_VRRootOverlapUpdatesIncremental, STATGROUP_VRRootComponent);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VR Root Overlap Updates Full Query"), STAT_VRRootOverlapUpdatesFull, STATGROUP_VRRootComponent);
 
 UCLASS(Blueprintable, meta = (BlueprintSpawnableComponent), ClassGroup = VRExpansionLibrary)
 class VREXPANSIONPLUGIN_API UVRRootComponent : public UCapsuleComponent, public IVRTrackedParentInterface
@@ -55,6 +60,16 @@ protected:
 
 	void SendPhysicsTransform(ETeleportType Teleport);
 
+	// Supplies the overlaps at the end location from the swept overlaps when the engine would otherwise run a full overlap
+	// query (deferred scoped moves end up here without them), see bSweptOverlapsCoverMove.
+	virtual void UpdateOverlaps(TArray<FOverlapInfo> const* PendingOverlaps = nullptr, bool bDoNotifies = true, const TArray<FOverlapInfo>* OverlapsAtEndLocation = nullptr) override;
+
+	// True while every move since the last overlap update was a sweep, each sweep reports what it starts in and passes
+	// through so together they hold everything that can be overlapped at the end. Teleports, non symmetric rotations,
+	// moves with collision off and shape changes clear it and force a full query.
+	bool bSweptOverlapsCoverMove;
+	bool bSweptSinceOverlapUpdate;
+
 	const TArray<FOverlapInfo>* ConvertRotationOverlapsToCurrentOverlaps(TArray<FOverlapInfo>& OverlapsAtEndLocation, const TArray<FOverlapInfo>& CurrentOverlaps);
 	const TArray<FOverlapInfo>* ConvertSweptOverlapsToCurrentOverlaps(
 	TArray<FOverlapInfo>& OverlapsAtEndLocation, const TArray<FOverlapInfo>& SweptOverlaps, int32 SweptOverlapsIndex,
@@ -77,6 +92,10 @@ public:
 	//UPROPERTY(BlueprintReadWrite, Transient, Category = "VRExpansionLibrary")
 	AVRBaseCharacter * owningVRChar;
 
+	// Cached in BeginPlay so the walking collision override doesn't cast through the owner every tick
+	UPROPERTY(Transient)
+	UCharacterMovementComponent * OwningCharacterMovement;
+
 	//UPROPERTY(BlueprintReadWrite, Transient, Category = "VRExpansionLibrary")
 	//UCapsuleComponent * VRCameraCollider;
 
@@ -110,6 +129,18 @@ public:
 
 	bool bHadRelativeMovement;
 
+	// HMD movement is accumulated and only swept for blocking collision once it totals this distance...
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRExpansionLibrary", meta = (ClampMin = "0.0", UIMin = "0"))
+	float RelativeMovementSweepDistance;
+
+	// ...or this many seconds have passed since the last sweep. Setting both to 0 sweeps every frame the HMD moves.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRExpansionLibrary", meta = (ClampMin = "0.0", UIMin = "0"))
+	float RelativeMovementSweepInterval;
+
+	// HMD movement since the last relative movement sweep, in world space
+	FVector PendingRelativeMovement;
+	float TimeSinceRelativeMovementSweep;
+
 	FPrimitiveSceneProxy* CreateSceneProxy() override;
 	void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
 
@@ -166,6 +197,7 @@ FORCEINLINE void UVRRootComponent::SetCapsuleSizeVR(float NewRadius, float NewHa
 
 	CapsuleHalfHeight = FMath::Max3(0.f, NewHalfHeight, NewRadius);
 	CapsuleRadius = FMath::Max(0.f, NewRadius);
+	bSweptOverlapsCoverMove = false;
 	UpdateBounds();
 	UpdateBodySetup();
 	MarkRenderStateDirty();
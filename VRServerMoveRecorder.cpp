@@ -0,0 +1,759 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "VRServerMoveRecorder.h"
+#include "VRBaseCharacterMovementComponent.h"
+#include "VRServerMoveScheduler.h"
+#include "GameFramework/Character.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "HAL/MemoryBase.h"
+
+bool FVRServerMoveRecorder::bRecording = false;
+FThreadSafeCounter FVRServerMoveRecorder::NumSweeps;
+FThreadSafeCounter FVRServerMoveRecorder::NumOverlapQueries;
+
+// File layout: header, pawn class table, movement base table, then the moves in the order they were performed.
+// Vector fields are the moves quantized values, zig-zag and var int packed. Version 2 adds the frame each move arrived on.
+
+namespace
+{
+	const uint32 ServerMoveFileMagic = 0x4D535256; // "VRSM"
+	const int32 ServerMoveFileVersion = 2;
+
+	struct FRecordedServerMove
+	{
+		FVRServerMove Move;
+		int32 PawnIndex;
+		int32 BaseIndex;
+
+		// Frames since the recording started, version 1 files get one frame per move
+		int32 Frame;
+	};
+
+	struct FServerMoveRecording
+	{
+		TArray<FString> PawnClasses;
+		TArray<FString> BasePaths;
+		TArray<FRecordedServerMove> Moves;
+
+		// Recording only, maps live objects to their table entries
+		TMap<TWeakObjectPtr<const UVRBaseCharacterMovementComponent>, int32> PawnIndices;
+		TMap<TWeakObjectPtr<UPrimitiveComponent>, int32> BaseIndices;
+
+		void Reset()
+		{
+			PawnClasses.Reset();
+			BasePaths.Reset();
+			Moves.Reset();
+			PawnIndices.Reset();
+			BaseIndices.Reset();
+		}
+	};
+
+	FServerMoveRecording Recording;
+	uint64 RecordingStartFrame = 0;
+
+	void SerializePackedInt(FArchive & Ar, int32 & Value)
+	{
+		uint32 ZigZag = (uint32)((Value << 1) ^ (Value >> 31));
+		Ar.SerializeIntPacked(ZigZag);
+
+		if (Ar.IsLoading())
+			Value = (int32)(ZigZag >> 1) ^ -(int32)(ZigZag & 1);
+	}
+
+	void SerializePackedVector(FArchive & Ar, FIntVector & Value)
+	{
+		SerializePackedInt(Ar, Value.X);
+		SerializePackedInt(Ar, Value.Y);
+		SerializePackedInt(Ar, Value.Z);
+	}
+
+	void SerializeRecordedMove(FArchive & Ar, FRecordedServerMove & Recorded, int32 Version)
+	{
+		FVRServerMove & Move = Recorded.Move;
+
+		SerializePackedInt(Ar, Recorded.PawnIndex);
+		SerializePackedInt(Ar, Recorded.BaseIndex);
+
+		if (Version >= 2)
+			SerializePackedInt(Ar, Recorded.Frame);
+
+		Ar << Move.TimeStamp;
+		SerializePackedVector(Ar, Move.Accel);
+		SerializePackedVector(Ar, Move.ClientLoc);
+		SerializePackedVector(Ar, Move.CapsuleLoc);
+		SerializePackedVector(Ar, Move.RequestedVelocity);
+		SerializePackedVector(Ar, Move.LFDiff);
+		SerializePackedVector(Ar, Move.CustomVRInputVector);
+		Ar << Move.View;
+		Ar << Move.CapsuleYaw;
+		Ar << Move.MoveFlags;
+		Ar << Move.ClientRoll;
+		Ar << Move.MovementMode;
+		Ar << Move.BaseBoneName;
+		Ar << Move.bHasClientLoc;
+	}
+
+	bool SerializeRecording(FArchive & Ar, FServerMoveRecording & InRecording)
+	{
+		uint32 Magic = ServerMoveFileMagic;
+		int32 Version = ServerMoveFileVersion;
+		Ar << Magic;
+		Ar << Version;
+
+		if (Magic != ServerMoveFileMagic || Version < 1 || Version > ServerMoveFileVersion)
+			return false;
+
+		Ar << InRecording.PawnClasses;
+		Ar << InRecording.BasePaths;
+
+		int32 NumMoves = InRecording.Moves.Num();
+		Ar << NumMoves;
+
+		if (Ar.IsLoading())
+		{
+			// Every move takes more than a byte, anything claiming more is a broken file
+			if (NumMoves < 0 || NumMoves > Ar.TotalSize())
+				return false;
+
+			InRecording.Moves.SetNum(NumMoves);
+		}
+
+		for (int32 MoveIndex = 0; MoveIndex < InRecording.Moves.Num(); ++MoveIndex)
+		{
+			FRecordedServerMove & Recorded = InRecording.Moves[MoveIndex];
+			if (Ar.IsLoading())
+				Recorded.Frame = MoveIndex;
+
+			SerializeRecordedMove(Ar, Recorded, Version);
+
+			if (Ar.IsError())
+				return false;
+		}
+
+		return !Ar.IsError();
+	}
+
+	FString GetServerMoveFileName(const TArray<FString> & Args, int32 ArgIndex)
+	{
+		FString FileName = Args.IsValidIndex(ArgIndex) ? Args[ArgIndex] : TEXT("VRServerMoves.vrmoves");
+
+		if (FPaths::IsRelative(FileName))
+			FileName = FPaths::Combine(*FPaths::GameSavedDir(), *FileName);
+
+		return FileName;
+	}
+}
+
+void FVRServerMoveRecorder::RecordMove(const UVRBaseCharacterMovementComponent * MovementComponent, const FVRServerMove & Move)
+{
+	if (!bRecording || !MovementComponent || !MovementComponent->GetOwner())
+		return;
+
+	FRecordedServerMove & Recorded = Recording.Moves[Recording.Moves.AddDefaulted()];
+	Recorded.Move = Move;
+	Recorded.Frame = (int32)(GFrameCounter - RecordingStartFrame);
+
+	if (const int32 * PawnIndex = Recording.PawnIndices.Find(MovementComponent))
+	{
+		Recorded.PawnIndex = *PawnIndex;
+	}
+	else
+	{
+		Recorded.PawnIndex = Recording.PawnClasses.Add(MovementComponent->GetOwner()->GetClass()->GetPathName());
+		Recording.PawnIndices.Add(MovementComponent, Recorded.PawnIndex);
+	}
+
+	Recorded.BaseIndex = INDEX_NONE;
+
+	if (UPrimitiveComponent * MovementBase = Move.MovementBase.Get())
+	{
+		if (const int32 * BaseIndex = Recording.BaseIndices.Find(MovementBase))
+		{
+			Recorded.BaseIndex = *BaseIndex;
+		}
+		else
+		{
+			Recorded.BaseIndex = Recording.BasePaths.Add(MovementBase->GetPathName());
+			Recording.BaseIndices.Add(MovementBase, Recorded.BaseIndex);
+		}
+	}
+}
+
+void FVRServerMoveRecorder::StartRecording()
+{
+	Recording.Reset();
+	RecordingStartFrame = GFrameCounter;
+	bRecording = true;
+}
+
+bool FVRServerMoveRecorder::StopRecording(const FString & FileName)
+{
+	bRecording = false;
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	const bool bSerialized = SerializeRecording(Writer, Recording);
+
+	const int32 NumMoves = Recording.Moves.Num();
+	const int32 NumPawns = Recording.PawnClasses.Num();
+	Recording.Reset();
+
+	if (!bSerialized || !FFileHelper::SaveArrayToFile(Data, *FileName))
+	{
+		UE_LOG(LogNetPlayerMovement, Warning, TEXT("Failed to write server move recording to %s"), *FileName);
+		return false;
+	}
+
+	UE_LOG(LogNetPlayerMovement, Display, TEXT("Wrote %d server moves from %d pawns to %s (%d bytes)"), NumMoves, NumPawns, *FileName, Data.Num());
+	return true;
+}
+
+namespace
+{
+	struct FServerMoveReplayResult
+	{
+		uint64 Cycles;
+		uint64 Sweeps;
+		uint64 OverlapQueries;
+		uint64 Allocations;
+		uint64 AllocatedBytes;
+		int32 NumMoves;
+
+		FServerMoveReplayResult() :
+			Cycles(0),
+			Sweeps(0),
+			OverlapQueries(0),
+			Allocations(0),
+			AllocatedBytes(0),
+			NumMoves(0)
+		{}
+	};
+
+	/**
+	* Sits in front of GMalloc while a replay runs and counts the game threads allocations and reallocations, everything is
+	* passed straight on to the allocator it replaced. Other threads aren't counted so that they don't add noise to the moves.
+	*/
+	class FScopedReplayMallocCounter : public FMalloc
+	{
+	public:
+
+		FScopedReplayMallocCounter() :
+			UsedMalloc(GMalloc),
+			Allocations(0),
+			AllocatedBytes(0)
+		{
+			GMalloc = this;
+		}
+
+		virtual ~FScopedReplayMallocCounter()
+		{
+			GMalloc = UsedMalloc;
+		}
+
+		uint64 GetAllocations() const { return Allocations; }
+		uint64 GetAllocatedBytes() const { return AllocatedBytes; }
+
+		virtual void * Malloc(SIZE_T Size, uint32 Alignment) override
+		{
+			Count(Size);
+			return UsedMalloc->Malloc(Size, Alignment);
+		}
+
+		virtual void * Realloc(void * Original, SIZE_T Size, uint32 Alignment) override
+		{
+			if (Size)
+				Count(Size);
+
+			return UsedMalloc->Realloc(Original, Size, Alignment);
+		}
+
+		virtual void Free(void * Original) override { UsedMalloc->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return UsedMalloc->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void * Original, SIZE_T & SizeOut) override { return UsedMalloc->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim() override { UsedMalloc->Trim(); }
+		virtual void SetupTLSCachesOnCurrentThread() override { UsedMalloc->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { UsedMalloc->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void InitializeStatsMetadata() override { UsedMalloc->InitializeStatsMetadata(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats & OutStats) override { UsedMalloc->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice & Ar) override { UsedMalloc->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return UsedMalloc->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return UsedMalloc->ValidateHeap(); }
+		virtual bool Exec(UWorld * InWorld, const TCHAR * Cmd, FOutputDevice & Ar) override { return UsedMalloc->Exec(InWorld, Cmd, Ar); }
+		virtual const TCHAR * GetDescriptiveName() override { return UsedMalloc->GetDescriptiveName(); }
+
+	private:
+
+		FORCEINLINE void Count(SIZE_T Size)
+		{
+			if (IsInGameThread())
+			{
+				++Allocations;
+				AllocatedBytes += Size;
+			}
+		}
+
+		FMalloc * UsedMalloc;
+		uint64 Allocations;
+		uint64 AllocatedBytes;
+	};
+
+	void RecordServerMoves(const TArray<FString> & Args)
+	{
+		if (Args.Num() && Args[0] == TEXT("Stop"))
+		{
+			if (FVRServerMoveRecorder::IsRecording())
+				FVRServerMoveRecorder::StopRecording(GetServerMoveFileName(Args, 1));
+		}
+		else
+		{
+			FVRServerMoveRecorder::StartRecording();
+			UE_LOG(LogNetPlayerMovement, Display, TEXT("Recording server moves, vr.RecordServerMoves Stop [FileName] to write them out"));
+		}
+	}
+
+	bool LoadServerMoveRecording(const FString & FileName, FServerMoveRecording & Replay, TArray<UClass *> & PawnClasses)
+	{
+		TArray<uint8> Data;
+
+		if (!FFileHelper::LoadFileToArray(Data, *FileName))
+		{
+			UE_LOG(LogNetPlayerMovement, Warning, TEXT("Couldn't read server move recording %s"), *FileName);
+			return false;
+		}
+
+		FMemoryReader Reader(Data);
+		if (!SerializeRecording(Reader, Replay))
+		{
+			UE_LOG(LogNetPlayerMovement, Warning, TEXT("%s is not a valid server move recording"), *FileName);
+			return false;
+		}
+
+		TArray<UPrimitiveComponent *> Bases;
+		for (const FString & BasePath : Replay.BasePaths)
+			Bases.Add(FindObject<UPrimitiveComponent>(nullptr, *BasePath));
+
+		for (const FString & ClassPath : Replay.PawnClasses)
+			PawnClasses.Add(StaticLoadClass(ACharacter::StaticClass(), nullptr, *ClassPath));
+
+		for (FRecordedServerMove & Recorded : Replay.Moves)
+			Recorded.Move.MovementBase = Bases.IsValidIndex(Recorded.BaseIndex) ? Bases[Recorded.BaseIndex] : nullptr;
+
+		return true;
+	}
+
+	// One pawn per recorded pawn, at its first reported location, so that each replay starts from the same state
+	TArray<UVRBaseCharacterMovementComponent *> SpawnReplayPawns(UWorld * World, const TArray<FRecordedServerMove> & Moves, const TArray<UClass *> & PawnClasses)
+	{
+		TArray<UVRBaseCharacterMovementComponent *> MovementComponents;
+		MovementComponents.AddZeroed(PawnClasses.Num());
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		for (const FRecordedServerMove & Recorded : Moves)
+		{
+			const int32 PawnIndex = Recorded.PawnIndex;
+
+			if (!PawnClasses.IsValidIndex(PawnIndex) || !PawnClasses[PawnIndex] || MovementComponents[PawnIndex])
+				continue;
+
+			const FVector SpawnLocation = Recorded.Move.bHasClientLoc ? FVRServerMove::Dequantize(Recorded.Move.ClientLoc, 100.0f) : FVector::ZeroVector;
+
+			if (ACharacter * Pawn = World->SpawnActor<ACharacter>(PawnClasses[PawnIndex], SpawnLocation, FRotator::ZeroRotator, SpawnParams))
+				MovementComponents[PawnIndex] = Cast<UVRBaseCharacterMovementComponent>(Pawn->GetCharacterMovement());
+		}
+
+		return MovementComponents;
+	}
+
+	void DestroyReplayPawns(const TArray<UVRBaseCharacterMovementComponent *> & MovementComponents)
+	{
+		for (UVRBaseCharacterMovementComponent * MovementComponent : MovementComponents)
+		{
+			if (MovementComponent && MovementComponent->GetOwner())
+				MovementComponent->GetOwner()->Destroy();
+		}
+	}
+
+	void RunServerMoveReplay(UWorld * World, const FString & FileName, const FServerMoveRecording & Replay, const TArray<UClass *> & PawnClasses, int32 Iterations, const TCHAR * Label)
+	{
+		// Results per movement component class, so the VR and simple characters are reported separately
+		TMap<UClass *, FServerMoveReplayResult> Results;
+		FScopedReplayMallocCounter MallocCounter;
+
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			// Fresh pawns every iteration so that each pass starts from the same state
+			const TArray<UVRBaseCharacterMovementComponent *> MovementComponents = SpawnReplayPawns(World, Replay.Moves, PawnClasses);
+
+			for (const FRecordedServerMove & Recorded : Replay.Moves)
+			{
+				UVRBaseCharacterMovementComponent * MovementComponent = MovementComponents.IsValidIndex(Recorded.PawnIndex) ? MovementComponents[Recorded.PawnIndex] : nullptr;
+
+				if (!MovementComponent)
+					continue;
+
+				FServerMoveReplayResult & Result = Results.FindOrAdd(MovementComponent->GetClass());
+				const uint32 SweepsBefore = (uint32)FVRServerMoveRecorder::NumSweeps.GetValue();
+				const uint32 OverlapQueriesBefore = (uint32)FVRServerMoveRecorder::NumOverlapQueries.GetValue();
+				const uint64 AllocationsBefore = MallocCounter.GetAllocations();
+				const uint64 AllocatedBytesBefore = MallocCounter.GetAllocatedBytes();
+				const uint32 CyclesBefore = FPlatformTime::Cycles();
+
+				MovementComponent->PerformServerMoveVR(Recorded.Move);
+
+				Result.Cycles += FPlatformTime::Cycles() - CyclesBefore;
+				Result.Allocations += MallocCounter.GetAllocations() - AllocationsBefore;
+				Result.AllocatedBytes += MallocCounter.GetAllocatedBytes() - AllocatedBytesBefore;
+				Result.Sweeps += (uint32)FVRServerMoveRecorder::NumSweeps.GetValue() - SweepsBefore;
+				Result.OverlapQueries += (uint32)FVRServerMoveRecorder::NumOverlapQueries.GetValue() - OverlapQueriesBefore;
+				++Result.NumMoves;
+			}
+
+			DestroyReplayPawns(MovementComponents);
+		}
+
+		UE_LOG(LogNetPlayerMovement, Display, TEXT("Replayed %s with %s, %d moves from %d pawns x %d iterations"), *FileName, Label, Replay.Moves.Num(), Replay.PawnClasses.Num(), Iterations);
+
+		for (const TPair<UClass *, FServerMoveReplayResult> & Result : Results)
+		{
+			const double NumMoves = FMath::Max(Result.Value.NumMoves, 1);
+
+			UE_LOG(LogNetPlayerMovement, Display, TEXT("  %-40s %8d moves  %8.2f us/move  %6.2f sweeps/move  %6.2f overlap queries/move  %6.2f allocs/move  %8.1f bytes/move"),
+				*Result.Key->GetName(), Result.Value.NumMoves,
+				Result.Value.Cycles * FPlatformTime::GetSecondsPerCycle() * 1000000.0 / NumMoves,
+				Result.Value.Sweeps / NumMoves,
+				Result.Value.OverlapQueries / NumMoves,
+				Result.Value.Allocations / NumMoves,
+				Result.Value.AllocatedBytes / NumMoves);
+		}
+	}
+
+	void ReplayServerMoves(const TArray<FString> & Args, UWorld * World)
+	{
+		if (!World || World->GetNetMode() == NM_Client)
+		{
+			UE_LOG(LogNetPlayerMovement, Warning, TEXT("vr.ReplayServerMoves needs a world with authority"));
+			return;
+		}
+
+		const FString FileName = GetServerMoveFileName(Args, 0);
+		const int32 Iterations = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 1;
+
+		FServerMoveRecording Replay;
+		TArray<UClass *> PawnClasses;
+
+		if (!LoadServerMoveRecording(FileName, Replay, PawnClasses))
+			return;
+
+		IConsoleVariable * CVarIncrementalOverlaps = IConsoleManager::Get().FindConsoleVariable(TEXT("vr.VRRootIncrementalOverlaps"));
+
+		// Replays with the VR roots incremental overlap updates on and then off, for the overlap queries they save
+		if (Args.IsValidIndex(2) && Args[2] == TEXT("Overlaps") && CVarIncrementalOverlaps)
+		{
+			const int32 PreviousIncrementalOverlaps = CVarIncrementalOverlaps->GetInt();
+
+			CVarIncrementalOverlaps->Set(1, ECVF_SetByConsole);
+			RunServerMoveReplay(World, FileName, Replay, PawnClasses, Iterations, TEXT("incremental overlaps"));
+
+			CVarIncrementalOverlaps->Set(0, ECVF_SetByConsole);
+			RunServerMoveReplay(World, FileName, Replay, PawnClasses, Iterations, TEXT("full overlaps"));
+
+			CVarIncrementalOverlaps->Set(PreviousIncrementalOverlaps, ECVF_SetByConsole);
+		}
+		else
+		{
+			RunServerMoveReplay(World, FileName, Replay, PawnClasses, Iterations, TEXT("current settings"));
+		}
+	}
+}
+
+namespace
+{
+	struct FReplayPawnState
+	{
+		FVector Location;
+		FVector Velocity;
+		int32 NumMoves;
+
+		FReplayPawnState() :
+			Location(FVector::ZeroVector),
+			Velocity(FVector::ZeroVector),
+			NumMoves(0)
+		{}
+	};
+
+	void GetReplayPawnStates(const TArray<UVRBaseCharacterMovementComponent *> & MovementComponents, TArray<FReplayPawnState> & States)
+	{
+		for (int32 PawnIndex = 0; PawnIndex < MovementComponents.Num(); ++PawnIndex)
+		{
+			if (const UVRBaseCharacterMovementComponent * MovementComponent = MovementComponents[PawnIndex])
+			{
+				States[PawnIndex].Location = MovementComponent->UpdatedComponent->GetComponentLocation();
+				States[PawnIndex].Velocity = MovementComponent->Velocity;
+			}
+		}
+	}
+
+	// bScheduled queues each recorded frames moves on the server move scheduler and flushes them together
+	TArray<FReplayPawnState> ReplayToFinalStates(UWorld * World, const TArray<FRecordedServerMove> & Moves, const TArray<UClass *> & PawnClasses, bool bScheduled = false)
+	{
+		const TArray<UVRBaseCharacterMovementComponent *> MovementComponents = SpawnReplayPawns(World, Moves, PawnClasses);
+
+		TArray<FReplayPawnState> States;
+		States.SetNum(PawnClasses.Num());
+
+		FVRServerMoveScheduler & Scheduler = FVRServerMoveScheduler::Get();
+
+		for (int32 MoveIndex = 0; MoveIndex < Moves.Num(); ++MoveIndex)
+		{
+			const FRecordedServerMove & Recorded = Moves[MoveIndex];
+
+			if (UVRBaseCharacterMovementComponent * MovementComponent = MovementComponents.IsValidIndex(Recorded.PawnIndex) ? MovementComponents[Recorded.PawnIndex] : nullptr)
+			{
+				if (bScheduled)
+					Scheduler.QueueMove(MovementComponent, Recorded.Move, false);
+				else
+					MovementComponent->PerformServerMoveVR(Recorded.Move);
+
+				++States[Recorded.PawnIndex].NumMoves;
+			}
+
+			if (bScheduled && (!Moves.IsValidIndex(MoveIndex + 1) || Moves[MoveIndex + 1].Frame != Recorded.Frame))
+				Scheduler.Flush(World);
+		}
+
+		GetReplayPawnStates(MovementComponents, States);
+		DestroyReplayPawns(MovementComponents);
+		return States;
+	}
+
+	// Replays the moves as recorded and builds the saved move the client had for each one, its input from the move and its start
+	// and end state from the pawn around it. Each pawns saved moves are then merged the way ReplicateMoveToServer merges them,
+	// through their own CanCombineWith and CombineVRInput, and the merged moves are sent on as FillServerMoveVRInput fills them.
+	// The clients overlap test at the reverted location is left out, it only ever stops a combine.
+	TArray<FRecordedServerMove> CombineRecordedMoves(UWorld * World, const TArray<FRecordedServerMove> & Moves, const TArray<UClass *> & PawnClasses, TArray<FReplayPawnState> & OutUncombinedStates)
+	{
+		const TArray<UVRBaseCharacterMovementComponent *> MovementComponents = SpawnReplayPawns(World, Moves, PawnClasses);
+
+		OutUncombinedStates.Reset();
+		OutUncombinedStates.SetNum(PawnClasses.Num());
+
+		TArray<float> LastTimeStamps;
+		LastTimeStamps.AddZeroed(PawnClasses.Num());
+
+		TArray<FSavedMovePtr> SavedMoves;
+		SavedMoves.SetNum(Moves.Num());
+
+		for (int32 MoveIndex = 0; MoveIndex < Moves.Num(); ++MoveIndex)
+		{
+			const FRecordedServerMove & Recorded = Moves[MoveIndex];
+			UVRBaseCharacterMovementComponent * MovementComponent = MovementComponents.IsValidIndex(Recorded.PawnIndex) ? MovementComponents[Recorded.PawnIndex] : nullptr;
+			ACharacter * Character = MovementComponent ? MovementComponent->GetCharacterOwner() : nullptr;
+
+			if (!Character)
+				continue;
+
+			FNetworkPredictionData_Client_Character * ClientData = MovementComponent->GetPredictionData_Client_Character();
+			const float DeltaTime = FMath::Clamp(Recorded.Move.TimeStamp - LastTimeStamps[Recorded.PawnIndex], 0.0f, ClientData->MaxMoveDeltaTime);
+
+			FSavedMovePtr SavedMove = ClientData->CreateSavedMove();
+			SavedMove->SetMoveFor(Character, DeltaTime, Recorded.Move.GetAccel(), *ClientData);
+			SavedMove->TimeStamp = Recorded.Move.TimeStamp;
+			((FSavedMove_VRBaseCharacter *)SavedMove.Get())->SetVRInputFromServerMove(Recorded.Move);
+
+			MovementComponent->PerformServerMoveVR(Recorded.Move);
+			SavedMove->PostUpdate(Character, FSavedMove_Character::PostUpdate_Record);
+
+			SavedMoves[MoveIndex] = SavedMove;
+			LastTimeStamps[Recorded.PawnIndex] = Recorded.Move.TimeStamp;
+			++OutUncombinedStates[Recorded.PawnIndex].NumMoves;
+		}
+
+		GetReplayPawnStates(MovementComponents, OutUncombinedStates);
+
+		TArray<FRecordedServerMove> CombinedMoves;
+		CombinedMoves.Reserve(Moves.Num());
+
+		// Per pawn, the move the client would still be holding back and its entry in CombinedMoves
+		TArray<FSavedMovePtr> PendingMoves;
+		PendingMoves.SetNum(PawnClasses.Num());
+		TArray<int32> PendingMoveIndices;
+		PendingMoveIndices.Init(INDEX_NONE, PawnClasses.Num());
+
+		for (int32 MoveIndex = 0; MoveIndex < Moves.Num(); ++MoveIndex)
+		{
+			const FRecordedServerMove & Recorded = Moves[MoveIndex];
+			const FSavedMovePtr & NewMove = SavedMoves[MoveIndex];
+
+			if (!NewMove.IsValid())
+				continue;
+
+			UVRBaseCharacterMovementComponent * MovementComponent = MovementComponents[Recorded.PawnIndex];
+			ACharacter * Character = MovementComponent->GetCharacterOwner();
+			const float MaxDelta = MovementComponent->GetPredictionData_Client_Character()->MaxMoveDeltaTime * Character->GetActorTimeDilation();
+			FSavedMovePtr & PendingMove = PendingMoves[Recorded.PawnIndex];
+
+			if (PendingMove.IsValid() && NewMove->TimeStamp > PendingMove->TimeStamp && PendingMove->CanCombineWith(NewMove, Character, MaxDelta))
+			{
+				// Revert to the start of the pending move and take the new move from there, like ReplicateMoveToServer
+				MovementComponent->UpdatedComponent->SetWorldLocationAndRotation(PendingMove->GetRevertedLocation(), PendingMove->StartRotation, false);
+				MovementComponent->Velocity = PendingMove->StartVelocity;
+				MovementComponent->SetBase(PendingMove->StartBase.Get(), PendingMove->StartBoneName);
+				MovementComponent->CurrentFloor = PendingMove->StartFloor;
+
+				NewMove->DeltaTime += PendingMove->DeltaTime;
+				NewMove->SetInitialPosition(Character);
+
+				// On the client the VR input read here is still the new moves own
+				FSavedMove_VRBaseCharacter * NewVRMove = (FSavedMove_VRBaseCharacter *)NewMove.Get();
+				NewVRMove->SetVRInputFromServerMove(Recorded.Move);
+				NewVRMove->CombineVRInput((const FSavedMove_VRBaseCharacter *)PendingMove.Get(), Character);
+
+				// The rest of the combined server move is the new moves, so only its VR input is refilled
+				FRecordedServerMove CombinedMove = Recorded;
+				NewVRMove->FillServerMoveVRInput(CombinedMove.Move);
+
+				// Dropped in the compaction below
+				CombinedMoves[PendingMoveIndices[Recorded.PawnIndex]].PawnIndex = INDEX_NONE;
+				PendingMoveIndices[Recorded.PawnIndex] = CombinedMoves.Add(CombinedMove);
+			}
+			else
+			{
+				PendingMoveIndices[Recorded.PawnIndex] = CombinedMoves.Add(Recorded);
+			}
+
+			PendingMove = NewMove;
+		}
+
+		// The moves hold on to the pawns prediction data
+		SavedMoves.Empty();
+		PendingMoves.Empty();
+		DestroyReplayPawns(MovementComponents);
+
+		CombinedMoves.RemoveAll([](const FRecordedServerMove & Recorded) { return Recorded.PawnIndex == INDEX_NONE; });
+		return CombinedMoves;
+	}
+
+	void CompareServerMoveCombining(const TArray<FString> & Args, UWorld * World)
+	{
+		if (!World || World->GetNetMode() == NM_Client)
+		{
+			UE_LOG(LogNetPlayerMovement, Warning, TEXT("vr.CompareServerMoveCombining needs a world with authority"));
+			return;
+		}
+
+		const FString FileName = GetServerMoveFileName(Args, 0);
+		const float Tolerance = Args.IsValidIndex(1) ? FMath::Max(FCString::Atof(*Args[1]), 0.0f) : 1.0f;
+
+		FServerMoveRecording Replay;
+		TArray<UClass *> PawnClasses;
+
+		if (!LoadServerMoveRecording(FileName, Replay, PawnClasses))
+			return;
+
+		TArray<FReplayPawnState> UncombinedStates;
+		const TArray<FRecordedServerMove> CombinedMoves = CombineRecordedMoves(World, Replay.Moves, PawnClasses, UncombinedStates);
+		const TArray<FReplayPawnState> CombinedStates = ReplayToFinalStates(World, CombinedMoves, PawnClasses);
+
+		UE_LOG(LogNetPlayerMovement, Display, TEXT("Compared %s, %d moves combined in to %d"), *FileName, Replay.Moves.Num(), CombinedMoves.Num());
+
+		int32 NumDiverged = 0;
+
+		for (int32 PawnIndex = 0; PawnIndex < PawnClasses.Num(); ++PawnIndex)
+		{
+			if (!PawnClasses[PawnIndex])
+				continue;
+
+			const float LocationError = FVector::Dist(UncombinedStates[PawnIndex].Location, CombinedStates[PawnIndex].Location);
+			const float VelocityError = FVector::Dist(UncombinedStates[PawnIndex].Velocity, CombinedStates[PawnIndex].Velocity);
+			const bool bDiverged = LocationError > Tolerance || VelocityError > Tolerance;
+			NumDiverged += bDiverged ? 1 : 0;
+
+			UE_LOG(LogNetPlayerMovement, Display, TEXT("  %-40s pawn %3d  %6d -> %6d moves  location error %8.2f  velocity error %8.2f%s"),
+				*PawnClasses[PawnIndex]->GetName(), PawnIndex, UncombinedStates[PawnIndex].NumMoves, CombinedStates[PawnIndex].NumMoves,
+				LocationError, VelocityError, bDiverged ? TEXT("  DIVERGED") : TEXT(""));
+		}
+
+		if (NumDiverged)
+			UE_LOG(LogNetPlayerMovement, Error, TEXT("FAILED: %d pawns ended more than %.2f off the location or velocity their uncombined moves left them with"), NumDiverged, Tolerance);
+		else
+			UE_LOG(LogNetPlayerMovement, Display, TEXT("PASSED: every pawn ended within %.2f of the location and velocity its uncombined moves left it with"), Tolerance);
+	}
+}
+
+namespace
+{
+	void CompareServerMoveScheduling(const TArray<FString> & Args, UWorld * World)
+	{
+		if (!World || World->GetNetMode() == NM_Client)
+		{
+			UE_LOG(LogNetPlayerMovement, Warning, TEXT("vr.CompareServerMoveScheduling needs a world with authority"));
+			return;
+		}
+
+		const FString FileName = GetServerMoveFileName(Args, 0);
+		const float Tolerance = Args.IsValidIndex(1) ? FMath::Max(FCString::Atof(*Args[1]), 0.0f) : 0.01f;
+
+		FServerMoveRecording Replay;
+		TArray<UClass *> PawnClasses;
+
+		if (!LoadServerMoveRecording(FileName, Replay, PawnClasses))
+			return;
+
+		FVRServerMoveScheduler & Scheduler = FVRServerMoveScheduler::Get();
+		Scheduler.TotalStats = FVRServerMoveScheduler::FFlushStats();
+
+		const TArray<FReplayPawnState> SerialStates = ReplayToFinalStates(World, Replay.Moves, PawnClasses);
+		const TArray<FReplayPawnState> ScheduledStates = ReplayToFinalStates(World, Replay.Moves, PawnClasses, true);
+
+		const FVRServerMoveScheduler::FFlushStats & Stats = Scheduler.TotalStats;
+		UE_LOG(LogNetPlayerMovement, Display, TEXT("Compared %s, %d moves, %d pawn flushes with %d on workers: %d moves on workers, %d aborted, %d serial"),
+			*FileName, Replay.Moves.Num(), Stats.NumPawns, Stats.NumWorkerPawns, Stats.NumWorkerMoves, Stats.NumAbortedMoves, Stats.NumSerialMoves);
+
+		int32 NumDiverged = 0;
+
+		for (int32 PawnIndex = 0; PawnIndex < PawnClasses.Num(); ++PawnIndex)
+		{
+			if (!PawnClasses[PawnIndex])
+				continue;
+
+			const float LocationError = FVector::Dist(SerialStates[PawnIndex].Location, ScheduledStates[PawnIndex].Location);
+			const float VelocityError = FVector::Dist(SerialStates[PawnIndex].Velocity, ScheduledStates[PawnIndex].Velocity);
+			const bool bDiverged = LocationError > Tolerance || VelocityError > Tolerance;
+			NumDiverged += bDiverged ? 1 : 0;
+
+			UE_LOG(LogNetPlayerMovement, Display, TEXT("  %-40s pawn %3d  %6d moves  location error %8.4f  velocity error %8.4f%s"),
+				*PawnClasses[PawnIndex]->GetName(), PawnIndex, SerialStates[PawnIndex].NumMoves, LocationError, VelocityError, bDiverged ? TEXT("  DIVERGED") : TEXT(""));
+		}
+
+		if (NumDiverged)
+			UE_LOG(LogNetPlayerMovement, Error, TEXT("FAILED: %d pawns ended more than %.4f off the location or velocity their serial moves left them with"), NumDiverged, Tolerance);
+		else
+			UE_LOG(LogNetPlayerMovement, Display, TEXT("PASSED: every pawn ended within %.4f of the location and velocity its serial moves left it with"), Tolerance);
+	}
+}
+
+static FAutoConsoleCommandWithArgs RecordServerMovesCommand(
+	TEXT("vr.RecordServerMoves"),
+	TEXT("Start recording the server moves VR characters perform, or Stop [FileName] to write them out (Saved/VRServerMoves.vrmoves default)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RecordServerMoves));
+
+static FAutoConsoleCommandWithWorldAndArgs ReplayServerMovesCommand(
+	TEXT("vr.ReplayServerMoves"),
+	TEXT("Replays a server move recording [FileName] [Iterations] [Overlaps] on freshly spawned pawns as fast as possible and logs us, sweeps, overlap queries and game thread allocations per move. Overlaps replays it with vr.VRRootIncrementalOverlaps on and then off."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&ReplayServerMoves));
+
+static FAutoConsoleCommandWithWorldAndArgs CompareServerMoveCombiningCommand(
+	TEXT("vr.CompareServerMoveCombining"),
+	TEXT("Replays a server move recording [FileName] [Tolerance] as recorded and with each pawns moves merged through the VR saved moves CanCombineWith / CombineVRInput, and logs an error if any pawn ends up more than Tolerance apart."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&CompareServerMoveCombining));
+
+static FAutoConsoleCommandWithWorldAndArgs CompareServerMoveSchedulingCommand(
+	TEXT("vr.CompareServerMoveScheduling"),
+	TEXT("Replays a server move recording [FileName] [Tolerance] performing every move as it comes and through the server move scheduler a recorded frame at a time, and logs an error if any pawn ends up more than Tolerance apart."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&CompareServerMoveScheduling));
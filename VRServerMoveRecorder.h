@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+
+struct FVRServerMove;
+class UVRBaseCharacterMovementComponent;
+
+/**
+* Captures every server move the VR movement components perform, after they are resolved against their baselines, so that
+* a real sessions movement load can be replayed later. Moves are kept in memory while recording and written out on stop,
+* the replay side is the vr.ReplayServerMoves console command.
+*
+*	vr.RecordServerMoves Start
+*	vr.RecordServerMoves Stop [FileName]
+*	vr.ReplayServerMoves [FileName] [Iterations] [Overlaps]
+*	vr.CompareServerMoveCombining [FileName] [Tolerance]
+*	vr.CompareServerMoveScheduling [FileName] [Tolerance]
+*/
+class VREXPANSIONPLUGIN_API FVRServerMoveRecorder
+{
+public:
+
+	static FORCEINLINE bool IsRecording()
+	{
+		return bRecording;
+	}
+
+	// Called by the movement components with each move before they perform it
+	static void RecordMove(const UVRBaseCharacterMovementComponent * MovementComponent, const FVRServerMove & Move);
+
+	static void StartRecording();
+
+	// Writes the recording to FileName and clears it, returns false if it couldn't be written
+	static bool StopRecording(const FString & FileName);
+
+	// Collision sweeps made by the VR movement code, the replay reports them per move
+	static FORCEINLINE void CountSweep()
+	{
+		NumSweeps.Increment();
+	}
+
+	// Atomic as the server move scheduler sweeps from worker threads
+	static FThreadSafeCounter NumSweeps;
+
+	// Overlap tests made by the VR root overlap updates, a full update is one query and an incremental one a test per swept overlap
+	static FORCEINLINE void CountOverlapQuery()
+	{
+		NumOverlapQueries.Increment();
+	}
+
+	static FThreadSafeCounter NumOverlapQueries;
+
+private:
+
+	static bool bRecording;
+};
@@ -0,0 +1,411 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "VRServerMoveScheduler.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PhysicsVolume.h"
+#include "Components/CapsuleComponent.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Char ServerMoveSchedulerFlush"), STAT_VRServerMoveSchedulerFlush, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char ServerMoveWorkerMoves"), STAT_VRServerMoveWorkerMoves, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char ServerMoveAbortedMoves"), STAT_VRServerMoveAbortedMoves, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char ServerMoveSerialMoves"), STAT_VRServerMoveSerialMoves, STATGROUP_Character);
+
+static TAutoConsoleVariable<int32> CVarServerMoveScheduler(
+	TEXT("vr.ServerMoveScheduler"),
+	0,
+	TEXT("Batch the VR characters server moves and simulate the pawns that can't touch each other on worker threads.\n")
+	TEXT("0: Perform each move as it arrives (default)\n")
+	TEXT("1: Queue the moves and perform them at the start of the next world tick\n"),
+	ECVF_Default);
+
+namespace
+{
+	// Covers the floor sweeps and penetration adjustments around the capsule
+	const float SweptBoundsMargin = 10.0f;
+}
+
+FVRServerMoveScheduler & FVRServerMoveScheduler::Get()
+{
+	static FVRServerMoveScheduler Scheduler;
+	return Scheduler;
+}
+
+FVRServerMoveScheduler::FVRServerMoveScheduler()
+{
+	FWorldDelegates::OnWorldPreActorTick.AddRaw(this, &FVRServerMoveScheduler::OnWorldPreActorTick);
+	FWorldDelegates::OnWorldCleanup.AddRaw(this, &FVRServerMoveScheduler::OnWorldCleanup);
+}
+
+bool FVRServerMoveScheduler::IsEnabled(const UWorld * World)
+{
+	if (!CVarServerMoveScheduler.GetValueOnGameThread() || !World || World->IsPaused())
+		return false;
+
+	// The pre actor tick that flushes the queue doesn't run while paused
+	const ENetMode NetMode = World->GetNetMode();
+	return NetMode == NM_DedicatedServer || NetMode == NM_ListenServer;
+}
+
+void FVRServerMoveScheduler::QueueMove(UVRBaseCharacterMovementComponent * MovementComponent, const FVRServerMove & Move, bool bIgnoreRootMotion)
+{
+	check(IsInGameThread());
+
+	if (!MovementComponent)
+		return;
+
+	FWorldQueue & Queue = WorldQueues.FindOrAdd(MovementComponent->GetWorld());
+
+	FQueuedPawn * Pawn = nullptr;
+	if (const int32 * PawnIndex = Queue.PawnIndices.Find(MovementComponent))
+	{
+		Pawn = &Queue.Pawns[*PawnIndex];
+	}
+	else
+	{
+		const int32 NewIndex = Queue.Pawns.AddDefaulted();
+		Queue.PawnIndices.Add(MovementComponent, NewIndex);
+
+		Pawn = &Queue.Pawns[NewIndex];
+		Pawn->MovementComponent = MovementComponent;
+	}
+
+	FQueuedMove & Queued = Pawn->Moves[Pawn->Moves.AddDefaulted()];
+	Queued.Move = Move;
+	Queued.bIgnoreRootMotion = bIgnoreRootMotion;
+}
+
+void FVRServerMoveScheduler::FlushPawn(UVRBaseCharacterMovementComponent * MovementComponent)
+{
+	check(IsInGameThread());
+
+	if (!MovementComponent || !WorldQueues.Num())
+		return;
+
+	FWorldQueue * Queue = WorldQueues.Find(MovementComponent->GetWorld());
+	const int32 * PawnIndex = Queue ? Queue->PawnIndices.Find(MovementComponent) : nullptr;
+
+	if (!PawnIndex)
+		return;
+
+	// Left in the queue with no moves so the other indices stay valid, the flush skips it
+	FQueuedPawn & Pawn = Queue->Pawns[*PawnIndex];
+	const TArray<FQueuedMove, TInlineAllocator<4>> Moves = MoveTemp(Pawn.Moves);
+	Pawn.Moves.Reset();
+
+	for (const FQueuedMove & Queued : Moves)
+	{
+		ACharacter * CharacterOwner = MovementComponent->GetCharacterOwner();
+
+		if (Queued.bIgnoreRootMotion && CharacterOwner)
+			CharacterOwner->bServerMoveIgnoreRootMotion = true;
+
+		MovementComponent->PerformServerMoveVR(Queued.Move);
+
+		if (Queued.bIgnoreRootMotion && CharacterOwner)
+			CharacterOwner->bServerMoveIgnoreRootMotion = false;
+	}
+}
+
+void FVRServerMoveScheduler::OnWorldPreActorTick(UWorld * World, ELevelTick TickType, float DeltaSeconds)
+{
+	Flush(World);
+}
+
+void FVRServerMoveScheduler::OnWorldCleanup(UWorld * World, bool bSessionEnded, bool bCleanupResources)
+{
+	WorldQueues.Remove(World);
+}
+
+FBox FVRServerMoveScheduler::GetSweptBounds(const UVRBaseCharacterMovementComponent * MovementComponent, const FQueuedPawn & Pawn)
+{
+	const USceneComponent * UpdatedComponent = MovementComponent->UpdatedComponent;
+	const FNetworkPredictionData_Server_Character * ServerData = MovementComponent->GetPredictionData_Server_Character();
+
+	if (!UpdatedComponent || !ServerData)
+		return FBox(ForceInit);
+
+	const ACharacter * CharacterOwner = MovementComponent->GetCharacterOwner();
+	const float TimeDilation = CharacterOwner ? CharacterOwner->GetActorTimeDilation() : 1.0f;
+	const float MaxMoveDeltaTime = ServerData->MaxMoveDeltaTime * TimeDilation;
+
+	const UCapsuleComponent * Capsule = CharacterOwner ? CharacterOwner->GetCapsuleComponent() : nullptr;
+	const float HalfHeight = Capsule ? Capsule->GetUnscaledCapsuleHalfHeight() : 0.0f;
+	float MaxHalfHeight = HalfHeight;
+
+	float MoveTime = 0.0f;
+	float Reach = 0.0f;
+	float MaxSpeed = FMath::Max(MovementComponent->GetMaxSpeed(), MovementComponent->Velocity.Size());
+	float LastTimeStamp = ServerData->CurrentClientTimeStamp;
+	const FVector * LastCapsuleLoc = nullptr;
+	FVector CapsuleLoc;
+
+	for (const FQueuedMove & Queued : Pawn.Moves)
+	{
+		const FVRServerMove & Move = Queued.Move;
+
+		// Time stamps reset every so often, a move from before the reset is clamped like any other long one
+		const float DeltaTime = Move.TimeStamp - LastTimeStamp;
+		MoveTime += (DeltaTime >= 0.0f) ? FMath::Min(DeltaTime, MaxMoveDeltaTime) : MaxMoveDeltaTime;
+		LastTimeStamp = Move.TimeStamp;
+
+		MaxSpeed = FMath::Max(MaxSpeed, Move.GetRequestedVelocity().Size());
+
+		// The capsule is resized on the game thread before the movement
+		if (MovementComponent->VRReplicateCapsuleHeight)
+			MaxHalfHeight = FMath::Max(MaxHalfHeight, Move.GetLFDiff().Z);
+
+		// The capsule is offset by the HMD on top of the movement itself
+		Reach += Move.GetLFDiff().Size2D() + Move.GetCustomVRInputVector().Size();
+
+		const FVector NewCapsuleLoc = Move.GetCapsuleLoc();
+		if (LastCapsuleLoc)
+			Reach += FVector::Dist2D(*LastCapsuleLoc, NewCapsuleLoc);
+
+		CapsuleLoc = NewCapsuleLoc;
+		LastCapsuleLoc = &CapsuleLoc;
+	}
+
+	Reach += MaxSpeed * MoveTime + MovementComponent->MaxStepHeight + SweptBoundsMargin;
+
+	if (Capsule)
+		Reach += (MaxHalfHeight - HalfHeight) * Capsule->GetShapeScale();
+
+	return UpdatedComponent->Bounds.GetBox().ExpandBy(Reach);
+}
+
+bool FVRServerMoveScheduler::CanRunOnWorker(const UWorld * World, const UVRBaseCharacterMovementComponent * MovementComponent, const FQueuedPawn & Pawn)
+{
+	if (!Pawn.SweptBounds.IsValid || !Pawn.Moves.Num())
+		return false;
+
+	for (const FQueuedMove & Queued : Pawn.Moves)
+	{
+		if (Queued.bIgnoreRootMotion)
+			return false;
+	}
+
+	// Entering or leaving a volume changes the movement mode or runs its overlap events
+	for (auto VolumeIter = World->GetNonDefaultPhysicsVolumeIterator(); VolumeIter; ++VolumeIter)
+	{
+		const APhysicsVolume * Volume = VolumeIter->Get();
+		if (Volume && Volume->GetComponentsBoundingBox(true).Intersect(Pawn.SweptBounds))
+			return false;
+	}
+
+	TArray<FVRServerMove, TInlineAllocator<4>> Moves;
+	for (const FQueuedMove & Queued : Pawn.Moves)
+		Moves.Add(Queued.Move);
+
+	return MovementComponent->CanPerformServerMovesOnWorker(Moves.GetData(), Moves.Num());
+}
+
+void FVRServerMoveScheduler::PerformQueuedMoves(UVRBaseCharacterMovementComponent * MovementComponent, const FQueuedPawn & Pawn)
+{
+	ACharacter * CharacterOwner = MovementComponent->GetCharacterOwner();
+
+	for (const FQueuedMove & Queued : Pawn.Moves)
+	{
+		if (Queued.bIgnoreRootMotion && CharacterOwner)
+			CharacterOwner->bServerMoveIgnoreRootMotion = true;
+
+		MovementComponent->PerformServerMoveVR(Queued.Move);
+
+		if (Queued.bIgnoreRootMotion && CharacterOwner)
+			CharacterOwner->bServerMoveIgnoreRootMotion = false;
+	}
+}
+
+void FVRServerMoveScheduler::Flush(UWorld * World)
+{
+	check(IsInGameThread());
+
+	FWorldQueue * Queue = WorldQueues.Find(World);
+
+	if (!Queue || !Queue->Pawns.Num())
+		return;
+
+	SCOPE_CYCLE_COUNTER(STAT_VRServerMoveSchedulerFlush);
+
+	// Swapped with the last flushes array so neither reallocates, moves queued from inside of the flush wait for the next one
+	TArray<FQueuedPawn> & Pawns = FlushPawns;
+	Pawns.Reset();
+	Swap(Pawns, Queue->Pawns);
+	Queue->PawnIndices.Reset();
+
+	const int32 NumPawns = Pawns.Num();
+
+	for (int32 PawnIndex = 0; PawnIndex < NumPawns; ++PawnIndex)
+	{
+		FQueuedPawn & Pawn = Pawns[PawnIndex];
+		UVRBaseCharacterMovementComponent * MovementComponent = Pawn.MovementComponent.Get();
+
+		Pawn.Group = PawnIndex;
+		Pawn.SweptBounds = (MovementComponent && Pawn.Moves.Num()) ? GetSweptBounds(MovementComponent, Pawn) : FBox(ForceInit);
+	}
+
+	// Union the pawns whose swept bounds touch, a pawn is only safe to move alone if its group is just itself
+	auto FindGroup = [&Pawns](int32 PawnIndex)
+	{
+		while (Pawns[PawnIndex].Group != PawnIndex)
+		{
+			Pawns[PawnIndex].Group = Pawns[Pawns[PawnIndex].Group].Group;
+			PawnIndex = Pawns[PawnIndex].Group;
+		}
+
+		return PawnIndex;
+	};
+
+	for (int32 PawnIndex = 0; PawnIndex < NumPawns; ++PawnIndex)
+	{
+		if (!Pawns[PawnIndex].SweptBounds.IsValid)
+			continue;
+
+		for (int32 OtherIndex = PawnIndex + 1; OtherIndex < NumPawns; ++OtherIndex)
+		{
+			if (Pawns[OtherIndex].SweptBounds.IsValid && Pawns[PawnIndex].SweptBounds.Intersect(Pawns[OtherIndex].SweptBounds))
+				Pawns[FindGroup(OtherIndex)].Group = FindGroup(PawnIndex);
+		}
+	}
+
+	GroupSizes.Reset();
+	GroupSizes.AddZeroed(NumPawns);
+
+	for (int32 PawnIndex = 0; PawnIndex < NumPawns; ++PawnIndex)
+		++GroupSizes[FindGroup(PawnIndex)];
+
+	// The grouped and ineligible pawns go first and entirely on the game thread, their bounds don't reach the worker pawns
+	FFlushStats Stats;
+	WorkerPawnIndices.Reset();
+	int32 MaxWorkerMoves = 0;
+
+	for (int32 PawnIndex = 0; PawnIndex < NumPawns; ++PawnIndex)
+	{
+		FQueuedPawn & Pawn = Pawns[PawnIndex];
+		UVRBaseCharacterMovementComponent * MovementComponent = Pawn.MovementComponent.Get();
+
+		if (!MovementComponent || !Pawn.Moves.Num())
+			continue;
+
+		++Stats.NumPawns;
+
+		if (GroupSizes[FindGroup(PawnIndex)] == 1 && CanRunOnWorker(World, MovementComponent, Pawn))
+		{
+			WorkerPawnIndices.Add(PawnIndex);
+			MaxWorkerMoves = FMath::Max(MaxWorkerMoves, Pawn.Moves.Num());
+			continue;
+		}
+
+		Stats.NumSerialMoves += Pawn.Moves.Num();
+		PerformQueuedMoves(MovementComponent, Pawn);
+	}
+
+	Stats.NumWorkerPawns = WorkerPawnIndices.Num();
+	WorkerScopes.SetNumUninitialized(WorkerPawnIndices.Num(), false);
+
+	// The worker pawns go a move at a time. The game thread begins the next move of each of them, their PerformMovement runs on
+	// the workers, then the game thread commits the movement and ends the moves in queue order.
+	for (int32 MoveIndex = 0; MoveIndex < MaxWorkerMoves; ++MoveIndex)
+	{
+		WavePawnIndices.Reset();
+		WaveComponents.Reset();
+
+		for (const int32 PawnIndex : WorkerPawnIndices)
+		{
+			FQueuedPawn & Pawn = Pawns[PawnIndex];
+			UVRBaseCharacterMovementComponent * MovementComponent = Pawn.MovementComponent.Get();
+
+			if (!MovementComponent || !Pawn.Moves.IsValidIndex(MoveIndex))
+				continue;
+
+			FVRServerMoveContext & Context = Pawn.Context;
+			Context = FVRServerMoveContext();
+
+			if (!MovementComponent->BeginServerMoveVR(Pawn.Moves[MoveIndex].Move, Context))
+				continue;
+
+			if (Context.bPerformMovement)
+				MovementComponent->BeginMoveAutonomous(Context);
+
+			// An earlier move can leave the pawn in a state only the game thread can move it from
+			if (!Context.bPerformMovement || !MovementComponent->CanPerformMovementOnWorker())
+			{
+				if (Context.bPerformMovement)
+				{
+					++Stats.NumSerialMoves;
+					MovementComponent->PerformMovement(Context.DeltaTime);
+					MovementComponent->EndMoveAutonomous(Context);
+				}
+
+				MovementComponent->EndServerMoveVR(Context);
+				continue;
+			}
+
+			// Transforms, overlaps and hits are held in the deferred scope until the commit below
+			new(WorkerScopes[WaveComponents.Num()].GetTypedPtr()) FScopedMovementUpdate(MovementComponent->UpdatedComponent, EScopedUpdate::DeferredUpdates);
+
+			MovementComponent->SaveServerMoveState();
+			MovementComponent->bPerformingServerMovesOnWorker = true;
+			MovementComponent->bServerMovesOnWorkerAborted = false;
+
+			WavePawnIndices.Add(PawnIndex);
+			WaveComponents.Add(MovementComponent);
+		}
+
+		const int32 NumWaveMoves = WaveComponents.Num();
+
+		if (!NumWaveMoves)
+			continue;
+
+		ParallelFor(NumWaveMoves, [&](int32 WaveIndex)
+		{
+			WaveComponents[WaveIndex]->PerformMovement(Pawns[WavePawnIndices[WaveIndex]].Context.DeltaTime);
+		}, NumWaveMoves == 1);
+
+		for (int32 WaveIndex = 0; WaveIndex < NumWaveMoves; ++WaveIndex)
+		{
+			UVRBaseCharacterMovementComponent * MovementComponent = WaveComponents[WaveIndex];
+			const FVRServerMoveContext & Context = Pawns[WavePawnIndices[WaveIndex]].Context;
+			FScopedMovementUpdate * DeferredScope = WorkerScopes[WaveIndex].GetTypedPtr();
+
+			MovementComponent->bPerformingServerMovesOnWorker = false;
+
+			if (MovementComponent->bServerMovesOnWorkerAborted)
+			{
+				MovementComponent->bServerMovesOnWorkerAborted = false;
+
+				DeferredScope->RevertMove();
+				DeferredScope->~FScopedMovementUpdate();
+
+				MovementComponent->RestoreServerMoveState();
+
+				++Stats.NumAbortedMoves;
+				MovementComponent->PerformMovement(Context.DeltaTime);
+			}
+			else
+			{
+				// Propagates the transform and updates the overlaps
+				DeferredScope->~FScopedMovementUpdate();
+
+				++Stats.NumWorkerMoves;
+				MovementComponent->ApplyDeferredServerMoveImpacts();
+			}
+
+			MovementComponent->EndMoveAutonomous(Context);
+			MovementComponent->EndServerMoveVR(Context);
+		}
+	}
+
+	// Drops the weak pointers, the allocation is kept for the next flush
+	Pawns.Reset();
+
+	INC_DWORD_STAT_BY(STAT_VRServerMoveWorkerMoves, Stats.NumWorkerMoves);
+	INC_DWORD_STAT_BY(STAT_VRServerMoveAbortedMoves, Stats.NumAbortedMoves);
+	INC_DWORD_STAT_BY(STAT_VRServerMoveSerialMoves, Stats.NumSerialMoves);
+
+	TotalStats.NumPawns += Stats.NumPawns;
+	TotalStats.NumWorkerPawns += Stats.NumWorkerPawns;
+	TotalStats.NumWorkerMoves += Stats.NumWorkerMoves;
+	TotalStats.NumAbortedMoves += Stats.NumAbortedMoves;
+	TotalStats.NumSerialMoves += Stats.NumSerialMoves;
+}
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "VRBaseCharacterMovementComponent.h"
+
+class UWorld;
+
+/**
+* Server side scheduler for the resolved moves of the VR movement components, enabled with vr.ServerMoveScheduler.
+*
+* Instead of being performed as their RPC arrives, moves are queued per pawn and performed once per frame from the worlds
+* pre actor tick. Pawns are grouped by the bounds they can sweep through this frame. Pawns that share a group, or that have
+* anything game thread only queued, perform their moves serially. The rest, isolated pawns walking on a static base, go a
+* move at a time: the game thread begins each pawns next move (time stamps, the controllers view and rotation, the VR capsule,
+* see BeginServerMoveVR), the PerformMovement of all of them runs on worker threads, then the game thread commits the movement
+* and ends the moves (pose tick and client error handling). Workers only run scene queries; transform propagation, overlaps
+* and blocking hits are held in a deferred movement scope per pawn and impacts are queued until the commit. Movement that
+* needs to change its movement mode or base is reverted and performed again on the game thread.
+*
+* Game code that runs inside of the movement of a worker pawn, such as the controllers desired rotation or the movement
+* components own virtuals, must be thread safe.
+*
+* vr.CompareServerMoveScheduling replays a server move recording both ways and compares where the pawns end up.
+* Game thread only.
+*/
+class VREXPANSIONPLUGIN_API FVRServerMoveScheduler
+{
+public:
+
+	static FVRServerMoveScheduler & Get();
+
+	// True when the movement components should queue their moves, checked on the server as each move arrives
+	static bool IsEnabled(const UWorld * World);
+
+	// Queues a resolved move, bIgnoreRootMotion is the bServerMoveIgnoreRootMotion the move is performed with
+	void QueueMove(UVRBaseCharacterMovementComponent * MovementComponent, const FVRServerMove & Move, bool bIgnoreRootMotion);
+
+	// Performs everything queued for the world, called automatically from its pre actor tick
+	void Flush(UWorld * World);
+
+	// Performs the pawns queued moves right away, for anything that has to see them in order
+	void FlushPawn(UVRBaseCharacterMovementComponent * MovementComponent);
+
+	struct FFlushStats
+	{
+		int32 NumPawns;
+		int32 NumWorkerPawns;
+
+		// Moves whose movement ran on a worker, had to be redone on the game thread, or ran on the game thread to begin with
+		int32 NumWorkerMoves;
+		int32 NumAbortedMoves;
+		int32 NumSerialMoves;
+
+		FFlushStats() :
+			NumPawns(0),
+			NumWorkerPawns(0),
+			NumWorkerMoves(0),
+			NumAbortedMoves(0),
+			NumSerialMoves(0)
+		{}
+	};
+
+	// Totals since the last reset, for the replay comparison
+	FFlushStats TotalStats;
+
+private:
+
+	struct FQueuedMove
+	{
+		FVRServerMove Move;
+		bool bIgnoreRootMotion;
+
+		FQueuedMove() :
+			bIgnoreRootMotion(false)
+		{}
+	};
+
+	struct FQueuedPawn
+	{
+		TWeakObjectPtr<UVRBaseCharacterMovementComponent> MovementComponent;
+		TArray<FQueuedMove, TInlineAllocator<4>> Moves;
+
+		// Flush only
+		FBox SweptBounds;
+		int32 Group;
+		FVRServerMoveContext Context;
+
+		FQueuedPawn() :
+			SweptBounds(ForceInit),
+			Group(INDEX_NONE)
+		{}
+	};
+
+	struct FWorldQueue
+	{
+		TArray<FQueuedPawn> Pawns;
+		TMap<const UVRBaseCharacterMovementComponent *, int32> PawnIndices;
+	};
+
+	FVRServerMoveScheduler();
+
+	void OnWorldPreActorTick(UWorld * World, ELevelTick TickType, float DeltaSeconds);
+	void OnWorldCleanup(UWorld * World, bool bSessionEnded, bool bCleanupResources);
+
+	static FBox GetSweptBounds(const UVRBaseCharacterMovementComponent * MovementComponent, const FQueuedPawn & Pawn);
+	static bool CanRunOnWorker(const UWorld * World, const UVRBaseCharacterMovementComponent * MovementComponent, const FQueuedPawn & Pawn);
+	static void PerformQueuedMoves(UVRBaseCharacterMovementComponent * MovementComponent, const FQueuedPawn & Pawn);
+
+	TMap<UWorld *, FWorldQueue> WorldQueues;
+
+	// Flush scratch, kept between flushes so that they don't allocate
+	TArray<FQueuedPawn> FlushPawns;
+	TArray<int32> GroupSizes;
+	TArray<int32> WorkerPawnIndices;
+	TArray<int32> WavePawnIndices;
+	TArray<UVRBaseCharacterMovementComponent *> WaveComponents;
+
+	// The deferred scope each worker movement is held in until it is committed, constructed in place for each move
+	TArray<TTypeCompatibleBytes<FScopedMovementUpdate>> WorkerScopes;
+};